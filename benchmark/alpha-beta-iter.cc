@@ -0,0 +1,117 @@
+#include <pinyon.h>
+
+/*
+
+Time to solve RandomTrees to a target depth with
+    * AlphaBeta, once at the target depth
+    * AlphaBeta, at every depth up to the target on a fresh tree, which is iterative deepening without a persistent tree
+    * AlphaBetaIter, at every depth up to the target on one tree
+The model is deterministic and counts its calls, which are reported as leaf evaluations. Times and evaluations are
+summed over a few trees.
+
+*/
+
+using T = RandomTree<RandomTreeFloatTypes>;
+
+size_t inferences = 0;
+
+struct BiasModel : T
+{
+    struct ModelOutput
+    {
+        T::Value value;
+    };
+
+    class Model
+    {
+    public:
+        void inference(T::State &&state, ModelOutput &output) const
+        {
+            ++inferences;
+            output.value = T::Value{T::Real{((state.payoff_bias > 0) - (state.payoff_bias < 0) + 1) / 2.0}};
+        }
+    };
+};
+
+const size_t trees = 4;
+
+struct Result
+{
+    double ms = 0;
+    size_t inferences = 0;
+    double value = 0;
+};
+
+template <typename Solve>
+Result measure(const size_t depth_bound, const size_t actions, const size_t transitions, Solve solve)
+{
+    Result result{};
+    for (uint64_t seed = 0; seed < trees; ++seed)
+    {
+        const BiasModel::State state{prng{seed}, depth_bound, actions, actions, transitions};
+        prng device{0};
+        BiasModel::Model model{};
+        inferences = 0;
+        const auto start = std::chrono::steady_clock::now();
+        result.value += solve(device, state, model);
+        result.ms += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        result.inferences += inferences;
+    }
+    return result;
+}
+
+void print(const char *name, const Result &result)
+{
+    std::cout << "    " << name << " : " << result.ms << " ms, " << result.inferences << " leaf evaluations, value sum "
+              << result.value << std::endl;
+}
+
+void benchmark(const size_t depth, const size_t actions, const size_t transitions)
+{
+    const size_t depth_bound = depth + 4;
+    std::cout << "RandomTree(" << depth_bound << ", " << actions << ", " << actions << ", " << transitions
+              << ") to depth " << depth << std::endl;
+
+    print("AlphaBeta            ", measure(
+                                        depth_bound, actions, transitions,
+                                        [depth](prng &device, const BiasModel::State &state, BiasModel::Model &model)
+                                        {
+                                            AlphaBeta<BiasModel>::MatrixNode root{};
+                                            AlphaBeta<BiasModel>::Search search{0, 1};
+                                            return search.run(depth, device, state, model, root).first;
+                                        }));
+    print("AlphaBeta, each depth", measure(
+                                        depth_bound, actions, transitions,
+                                        [depth](prng &device, const BiasModel::State &state, BiasModel::Model &model)
+                                        {
+                                            double value = 0;
+                                            for (size_t d = 1; d <= depth; ++d)
+                                            {
+                                                AlphaBeta<BiasModel>::MatrixNode root{};
+                                                AlphaBeta<BiasModel>::Search search{0, 1};
+                                                value = search.run(d, device, state, model, root).first;
+                                            }
+                                            return value;
+                                        }));
+    print("AlphaBetaIter        ", measure(
+                                        depth_bound, actions, transitions,
+                                        [depth](prng &device, const BiasModel::State &state, BiasModel::Model &model)
+                                        {
+                                            AlphaBetaIter<BiasModel>::MatrixNode root{};
+                                            AlphaBetaIter<BiasModel>::Search search{0, 1};
+                                            return search.run_for_depth(depth, device, state, model, root).first;
+                                        }));
+}
+
+int main()
+{
+    for (const size_t depth : {2, 3, 4, 5})
+    {
+        benchmark(depth, 3, 2);
+    }
+    for (const size_t depth : {2, 3})
+    {
+        benchmark(depth, 4, 3);
+    }
+    return 0;
+}
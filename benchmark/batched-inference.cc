@@ -0,0 +1,81 @@
+#include <pinyon.h>
+
+/*
+
+Iterations per second of TreeBandit vs TreeBanditBatched, using MonteCarloModel and a synthetic model whose
+every call to inference has a fixed latency (like a round trip to a GPU) on top of the Monte Carlo rollouts.
+
+*/
+
+const size_t max_actions = 3;
+const size_t max_depth = 10;
+const size_t duration_ms = 2000;
+const size_t latency_us = 100;
+
+template <IsPerfectInfoStateTypes Types>
+struct SlowModel : MonteCarloModel<Types>
+{
+    class Model : public MonteCarloModel<Types>::Model
+    {
+    public:
+        using MonteCarloModel<Types>::Model::Model;
+
+        void inference(
+            Types::State &&state,
+            MonteCarloModel<Types>::ModelOutput &output)
+        {
+            wait();
+            MonteCarloModel<Types>::Model::inference(std::move(state), output);
+        }
+
+        void inference(
+            MonteCarloModel<Types>::ModelBatchInput &batch_input,
+            MonteCarloModel<Types>::ModelBatchOutput &batch_output)
+        {
+            wait();
+            batch_output.resize(batch_input.size());
+            for (int i = 0; i < batch_input.size(); ++i)
+            {
+                MonteCarloModel<Types>::Model::inference(std::move(batch_input[i]), batch_output[i]);
+            }
+        }
+
+    private:
+        void wait() const
+        {
+            const auto start = std::chrono::high_resolution_clock::now();
+            while (std::chrono::high_resolution_clock::now() - start < std::chrono::microseconds(latency_us))
+            {
+            }
+        }
+    };
+};
+
+template <typename Types, typename... Args>
+void benchmark_(Args... args)
+{
+    typename Types::PRNG device{0};
+    typename Types::State state{max_actions, max_depth};
+    typename Types::Model model{0};
+    typename Types::MatrixNode root{};
+    typename Types::Search search{typename Types::BanditAlgorithm{.1}, args...};
+    const size_t iterations = search.run(duration_ms, device, state, model, root);
+    std::cout << search << " : " << iterations * 1000 / duration_ms << " iterations/s" << std::endl;
+}
+
+template <typename Types>
+void benchmark()
+{
+    benchmark_<TreeBandit<Exp3<Types>>>();
+    for (const size_t batch_size : {1, 8, 32, 128})
+    {
+        benchmark_<TreeBanditBatched<Exp3<Types>>>(batch_size, size_t{1000});
+    }
+}
+
+int main()
+{
+    benchmark<MonteCarloModel<MoldState<>>>();
+    benchmark<SlowModel<MoldState<>>>();
+    return 0;
+}
@@ -0,0 +1,90 @@
+#include <pinyon.h>
+
+#include <thread>
+
+/*
+
+Cost of the time limit check in a timed search loop.
+
+First an empty loop, which shows the overhead per iteration of reading the clock every time vs `Deadline`.
+Then timed searches with a short duration, which show iterations per second and how far `run` overshoots.
+Finally a search with a long duration that is cancelled from another thread through the stop flag.
+
+*/
+
+const size_t duration_ms = 100;
+
+void empty_loop_clock()
+{
+    const auto start = std::chrono::steady_clock::now();
+    size_t calls = 0;
+    for (; std::chrono::steady_clock::now() - start < std::chrono::milliseconds{duration_ms}; ++calls)
+    {
+    }
+    std::cout << "clock every call : " << 1000.0 * 1000 * duration_ms / calls << " ns per call" << std::endl;
+}
+
+template <typename Clock>
+void empty_loop_deadline(const char *name)
+{
+    Deadline<Clock> deadline{duration_ms};
+    size_t calls = 0;
+    for (; !deadline.expired(); ++calls)
+    {
+    }
+    std::cout << "Deadline<" << name << "> : " << 1000.0 * 1000 * duration_ms / calls << " ns per call" << std::endl;
+}
+
+template <typename Types>
+void timed_search()
+{
+    typename Types::PRNG device{0};
+    typename Types::State state{3, 10};
+    typename Types::Model model{0};
+    typename Types::Search search{typename Types::BanditAlgorithm{.1}};
+    typename Types::MatrixNode root{};
+    const auto start = std::chrono::steady_clock::now();
+    const size_t iterations = search.run(duration_ms, device, state, model, root);
+    const auto end = std::chrono::steady_clock::now();
+    const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+    std::cout << search << " : " << iterations * 1000 / duration_ms << " iterations/s, overshoot "
+              << elapsed - static_cast<long>(1000 * duration_ms) << " us" << std::endl;
+}
+
+template <typename Types>
+void cancelled_search()
+{
+    typename Types::PRNG device{0};
+    typename Types::State state{3, 10};
+    typename Types::Model model{0};
+    typename Types::Search search{typename Types::BanditAlgorithm{.1}};
+    typename Types::MatrixNode root{};
+    std::atomic<bool> stop{false};
+    search.stop_flag = &stop;
+    std::thread controller{[&stop]
+                           {
+                               std::this_thread::sleep_for(std::chrono::milliseconds{duration_ms});
+                               stop.store(true);
+                           }};
+    const auto start = std::chrono::steady_clock::now();
+    search.run(1000 * duration_ms, device, state, model, root);
+    const auto end = std::chrono::steady_clock::now();
+    controller.join();
+    std::cout << "cancelled after " << duration_ms << " ms, returned after "
+              << std::chrono::duration_cast<std::chrono::microseconds>(end - start).count() << " us" << std::endl;
+}
+
+int main()
+{
+    empty_loop_clock();
+    empty_loop_deadline<std::chrono::steady_clock>("steady_clock");
+#if defined(__x86_64__) || defined(__i386__)
+    empty_loop_deadline<TSCClock>("TSCClock");
+#endif
+
+    using Types = MonteCarloModel<MoldState<>>;
+    timed_search<TreeBandit<Exp3<Types>>>();
+    timed_search<TreeBanditThreaded<Exp3<Types>>>();
+    cancelled_search<TreeBandit<Exp3<Types>>>();
+    return 0;
+}
@@ -0,0 +1,44 @@
+#include <pinyon.h>
+
+/*
+
+Iterations per second of TreeBandit against the depth of the descent.
+
+MoldState with one action per player is a chain, so after the first `depth` iterations every iteration descends
+exactly `depth` levels before it reaches the terminal node. The wider trees (2 and 3 actions) are for reference,
+their descents are much shallower than `depth`.
+
+*/
+
+const size_t duration_ms = 1000;
+
+template <typename Types>
+void benchmark_depth(const size_t actions, const size_t depth)
+{
+    typename Types::PRNG device{0};
+    typename Types::State state{actions, depth};
+    typename Types::Model model{0};
+    typename Types::MatrixNode root{};
+    typename Types::Search search{};
+    search.run_for_iterations(depth, device, state, model, root);
+    const size_t iterations = search.run(duration_ms, device, state, model, root);
+    std::cout << "actions: " << actions << ", depth: " << depth << " : " << iterations * 1000 / duration_ms
+              << " iterations/s" << std::endl;
+}
+
+int main()
+{
+    using Types = TreeBandit<Exp3<MonteCarloModel<MoldState<>>>>;
+    for (const size_t depth : {1, 4, 16, 64, 256, 1024})
+    {
+        benchmark_depth<Types>(1, depth);
+    }
+    for (const size_t actions : {2, 3})
+    {
+        for (const size_t depth : {10, 20, 40})
+        {
+            benchmark_depth<Types>(actions, depth);
+        }
+    }
+    return 0;
+}
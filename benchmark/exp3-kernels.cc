@@ -0,0 +1,100 @@
+#include <pinyon.h>
+
+/*
+
+The Exp3 forecast (softmax and gamma mixing) computed by the scalar loops Exp3 used before, and by the vectorized
+kernel in simd.h, for 2 to 16 actions. Then Exp3 select + update on a single node, which now uses the kernel.
+
+*/
+
+const size_t duration_ms = 1000;
+
+void scalar_forecast(const std::vector<double> &gains, std::vector<double> &forecast, const size_t k, const double eta,
+                     const double one_minus_gamma)
+{
+    double sum = 0;
+    for (size_t i = 0; i < k; ++i)
+    {
+        const double y{std::exp(static_cast<float>(gains[i] * eta))};
+        forecast[i] = y;
+        sum += y;
+    }
+    for (size_t i = 0; i < k; ++i)
+    {
+        forecast[i] /= sum;
+    }
+    std::transform(forecast.begin(), forecast.begin() + k, forecast.begin(),
+                   [eta, one_minus_gamma](double value) { return one_minus_gamma * value + eta; });
+}
+
+template <bool use_kernel>
+void benchmark_forecast(const size_t k)
+{
+    prng device{0};
+    std::vector<double> gains(k), forecast(k);
+    for (double &gain : gains)
+    {
+        gain = -device.uniform() * 100;
+    }
+    const double eta = .01 / k;
+    size_t iterations = 0;
+    double checksum = 0;
+    Deadline deadline{duration_ms};
+    while (!deadline.expired())
+    {
+        for (size_t i = 0; i < 1024; ++i, ++iterations)
+        {
+            gains[iterations % k] -= 1e-3;
+            if constexpr (use_kernel)
+            {
+                math::exp3_forecast(gains.data(), forecast.data(), k, eta, .99);
+            }
+            else
+            {
+                scalar_forecast(gains, forecast, k, eta, .99);
+            }
+            checksum += forecast[0];
+        }
+    }
+    std::cout << k << " actions " << (use_kernel ? "kernel" : "scalar") << " : " << iterations * 1000 / duration_ms
+              << " forecasts/s (" << checksum << ")" << std::endl;
+}
+
+template <typename Types>
+void benchmark_bandit(const size_t actions)
+{
+    typename Types::PRNG device{0};
+    typename Types::BanditAlgorithm bandit{};
+    typename Types::MatrixStats stats{};
+    bandit.expand(stats, actions, actions, {});
+    std::vector<double> payoffs(actions * actions);
+    for (double &payoff : payoffs)
+    {
+        payoff = device.uniform();
+    }
+    typename Types::Outcome outcome;
+    size_t iterations = 0;
+    Deadline deadline{duration_ms};
+    for (; !deadline.expired(); ++iterations)
+    {
+        bandit.select(device, stats, outcome);
+        outcome.value = typename Types::Value{payoffs[outcome.row_idx * actions + outcome.col_idx]};
+        bandit.update_matrix_stats(stats, outcome);
+    }
+    std::cout << actions << "x" << actions << " " << bandit << " select + update : " << iterations * 1000 / duration_ms
+              << " /s" << std::endl;
+}
+
+int main()
+{
+    for (const size_t k : {2, 3, 4, 6, 8, 9, 12, 16})
+    {
+        benchmark_forecast<false>(k);
+        benchmark_forecast<true>(k);
+    }
+    for (const size_t actions : {2, 3, 5, 9, 16})
+    {
+        benchmark_bandit<Exp3<MonteCarloModel<RandomTree<>>>>(actions);
+    }
+    return 0;
+}
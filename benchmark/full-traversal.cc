@@ -0,0 +1,44 @@
+#include <pinyon.h>
+
+/*
+
+Speedup of FullTraversal with a task pool over the serial traversal, from 1 thread up to the hardware concurrency,
+on RandomTrees of depth 4 to 6. The matrix nodes above `max_task_depth` are split into tasks.
+
+*/
+
+using Types = MonteCarloModel<RandomTree<RandomTreeFastTypes>>;
+
+const size_t max_task_depth = 3;
+
+void benchmark(const size_t depth, const size_t actions, const size_t transitions)
+{
+    const Types::State state{Types::PRNG{0}, depth, actions, actions, transitions};
+    const size_t max_threads = std::max(std::thread::hardware_concurrency(), 1u);
+    double serial_ms = 0;
+    for (size_t threads = 1; threads <= max_threads; threads *= 2)
+    {
+        Types::PRNG device{0};
+        Types::Model model{0};
+        FullTraversal<Types>::MatrixNode root{};
+        FullTraversal<Types>::Search search{max_task_depth};
+        const auto start = std::chrono::steady_clock::now();
+        const auto value = search.run(depth, device, state, model, root, threads);
+        const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        if (threads == 1)
+        {
+            serial_ms = ms;
+        }
+        std::cout << "RandomTree(" << depth << ", " << actions << ", " << actions << ", " << transitions << ") "
+                  << threads << " threads : " << root.stats.matrix_node_count << " nodes, value " << value.first
+                  << ", " << ms << " ms, speedup " << serial_ms / ms << std::endl;
+    }
+}
+
+int main()
+{
+    benchmark(4, 3, 2);
+    benchmark(5, 2, 3);
+    benchmark(6, 2, 2);
+    return 0;
+}
@@ -0,0 +1,501 @@
+#pragma once
+
+#include <pinyon.h>
+
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <limits>
+#include <new>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+#ifdef __linux__
+#include <sys/resource.h>
+#endif
+
+/*
+
+Benchmark harness for tree bandit searches, with results written as JSON or CSV.
+
+`run_searches(search_type_tuple, ...)` takes a tuple from `search_type_generator` and runs every search type on a
+state. Each run is repeated after some warmup runs, and each repetition uses a different seed. For every search type
+(and thread count, for the multithreaded searches) one record is written with
+* iterations/s and matrix nodes/s, as the mean with a 95% confidence interval over the repetitions
+* the heap bytes per matrix node, and the peak heap use during a run
+* the peak RSS of the process so far, which only grows as the benchmark goes on
+* the speedup over the same search with one thread
+* the exploitability of the root strategies at a few times, if the solved root matrix is given
+
+The heap is measured by replacing the global `operator new` and `operator delete`, so this header must be included
+in exactly one translation unit. The accounting is on during the timed runs, so every allocation also costs two
+relaxed atomic adds.
+
+*/
+
+namespace heap
+{
+    inline std::atomic<size_t> live{0};
+    inline std::atomic<size_t> peak{0};
+
+    // the size and the offset to the start of the allocation are stored just before the returned pointer
+    inline void *allocate(const size_t size, const size_t alignment)
+    {
+        const size_t offset = std::max(alignment, 2 * sizeof(size_t));
+        const size_t total = (offset + size + alignment - 1) / alignment * alignment;
+        std::byte *data = static_cast<std::byte *>(
+            alignment <= alignof(std::max_align_t) ? std::malloc(total) : std::aligned_alloc(alignment, total));
+        if (data == nullptr)
+        {
+            throw std::bad_alloc{};
+        }
+        size_t *header = reinterpret_cast<size_t *>(data + offset);
+        header[-1] = size;
+        header[-2] = offset;
+        const size_t current = live.fetch_add(size, std::memory_order_relaxed) + size;
+        size_t previous = peak.load(std::memory_order_relaxed);
+        while (current > previous && !peak.compare_exchange_weak(previous, current, std::memory_order_relaxed))
+        {
+        }
+        return data + offset;
+    }
+
+    inline void deallocate(void *ptr)
+    {
+        if (ptr == nullptr)
+        {
+            return;
+        }
+        const size_t *header = static_cast<const size_t *>(ptr);
+        live.fetch_sub(header[-1], std::memory_order_relaxed);
+        std::free(static_cast<std::byte *>(ptr) - header[-2]);
+    }
+
+    inline void reset_peak()
+    {
+        peak.store(live.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+};
+
+void *operator new(size_t size)
+{
+    return heap::allocate(size, alignof(std::max_align_t));
+}
+
+void *operator new(size_t size, std::align_val_t alignment)
+{
+    return heap::allocate(size, static_cast<size_t>(alignment));
+}
+
+void operator delete(void *ptr) noexcept
+{
+    heap::deallocate(ptr);
+}
+
+void operator delete(void *ptr, size_t) noexcept
+{
+    heap::deallocate(ptr);
+}
+
+void operator delete(void *ptr, std::align_val_t) noexcept
+{
+    heap::deallocate(ptr);
+}
+
+void operator delete(void *ptr, size_t, std::align_val_t) noexcept
+{
+    heap::deallocate(ptr);
+}
+
+size_t peak_rss_bytes()
+{
+#ifdef __linux__
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    return static_cast<size_t>(usage.ru_maxrss) * 1024;
+#else
+    return 0;
+#endif
+}
+
+/*
+
+Options, parsed from `--name=value` arguments:
+`--duration=ms`, `--warmup=n`, `--repetitions=n`, `--threads=1,2,4`, `--format=json|csv`, `--out=path`,
+`--label=text` (e.g. the library version, copied into every record) and `--filter=text` (only runs whose state or
+search name contains the text).
+
+*/
+
+struct BenchmarkOptions
+{
+    size_t duration_ms = 500;
+    size_t warmup = 1;
+    size_t repetitions = 5;
+    std::vector<size_t> threads{1, 2, 4};
+    std::string format = "json";
+    std::string out{};
+    std::string label{};
+    std::string filter{};
+
+    BenchmarkOptions() {}
+
+    BenchmarkOptions(const int argc, char **argv)
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            const std::string arg{argv[i]};
+            const size_t eq = arg.find('=');
+            if (arg.rfind("--", 0) != 0 || eq == std::string::npos)
+            {
+                throw std::invalid_argument{"expected --name=value, got " + arg};
+            }
+            const std::string name = arg.substr(2, eq - 2);
+            const std::string value = arg.substr(eq + 1);
+            if (name == "duration")
+            {
+                duration_ms = std::stoul(value);
+            }
+            else if (name == "warmup")
+            {
+                warmup = std::stoul(value);
+            }
+            else if (name == "repetitions")
+            {
+                repetitions = std::max(std::stoul(value), 1ul);
+            }
+            else if (name == "threads")
+            {
+                threads.clear();
+                std::stringstream stream{value};
+                for (std::string count; std::getline(stream, count, ',');)
+                {
+                    threads.push_back(std::stoul(count));
+                }
+            }
+            else if (name == "format")
+            {
+                if (value != "json" && value != "csv")
+                {
+                    throw std::invalid_argument{"unknown format " + value};
+                }
+                format = value;
+            }
+            else if (name == "out")
+            {
+                out = value;
+            }
+            else if (name == "label")
+            {
+                label = value;
+            }
+            else if (name == "filter")
+            {
+                filter = value;
+            }
+            else
+            {
+                throw std::invalid_argument{"unknown option " + name};
+            }
+        }
+    }
+
+    // the times at which the exploitability is measured, in a separate run
+    std::vector<size_t> checkpoints_ms() const
+    {
+        return {duration_ms / 8, duration_ms / 4, duration_ms / 2, duration_ms};
+    }
+};
+
+struct Sample
+{
+    std::vector<double> values{};
+
+    double mean() const
+    {
+        double sum = 0;
+        for (const double value : values)
+        {
+            sum += value;
+        }
+        return values.empty() ? 0 : sum / values.size();
+    }
+
+    // half width of the 95% confidence interval of the mean, using Student's t distribution
+    double ci95() const
+    {
+        const size_t n = values.size();
+        if (n < 2)
+        {
+            return 0;
+        }
+        static constexpr double t[30] = {
+            12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+            2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+            2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042};
+        const double m = mean();
+        double squares = 0;
+        for (const double value : values)
+        {
+            squares += (value - m) * (value - m);
+        }
+        const double standard_error = std::sqrt(squares / (n - 1) / n);
+        return (n - 1 <= 30 ? t[n - 2] : 1.960) * standard_error;
+    }
+};
+
+struct BenchmarkRecord
+{
+    std::string state;
+    std::string search;
+    size_t threads = 1;
+    Sample iterations_per_second{};
+    Sample nodes_per_second{};
+    double bytes_per_node = 0;
+    size_t peak_heap_bytes = 0;
+    size_t peak_rss_bytes = 0;
+    // NaN if there is no run with one thread
+    double speedup = std::numeric_limits<double>::quiet_NaN();
+    // (ms, exploitability)
+    std::vector<std::pair<size_t, double>> exploitability{};
+};
+
+class BenchmarkWriter
+{
+public:
+    const BenchmarkOptions &options;
+    std::vector<BenchmarkRecord> records{};
+
+    BenchmarkWriter(const BenchmarkOptions &options) : options{options} {}
+
+    void add(const BenchmarkRecord &record)
+    {
+        records.push_back(record);
+        std::cerr << record.state << " : " << record.search << " : " << record.iterations_per_second.mean()
+                  << " iterations/s" << std::endl;
+    }
+
+    void write() const
+    {
+        if (options.out.empty())
+        {
+            write(std::cout);
+        }
+        else
+        {
+            std::ofstream file{options.out};
+            write(file);
+        }
+    }
+
+    void write(std::ostream &os) const
+    {
+        if (options.format == "csv")
+        {
+            write_csv(os);
+        }
+        else
+        {
+            write_json(os);
+        }
+    }
+
+private:
+    static std::string quote(const std::string &text)
+    {
+        std::string quoted{"\""};
+        for (const char c : text)
+        {
+            if (c == '"' || c == '\\')
+            {
+                quoted += '\\';
+            }
+            quoted += c;
+        }
+        return quoted + '"';
+    }
+
+    static std::string number(const double value)
+    {
+        if (!std::isfinite(value))
+        {
+            return "null";
+        }
+        std::ostringstream os{};
+        os << value;
+        return os.str();
+    }
+
+    void write_json(std::ostream &os) const
+    {
+        os << "{\"label\": " << quote(options.label) << ", \"duration_ms\": " << options.duration_ms
+           << ", \"warmup\": " << options.warmup << ", \"repetitions\": " << options.repetitions
+           << ", \"records\": [";
+        for (size_t i = 0; i < records.size(); ++i)
+        {
+            const BenchmarkRecord &record = records[i];
+            os << (i == 0 ? "" : ",") << "\n  {\"state\": " << quote(record.state)
+               << ", \"search\": " << quote(record.search) << ", \"threads\": " << record.threads
+               << ", \"iterations_per_second\": " << number(record.iterations_per_second.mean())
+               << ", \"iterations_per_second_ci95\": " << number(record.iterations_per_second.ci95())
+               << ", \"nodes_per_second\": " << number(record.nodes_per_second.mean())
+               << ", \"nodes_per_second_ci95\": " << number(record.nodes_per_second.ci95())
+               << ", \"bytes_per_node\": " << number(record.bytes_per_node)
+               << ", \"peak_heap_bytes\": " << record.peak_heap_bytes
+               << ", \"peak_rss_bytes\": " << record.peak_rss_bytes
+               << ", \"speedup\": " << number(record.speedup) << ", \"exploitability\": [";
+            for (size_t j = 0; j < record.exploitability.size(); ++j)
+            {
+                os << (j == 0 ? "" : ", ") << "{\"ms\": " << record.exploitability[j].first
+                   << ", \"value\": " << number(record.exploitability[j].second) << "}";
+            }
+            os << "]}";
+        }
+        os << "\n]}" << std::endl;
+    }
+
+    // the exploitability column is a list of ms:value pairs separated by ';'
+    void write_csv(std::ostream &os) const
+    {
+        os << "label,state,search,threads,iterations_per_second,iterations_per_second_ci95,nodes_per_second,"
+              "nodes_per_second_ci95,bytes_per_node,peak_heap_bytes,peak_rss_bytes,speedup,exploitability\n";
+        for (const BenchmarkRecord &record : records)
+        {
+            os << quote(options.label) << ',' << quote(record.state) << ',' << quote(record.search) << ','
+               << record.threads << ',' << number(record.iterations_per_second.mean()) << ','
+               << number(record.iterations_per_second.ci95()) << ',' << number(record.nodes_per_second.mean())
+               << ',' << number(record.nodes_per_second.ci95()) << ',' << number(record.bytes_per_node) << ','
+               << record.peak_heap_bytes << ',' << record.peak_rss_bytes << ',' << number(record.speedup) << ",\"";
+            for (size_t j = 0; j < record.exploitability.size(); ++j)
+            {
+                os << (j == 0 ? "" : ";") << record.exploitability[j].first << ':'
+                   << number(record.exploitability[j].second);
+            }
+            os << "\"\n";
+        }
+        os.flush();
+    }
+};
+
+template <typename Types>
+constexpr bool is_thread_pool_search = requires(typename Types::Search &search) { search.pool_size; };
+
+template <typename Types>
+constexpr bool is_threaded_search = requires(typename Types::Search &search) { search.threads; };
+
+template <typename Types>
+typename Types::Search make_search(const size_t threads)
+{
+    if constexpr (is_thread_pool_search<Types>)
+    {
+        return typename Types::Search{typename Types::BanditAlgorithm{}, threads, size_t{64}};
+    }
+    else if constexpr (is_threaded_search<Types>)
+    {
+        return typename Types::Search{typename Types::BanditAlgorithm{}, threads};
+    }
+    else
+    {
+        return typename Types::Search{};
+    }
+}
+
+template <typename Types>
+std::string search_name(const size_t threads)
+{
+    std::ostringstream os{};
+    os << make_search<Types>(threads);
+    return os.str();
+}
+
+template <typename Types>
+void run_search(
+    const std::string &state_name,
+    const typename Types::State &state,
+    const typename Types::MatrixValue *payoff_matrix,
+    const BenchmarkOptions &options,
+    BenchmarkWriter &writer)
+{
+    const std::vector<size_t> thread_counts =
+        is_threaded_search<Types> ? options.threads : std::vector<size_t>{1};
+    double single_thread_iterations_per_second = std::numeric_limits<double>::quiet_NaN();
+
+    for (const size_t threads : thread_counts)
+    {
+        BenchmarkRecord record{state_name, search_name<Types>(threads), threads};
+        const std::string name = record.state + " " + record.search;
+        if (!options.filter.empty() && name.find(options.filter) == std::string::npos)
+        {
+            continue;
+        }
+
+        for (size_t repetition = 0; repetition < options.warmup + options.repetitions; ++repetition)
+        {
+            typename Types::PRNG device{repetition};
+            typename Types::Model model{repetition};
+            typename Types::Search search = make_search<Types>(threads);
+            const size_t live_before = heap::live.load();
+            heap::reset_peak();
+            typename Types::MatrixNode root{};
+
+            const auto start = std::chrono::steady_clock::now();
+            const size_t iterations = search.run(options.duration_ms, device, state, model, root);
+            const auto end = std::chrono::steady_clock::now();
+
+            if (repetition < options.warmup)
+            {
+                continue;
+            }
+            const double seconds = std::chrono::duration<double>(end - start).count();
+            const size_t nodes = root.count_matrix_nodes();
+            record.iterations_per_second.values.push_back(iterations / seconds);
+            record.nodes_per_second.values.push_back(nodes / seconds);
+            // the bytes of the last repetition, which are the same for every repetition of a fixed iteration count
+            record.bytes_per_node = static_cast<double>(heap::live.load() - live_before) / nodes;
+            record.peak_heap_bytes = std::max(record.peak_heap_bytes, heap::peak.load() - live_before);
+        }
+        record.peak_rss_bytes = peak_rss_bytes();
+
+        if (threads == 1)
+        {
+            single_thread_iterations_per_second = record.iterations_per_second.mean();
+        }
+        record.speedup = record.iterations_per_second.mean() / single_thread_iterations_per_second;
+
+        if (payoff_matrix != nullptr)
+        {
+            typename Types::PRNG device{0};
+            typename Types::Model model{0};
+            typename Types::Search search = make_search<Types>(threads);
+            typename Types::MatrixNode root{};
+            size_t elapsed_ms = 0;
+            for (const size_t checkpoint_ms : options.checkpoints_ms())
+            {
+                search.run(checkpoint_ms - elapsed_ms, device, state, model, root);
+                elapsed_ms = checkpoint_ms;
+                typename Types::VectorReal row_strategy, col_strategy;
+                search.get_empirical_strategies(root.stats, row_strategy, col_strategy);
+                const auto exploitability = math::exploitability(*payoff_matrix, row_strategy, col_strategy);
+                record.exploitability.emplace_back(checkpoint_ms, static_cast<double>(exploitability));
+            }
+        }
+
+        writer.add(record);
+    }
+}
+
+template <typename... SearchTypes>
+void run_searches(
+    std::tuple<SearchTypes...> search_type_tuple,
+    const std::string &state_name,
+    const typename std::tuple_element_t<0, std::tuple<SearchTypes...>>::State &state,
+    const typename std::tuple_element_t<0, std::tuple<SearchTypes...>>::MatrixValue *payoff_matrix,
+    const BenchmarkOptions &options,
+    BenchmarkWriter &writer)
+{
+    (run_search<SearchTypes>(state_name, state, payoff_matrix, options, writer), ...);
+}
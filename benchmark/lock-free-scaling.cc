@@ -0,0 +1,38 @@
+#include <pinyon.h>
+
+/*
+
+Iterations per second of the multithreaded searches from 1 thread up to the hardware concurrency,
+using Exp3 (stats guarded by a mutex) and Exp3Atomic (lock-free stats)
+
+*/
+
+const size_t max_actions = 3;
+const size_t max_depth = 10;
+const size_t duration_ms = 2000;
+
+template <typename Types, typename... Args>
+void benchmark_(const size_t threads, Args... args)
+{
+    typename Types::PRNG device{0};
+    typename Types::State state{max_actions, max_depth};
+    typename Types::Model model{0};
+    typename Types::MatrixNode root{};
+    typename Types::Search search{typename Types::BanditAlgorithm{.1}, threads, args...};
+    const size_t iterations = search.run(duration_ms, device, state, model, root);
+    std::cout << search << " : " << iterations * 1000 / duration_ms << " iterations/s" << std::endl;
+}
+
+int main()
+{
+    using Types = MonteCarloModel<MoldState<>>;
+    const size_t max_threads = std::max(std::thread::hardware_concurrency(), 1u);
+    for (size_t threads = 1; threads <= max_threads; threads *= 2)
+    {
+        benchmark_<TreeBanditThreaded<Exp3<Types>>>(threads);
+        benchmark_<TreeBanditThreaded<Exp3Atomic<Types>>>(threads);
+        benchmark_<TreeBanditThreadPool<Exp3<Types>>>(threads, size_t{64});
+        benchmark_<TreeBanditThreadPool<Exp3Atomic<Types>>>(threads, size_t{64});
+    }
+    return 0;
+}
@@ -0,0 +1,109 @@
+#include <pinyon.h>
+
+/*
+
+Heap allocations (operator new and GMP) and latency of one `LRSNash::solve` call on NxN games, N = 2 to 10.
+The payoffs are rational for the mpq overloads and doubles discretized to multiples of 1/100 for the lrs float path.
+
+*/
+
+const size_t solves = 1 << 12;
+
+size_t allocations = 0;
+
+void *operator new(size_t size)
+{
+    ++allocations;
+    if (void *ptr = std::malloc(size))
+    {
+        return ptr;
+    }
+    throw std::bad_alloc{};
+}
+
+void operator delete(void *ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, size_t) noexcept
+{
+    std::free(ptr);
+}
+
+void *gmp_allocate(size_t size)
+{
+    ++allocations;
+    return std::malloc(size);
+}
+
+void *gmp_reallocate(void *ptr, size_t, size_t size)
+{
+    ++allocations;
+    return std::realloc(ptr, size);
+}
+
+void gmp_free(void *ptr, size_t)
+{
+    std::free(ptr);
+}
+
+using ConstantSumTypes = RandomTreeRationalTypes;
+using BimatrixTypes = DefaultTypes<mpq_class, int, int, mpq_class, PairReal>;
+using FloatTypes = RandomTreeFloatTypes;
+
+template <typename Types, typename... Args>
+void benchmark(const std::string &name, const size_t size, Args... args)
+{
+    prng device{0};
+    std::vector<typename Types::MatrixValue> matrices{};
+    for (size_t i = 0; i < 16; ++i)
+    {
+        typename Types::MatrixValue matrix{size, size};
+        for (auto &value : matrix)
+        {
+            if constexpr (std::is_same_v<typename Types::Real, mpq_class>)
+            {
+                const mpq_class row_value{static_cast<int>(device.random_int(100)), 100};
+                if constexpr (Types::Value::IS_CONSTANT_SUM)
+                {
+                    value = typename Types::Value{row_value};
+                }
+                else
+                {
+                    value = typename Types::Value{row_value, mpq_class{1} - row_value};
+                }
+            }
+            else
+            {
+                value = typename Types::Value{device.uniform()};
+            }
+        }
+        matrices.push_back(matrix);
+    }
+    typename Types::VectorReal row_strategy, col_strategy;
+    LRSNash::solve(matrices[0], row_strategy, col_strategy, args...);
+
+    const size_t allocations_before = allocations;
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < solves; ++i)
+    {
+        LRSNash::solve(matrices[i % matrices.size()], row_strategy, col_strategy, args...);
+    }
+    const double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    std::cout << name << " " << size << "x" << size << " : "
+              << static_cast<double>(allocations - allocations_before) / solves << " allocations/solve, "
+              << ns / solves << " ns/solve" << std::endl;
+}
+
+int main()
+{
+    mp_set_memory_functions(gmp_allocate, gmp_reallocate, gmp_free);
+    for (size_t size = 2; size <= 10; ++size)
+    {
+        benchmark<ConstantSumTypes>("mpq constant-sum", size);
+        benchmark<BimatrixTypes>("mpq bimatrix", size);
+        benchmark<FloatTypes>("double lrs", size, 100);
+    }
+    return 0;
+}
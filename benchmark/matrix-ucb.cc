@@ -0,0 +1,65 @@
+#include <pinyon.h>
+
+/*
+
+MatrixUCB iterations per second on RandomTrees with 3x3 to 9x9 matrix nodes, compared to Exp3 on the same trees.
+RandomTree transitions are expensive at these sizes, so the cost of the bandit alone is also measured: select and
+update on a single node, with the payoff of each joint action fixed by a random matrix.
+
+*/
+
+const size_t duration_ms = 2000;
+
+template <typename Types>
+void benchmark(const size_t actions)
+{
+    typename Types::PRNG device{0};
+    const typename Types::State state{prng{0}, 4, actions, actions, 1};
+    typename Types::Model model{0};
+    typename Types::MatrixNode root{};
+    typename Types::Search search{};
+    const size_t iterations = search.run(duration_ms, device, state, model, root);
+    std::cout << actions << "x" << actions << " " << search << " : " << iterations * 1000 / duration_ms
+              << " iterations/s" << std::endl;
+}
+
+template <typename Types>
+void benchmark_bandit(const size_t actions)
+{
+    typename Types::PRNG device{0};
+    typename Types::BanditAlgorithm bandit{};
+    typename Types::MatrixStats stats{};
+    bandit.expand(stats, actions, actions, {});
+    std::vector<double> payoffs(actions * actions);
+    for (double &payoff : payoffs)
+    {
+        payoff = device.uniform();
+    }
+    typename Types::Outcome outcome;
+    size_t iterations = 0;
+    Deadline deadline{duration_ms};
+    for (; !deadline.expired(); ++iterations)
+    {
+        bandit.select(device, stats, outcome);
+        outcome.value = typename Types::Value{payoffs[outcome.row_idx * actions + outcome.col_idx]};
+        bandit.update_matrix_stats(stats, outcome);
+    }
+    std::cout << actions << "x" << actions << " " << bandit << " select + update : " << iterations * 1000 / duration_ms
+              << " /s" << std::endl;
+}
+
+int main()
+{
+    using Types = MonteCarloModel<RandomTree<>>;
+    for (const size_t actions : {3, 5, 7, 9})
+    {
+        benchmark<TreeBandit<MatrixUCB<Types>>>(actions);
+        benchmark<TreeBandit<Exp3<Types>>>(actions);
+    }
+    for (const size_t actions : {3, 5, 7, 9})
+    {
+        benchmark_bandit<MatrixUCB<Types>>(actions);
+        benchmark_bandit<Exp3<Types>>(actions);
+    }
+    return 0;
+}
@@ -66,7 +66,7 @@ void benchmark_mtp(std::tuple<SearchTypes...> search_type_tuple)
 int main()
 {
     auto bandit_type_pack = TypePack<Exp3<MonteCarloModel<MoldState<>>>>{};
-    auto node_template_pack = NodeTemplatePack<DefaultNodes, LNodes, DebugNodes, FlatNodes>{};
+    auto node_template_pack = NodeTemplatePack<DefaultNodes, LNodes, DebugNodes, FlatNodes, ArenaNodes>{};
 
     auto st_search_type_tuple = search_type_generator<TreeBandit>(bandit_type_pack, node_template_pack);
     auto mt_search_type_tuple = search_type_generator<TreeBanditThreaded>(bandit_type_pack, node_template_pack);
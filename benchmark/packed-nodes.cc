@@ -0,0 +1,119 @@
+#include <pinyon.h>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+/*
+
+Exp3 search on a wide RandomTree with DefaultNodes and PackedNodes.
+For each iteration budget this prints the iterations per second and, where the kernel allows it, the last level cache
+misses per iteration.
+
+*/
+
+// Counts hardware cache misses of this thread. `read` returns -1 if the counter is not available
+class CacheMisses
+{
+#ifdef __linux__
+    int fd = -1;
+
+public:
+    CacheMisses()
+    {
+        perf_event_attr attr{};
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.size = sizeof(perf_event_attr);
+        attr.config = PERF_COUNT_HW_CACHE_MISSES;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        fd = syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+    }
+
+    ~CacheMisses()
+    {
+        if (fd != -1)
+        {
+            close(fd);
+        }
+    }
+
+    void start()
+    {
+        if (fd != -1)
+        {
+            ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+
+    long long read()
+    {
+        long long count = -1;
+        if (fd == -1)
+        {
+            return count;
+        }
+        ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+        if (::read(fd, &count, sizeof(count)) != sizeof(count))
+        {
+            return -1;
+        }
+        return count;
+    }
+#else
+public:
+    void start() {}
+
+    long long read()
+    {
+        return -1;
+    }
+#endif
+};
+
+template <typename Types>
+void benchmark(const std::string &name)
+{
+    const typename Types::State state{typename Types::PRNG{0}, 10, 9, 9, 3};
+    {
+        // the first search after a large tree was freed is dominated by the allocator, so it is not timed
+        typename Types::PRNG device{0};
+        typename Types::Model model{0};
+        typename Types::MatrixNode root{};
+        typename Types::Search search{};
+        search.run_for_iterations(1 << 12, device, state, model, root);
+    }
+    for (size_t iterations = 1 << 12; iterations <= 1 << 18; iterations <<= 2)
+    {
+        typename Types::PRNG device{0};
+        typename Types::Model model{0};
+        typename Types::MatrixNode root{};
+        typename Types::Search search{};
+        CacheMisses cache_misses{};
+        cache_misses.start();
+        const size_t ms = search.run_for_iterations(iterations, device, state, model, root);
+        const long long misses = cache_misses.read();
+        std::cout << name << " iterations: " << iterations << " : " << iterations * 1000 / std::max(ms, size_t{1})
+                  << " iterations/s";
+        if (misses >= 0)
+        {
+            std::cout << ", " << static_cast<double>(misses) / iterations << " cache misses/iteration";
+        }
+        std::cout << std::endl;
+    }
+}
+
+int main()
+{
+    using FastTypes = Exp3<MonteCarloModel<RandomTree<RandomTreeFastTypes, true>>>;
+    using PackedTypes = Exp3<MonteCarloModel<RandomTree<RandomTreePackedTypes, true>>>;
+    benchmark<TreeBandit<FastTypes, DefaultNodes>>("DefaultNodes");
+    benchmark<TreeBandit<FastTypes, PackedNodes>>("PackedNodes (std::vector stats)");
+    benchmark<TreeBandit<PackedTypes, PackedNodes>>("PackedNodes");
+    return 0;
+}
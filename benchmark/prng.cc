@@ -0,0 +1,63 @@
+#include <pinyon.h>
+
+/*
+
+Rollouts per second from the root of a RandomTree with each PRNG, and raw draws per second.
+A RandomTree rollout builds a PRNG from the transition seed at every step and copies the state's PRNG,
+so the size of the generator shows up in both.
+
+*/
+
+const size_t duration_ms = 1000;
+
+template <typename PRNG>
+using RandomTreeTypes = DefaultTypes<
+    double,
+    int,
+    int,
+    double,
+    ConstantSum<1, 1>::Value,
+    std::vector,
+    Matrix,
+    std::mutex,
+    uint64_t,
+    PRNG>;
+
+template <typename PRNG>
+void benchmark(const std::string &name)
+{
+    using Types = MonteCarloModel<RandomTree<RandomTreeTypes<PRNG>>>;
+    const typename Types::State state{PRNG{0}, 10, 3, 3, 3};
+    typename Types::Model model{PRNG{0}};
+    typename Types::ModelOutput output{};
+    size_t rollouts = 0;
+    Deadline deadline{duration_ms};
+    for (; !deadline.expired(); ++rollouts)
+    {
+        typename Types::State state_copy{state};
+        model.inference(std::move(state_copy), output);
+    }
+
+    PRNG device{0};
+    size_t draws = 0;
+    uint64_t checksum = 0;
+    Deadline draw_deadline{duration_ms};
+    while (!draw_deadline.expired())
+    {
+        for (size_t i = 0; i < 1024; ++i, ++draws)
+        {
+            checksum += device.random_int(9);
+        }
+    }
+
+    std::cout << name << " (" << sizeof(PRNG) << " bytes) : " << rollouts * 1000 / duration_ms << " rollouts/s, "
+              << draws * 1000 / duration_ms << " random_int/s (" << checksum << ")" << std::endl;
+}
+
+int main()
+{
+    benchmark<prng>("prng");
+    benchmark<xoshiro>("xoshiro");
+    benchmark<pcg64>("pcg64");
+    return 0;
+}
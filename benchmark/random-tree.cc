@@ -0,0 +1,49 @@
+#include <pinyon.h>
+
+/*
+
+Monte Carlo rollouts per second on wide RandomTrees, with the default transitions (`discard` and every chance
+strategy of the child drawn with rationals) and with hashed transitions (reseeding and lazy chance weights).
+
+*/
+
+const size_t duration_ms = 1000;
+
+template <typename Types>
+size_t rollouts_per_second(const size_t actions, const size_t transitions)
+{
+    using ModelTypes = MonteCarloModel<Types>;
+    const typename ModelTypes::State state{typename ModelTypes::PRNG{0}, 10, actions, actions, transitions};
+    typename ModelTypes::Model model{typename ModelTypes::PRNG{0}};
+    typename ModelTypes::ModelOutput output{};
+    size_t rollouts = 0;
+    Deadline deadline{duration_ms};
+    for (; !deadline.expired(); ++rollouts)
+    {
+        typename ModelTypes::State state_copy{state};
+        model.inference(std::move(state_copy), output);
+    }
+    return rollouts * 1000 / duration_ms;
+}
+
+template <typename Types>
+void benchmark(const std::string &name)
+{
+    for (const size_t actions : {3, 9})
+    {
+        for (const size_t transitions : {1, 9})
+        {
+            std::cout << name << " actions: " << actions << " transitions: " << transitions << " : "
+                      << rollouts_per_second<RandomTree<Types>>(actions, transitions) << " -> "
+                      << rollouts_per_second<RandomTree<Types, true>>(actions, transitions) << " rollouts/s"
+                      << std::endl;
+        }
+    }
+}
+
+int main()
+{
+    benchmark<RandomTreeFloatTypes>("prng");
+    benchmark<RandomTreeFastTypes>("xoshiro");
+    return 0;
+}
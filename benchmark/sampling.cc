@@ -0,0 +1,79 @@
+#include <pinyon.h>
+
+/*
+
+Samples per second from a random distribution over 2 to 64 actions:
+the subtract-scan `sample_pdf` used before, the branchless `sample_pdf`, quantized `Strategy` sampling, and
+`AliasTable` sampling. Construction of the quantized forms is timed separately, since it decides when they pay off.
+
+*/
+
+const size_t duration_ms = 500;
+
+int scan_pdf(prng &device, const std::vector<double> &input)
+{
+    double p = device.uniform();
+    for (int i = 0; i < input.size(); ++i)
+    {
+        p -= input[i];
+        if (p <= 0)
+        {
+            return i;
+        }
+    }
+    return 0;
+}
+
+template <typename F>
+void benchmark(const std::string &name, const size_t k, F &&sample)
+{
+    size_t iterations = 0;
+    size_t checksum = 0;
+    Deadline deadline{duration_ms};
+    while (!deadline.expired())
+    {
+        for (size_t i = 0; i < 1024; ++i, ++iterations)
+        {
+            checksum += sample();
+        }
+    }
+    std::cout << k << " actions " << name << " : " << iterations * 1000 / duration_ms << " /s (" << checksum << ")"
+              << std::endl;
+}
+
+int main()
+{
+    for (const size_t k : {2, 3, 5, 9, 16, 64})
+    {
+        prng device{0};
+        std::vector<double> pdf(k);
+        double sum = 0;
+        for (double &p : pdf)
+        {
+            sum += (p = device.uniform());
+        }
+        for (double &p : pdf)
+        {
+            p /= sum;
+        }
+        const Strategy<uint8_t> strategy_8{pdf};
+        const Strategy<uint16_t> strategy_16{pdf};
+        const AliasTable<uint16_t> alias{pdf};
+
+        benchmark("scan", k, [&]()
+                  { return scan_pdf(device, pdf); });
+        benchmark("sample_pdf", k, [&]()
+                  { return device.sample_pdf(pdf); });
+        benchmark("Strategy<uint8_t>", k, [&]()
+                  { return strategy_8.sample(device); });
+        benchmark("Strategy<uint16_t>", k, [&]()
+                  { return strategy_16.sample(device); });
+        benchmark("AliasTable<uint16_t>", k, [&]()
+                  { return alias.sample(device); });
+        benchmark("Strategy<uint16_t> construction", k, [&]()
+                  { return Strategy<uint16_t>{pdf}[0]; });
+        benchmark("AliasTable<uint16_t> construction", k, [&]()
+                  { return AliasTable<uint16_t>{pdf}.columns[0].alias; });
+    }
+    return 0;
+}
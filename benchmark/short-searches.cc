@@ -0,0 +1,43 @@
+#include <pinyon.h>
+
+/*
+
+Many short searches on fresh roots, as when a multi-threaded search is used once per move or as a leaf evaluator.
+The worker threads are created on the first call and reused for the rest.
+
+*/
+
+const size_t max_actions = 3;
+const size_t max_depth = 10;
+const size_t searches = 1000;
+const size_t iterations = 1 << 8;
+
+template <typename Types, typename... Args>
+void benchmark_(Args... args)
+{
+    typename Types::PRNG device{0};
+    typename Types::State state{max_actions, max_depth};
+    typename Types::Model model{0};
+    typename Types::Search search{typename Types::BanditAlgorithm{.1}, args...};
+    const auto start = std::chrono::high_resolution_clock::now();
+    for (size_t i = 0; i < searches; ++i)
+    {
+        typename Types::MatrixNode root{};
+        search.run_for_iterations(iterations, device, state, model, root);
+    }
+    const auto end = std::chrono::high_resolution_clock::now();
+    const auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
+    std::cout << search << " : " << duration.count() / searches << " us per search" << std::endl;
+}
+
+int main()
+{
+    using Types = MonteCarloModel<MoldState<>>;
+    for (const size_t threads : {1, 2, 4, 8})
+    {
+        std::cout << "threads: " << threads << std::endl;
+        benchmark_<TreeBanditThreaded<Exp3<Types>>>(threads);
+        benchmark_<TreeBanditThreadPool<Exp3<Types>>>(threads, size_t{64});
+    }
+    return 0;
+}
@@ -0,0 +1,114 @@
+#include <pinyon.h>
+
+/*
+
+Heap allocations per iteration of Exp3 and MatrixUCB, with `std::vector` and with `Small<9>::Vector`.
+The bandit alone is measured with select and update on a single 9x9 node, with the payoff of each joint action fixed.
+The search is measured on a RandomTree with 9x9 matrix nodes, where the allocations also include the tree and state.
+
+*/
+
+const size_t duration_ms = 1000;
+
+size_t allocations = 0;
+
+void *operator new(size_t size)
+{
+    ++allocations;
+    if (void *ptr = std::malloc(size))
+    {
+        return ptr;
+    }
+    throw std::bad_alloc{};
+}
+
+void operator delete(void *ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, size_t) noexcept
+{
+    std::free(ptr);
+}
+
+void *operator new(size_t size, std::align_val_t alignment)
+{
+    ++allocations;
+    const size_t a = static_cast<size_t>(alignment);
+    if (void *ptr = std::aligned_alloc(a, (size + a - 1) / a * a))
+    {
+        return ptr;
+    }
+    throw std::bad_alloc{};
+}
+
+void operator delete(void *ptr, std::align_val_t) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, size_t, std::align_val_t) noexcept
+{
+    std::free(ptr);
+}
+
+template <typename Types>
+void benchmark_bandit(const std::string &name, const size_t actions)
+{
+    typename Types::PRNG device{0};
+    typename Types::BanditAlgorithm bandit{};
+    typename Types::MatrixStats stats{};
+    bandit.expand(stats, actions, actions, {});
+    std::vector<double> payoffs(actions * actions);
+    for (double &payoff : payoffs)
+    {
+        payoff = device.uniform();
+    }
+    typename Types::Outcome outcome;
+    size_t iterations = 0;
+    const size_t allocations_before = allocations;
+    Deadline deadline{duration_ms};
+    for (; !deadline.expired(); ++iterations)
+    {
+        bandit.select(device, stats, outcome);
+        outcome.value = typename Types::Value{payoffs[outcome.row_idx * actions + outcome.col_idx]};
+        bandit.update_matrix_stats(stats, outcome);
+    }
+    std::cout << name << " " << bandit << " select + update : " << iterations * 1000 / duration_ms << " /s, "
+              << static_cast<double>(allocations - allocations_before) / iterations << " allocations/iteration"
+              << std::endl;
+}
+
+template <typename Types>
+void benchmark_search(const std::string &name, const size_t actions)
+{
+    typename Types::PRNG device{0};
+    const typename Types::State state{typename Types::PRNG{0}, 4, actions, actions, 1};
+    typename Types::Model model{0};
+    typename Types::MatrixNode root{};
+    typename Types::Search search{};
+    const size_t allocations_before = allocations;
+    const size_t iterations = search.run(duration_ms, device, state, model, root);
+    std::cout << name << " " << search << " : " << iterations * 1000 / duration_ms << " iterations/s, "
+              << static_cast<double>(allocations - allocations_before) / iterations << " allocations/iteration"
+              << std::endl;
+}
+
+template <template <typename> typename Bandit>
+void benchmark(const size_t actions)
+{
+    using Types = MonteCarloModel<RandomTree<RandomTreeFastTypes, true>>;
+    using SmallTypes = MonteCarloModel<RandomTree<RandomTreeSmallTypes, true>>;
+    benchmark_bandit<Bandit<Types>>("std::vector", actions);
+    benchmark_bandit<Bandit<SmallTypes>>("Small<9>::Vector", actions);
+    benchmark_search<TreeBandit<Bandit<Types>>>("std::vector", actions);
+    benchmark_search<TreeBandit<Bandit<SmallTypes>>>("Small<9>::Vector", actions);
+}
+
+int main()
+{
+    benchmark<Exp3>(9);
+    benchmark<MatrixUCB>(9);
+    return 0;
+}
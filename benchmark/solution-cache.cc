@@ -0,0 +1,51 @@
+#include <pinyon.h>
+
+/*
+
+Hit rate of a SolutionCache shared by AlphaBeta solves of RandomTrees, and the solve time with and without it.
+Each tree is solved to its terminal states with floating point and rational payoffs.
+
+*/
+
+template <typename Types>
+void benchmark(const std::string &name, const size_t depth, const size_t actions, const size_t transitions,
+               const size_t trees)
+{
+    const auto cache = std::make_shared<SolutionCache<Types>>(1 << 14);
+    double ms = 0, cached_ms = 0;
+    for (uint64_t seed = 0; seed < trees; ++seed)
+    {
+        const typename Types::State state{prng{seed}, depth, actions, actions, transitions};
+        for (const bool use_cache : {false, true})
+        {
+            prng device{0};
+            typename Types::Model model{0};
+            typename AlphaBeta<Types>::Search search{0, 1};
+            if (use_cache)
+            {
+                search.solution_cache = cache;
+            }
+            typename AlphaBeta<Types>::MatrixNode root{};
+            const auto start = std::chrono::steady_clock::now();
+            search.run(depth, device, state, model, root);
+            const double elapsed =
+                std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+            (use_cache ? cached_ms : ms) += elapsed;
+        }
+    }
+    std::cout << name << " RandomTree(" << depth << ", " << actions << ", " << actions << ", " << transitions << ") x "
+              << trees << " : hit rate " << cache->hit_rate() << " (" << cache->hits() << " hits, " << cache->misses()
+              << " misses), " << ms << " ms without cache, " << cached_ms << " ms with cache" << std::endl;
+}
+
+int main()
+{
+    using FloatTypes = MonteCarloModel<RandomTree<RandomTreeFloatTypes>>;
+    using RationalTypes = MonteCarloModel<RandomTree<RandomTreeRationalTypes>>;
+    for (const auto [depth, actions, transitions] : {std::tuple{2, 3, 2}, {3, 3, 2}, {3, 4, 1}, {4, 2, 2}})
+    {
+        benchmark<FloatTypes>("double", depth, actions, transitions, 16);
+        benchmark<RationalTypes>("mpq", depth, actions, transitions, 16);
+    }
+    return 0;
+}
@@ -0,0 +1,72 @@
+#include <pinyon.h>
+
+/*
+
+Cost of resetting the state at the start of every search iteration on RandomTree.
+
+`RandomTree::State` satisfies `IsRestorableStateTypes`, so searches copy it once and then restore it in place.
+`CopiedRandomTree` hides `restore`, so the same searches fall back to copying the root state every iteration.
+Both run the same iterations, only the reset differs.
+
+*/
+
+struct CopiedRandomTree : RandomTree<>
+{
+    class State : public RandomTree<>::State
+    {
+    public:
+        using RandomTree<>::State::State;
+        void restore(const State &) = delete;
+    };
+};
+
+const size_t duration_ms = 1000;
+
+template <typename Types>
+void reset_only(const typename Types::State &state)
+{
+    size_t iterations = 0;
+    size_t terminal = 0;
+    Deadline deadline{duration_ms};
+    IterationState<Types> iteration_state{state};
+    for (; !deadline.expired(); ++iterations)
+    {
+        typename Types::State &state_copy = iteration_state.reset();
+        terminal += state_copy.is_terminal();
+    }
+    std::cout << "reset : " << iterations * 1000 / duration_ms << " /s" << (terminal ? " (terminal)" : "") << std::endl;
+}
+
+template <typename Types>
+void search(const typename Types::State &state)
+{
+    typename Types::PRNG device{0};
+    typename Types::Model model{0};
+    typename Types::MatrixNode root{};
+    typename Types::Search search{};
+    const size_t iterations = search.run(duration_ms, device, state, model, root);
+    std::cout << search << " : " << iterations * 1000 / duration_ms << " iterations/s" << std::endl;
+}
+
+template <typename StateTypes>
+void benchmark(const char *name)
+{
+    using Types = MonteCarloModel<StateTypes>;
+    std::cout << name << std::endl;
+    for (const size_t actions : {2, 5, 9})
+    {
+        const typename Types::State state{prng{0}, 20, actions, actions, 3};
+        std::cout << "actions: " << actions << std::endl;
+        reset_only<Types>(state);
+        search<TreeBandit<Exp3<Types>>>(state);
+    }
+}
+
+int main()
+{
+    static_assert(IsRestorableStateTypes<RandomTree<>>);
+    static_assert(!IsRestorableStateTypes<CopiedRandomTree>);
+    benchmark<RandomTree<>>("restore");
+    benchmark<CopiedRandomTree>("copy");
+    return 0;
+}
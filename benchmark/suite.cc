@@ -0,0 +1,59 @@
+#include "harness.h"
+
+/*
+
+Every bandit x node x tree bandit combination on MoldState, RandomTree and OneSumMatrixGame, see harness.h.
+The records are written to stdout as JSON (or CSV with `--format=csv`), and progress to stderr. For example
+
+    ./suite --duration=1000 --repetitions=10 --label=$(git describe --always) --out=results.json
+
+The exploitability is measured on the RandomTree, which is solved with `TraversedState`, and on the matrix game.
+MatrixUCB and the ArenaNodes and PackedNodes are only used by the single threaded search, and Exp3Atomic only by the
+multithreaded searches.
+
+*/
+
+template <typename State>
+auto search_types()
+{
+    using Model = MonteCarloModel<State>;
+    const auto bandit_type_pack = TypePack<Exp3<Model>, MatrixUCB<Model>>{};
+    const auto node_template_pack = NodeTemplatePack<DefaultNodes, FlatNodes, ArenaNodes, PackedNodes>{};
+    const auto threaded_bandit_type_pack = TypePack<Exp3<Model>, Exp3Atomic<Model>>{};
+    const auto threaded_node_template_pack = NodeTemplatePack<DefaultNodes, FlatNodes>{};
+    return std::tuple_cat(
+        search_type_generator<TreeBandit>(bandit_type_pack, node_template_pack),
+        search_type_generator<TreeBanditThreaded, TreeBanditThreadPool>(
+            threaded_bandit_type_pack, threaded_node_template_pack));
+}
+
+int main(int argc, char **argv)
+{
+    const BenchmarkOptions options{argc, argv};
+    BenchmarkWriter writer{options};
+
+    {
+        using Types = MonteCarloModel<MoldState<>>;
+        const Types::State state{2, 10};
+        run_searches(search_types<MoldState<>>(), "MoldState(2, 10)", state, nullptr, options, writer);
+    }
+    {
+        using State = RandomTree<RandomTreeFastTypes, true>;
+        using Types = MonteCarloModel<State>;
+        const Types::State state{Types::PRNG{0}, 3, 3, 3, 2};
+        Types::Model model{0};
+        const TraversedState<Types>::State solved_state{state, model};
+        Types::MatrixValue payoff_matrix;
+        solved_state.get_matrix(payoff_matrix);
+        run_searches(search_types<State>(), "RandomTree(3, 3, 3, 2)", state, &payoff_matrix, options, writer);
+    }
+    {
+        using Types = MonteCarloModel<OneSumMatrixGame>;
+        const Types::State state{prng{0}, 5, 5};
+        run_searches(search_types<OneSumMatrixGame>(), "OneSumMatrixGame(5, 5)", state, &state.payoff_matrix,
+                     options, writer);
+    }
+
+    writer.write();
+    return 0;
+}
@@ -0,0 +1,44 @@
+#include <pinyon.h>
+
+/*
+
+Exp3 search on ScoreGame, which transposes heavily, with DefaultNodes and TranspositionNodes.
+For each iteration budget this prints the iterations per second, the number of matrix nodes and the exploitability
+of the root strategies, measured against the solved root matrix.
+
+*/
+
+using BaseTypes = Exp3<MonteCarloModel<ScoreGame<>>>;
+
+template <typename Types>
+void benchmark(const std::string &name, const BaseTypes::State &state, const BaseTypes::MatrixValue &payoff_matrix)
+{
+    for (size_t iterations = 1 << 10; iterations <= 1 << 16; iterations <<= 2)
+    {
+        typename Types::PRNG device{0};
+        typename Types::Model model{0};
+        typename Types::MatrixNode root{};
+        typename Types::Search search{};
+        const size_t ms = search.run_for_iterations(iterations, device, state, model, root);
+        typename Types::VectorReal row_strategy, col_strategy;
+        search.get_empirical_strategies(root.stats, row_strategy, col_strategy);
+        std::cout << name << " iterations: " << iterations << " : " << iterations * 1000 / std::max(ms, size_t{1})
+                  << " iterations/s, " << root.count_matrix_nodes() << " matrix nodes, exploitability "
+                  << math::exploitability(payoff_matrix, row_strategy, col_strategy) << std::endl;
+    }
+}
+
+int main()
+{
+    const BaseTypes::State state{3, 5};
+    BaseTypes::Model model{0};
+    const TraversedState<BaseTypes>::State solved_state{state, model};
+    BaseTypes::MatrixValue payoff_matrix;
+    solved_state.get_matrix(payoff_matrix);
+
+    benchmark<TreeBandit<BaseTypes, DefaultNodes>>("DefaultNodes", state, payoff_matrix);
+    benchmark<TreeBandit<BaseTypes, TranspositionNodes>>("TranspositionNodes", state, payoff_matrix);
+    benchmark<TreeBandit<BaseTypes, TranspositionNodes, SearchOptions<void, bool>>>("TranspositionNodes (average)",
+                                                                                    state, payoff_matrix);
+    return 0;
+}
@@ -0,0 +1,41 @@
+#include <pinyon.h>
+
+/*
+
+Unique matrix nodes created per second by TreeBanditThreaded, with and without virtual loss.
+Without it, threads tend to follow each other down the same joint actions and duplicate work.
+
+*/
+
+const size_t max_actions = 3;
+const size_t max_depth = 10;
+const size_t duration_ms = 2000;
+
+template <typename Types>
+void benchmark_(const size_t threads, const int virtual_loss)
+{
+    typename Types::PRNG device{0};
+    typename Types::State state{max_actions, max_depth};
+    typename Types::Model model{0};
+    typename Types::MatrixNode root{};
+    typename Types::Search search{typename Types::BanditAlgorithm{}, threads, virtual_loss};
+    const size_t iterations = search.run(duration_ms, device, state, model, root);
+    const size_t nodes = root.count_matrix_nodes();
+    std::cout << search << " : " << nodes * 1000 / duration_ms << " nodes/s, "
+              << iterations * 1000 / duration_ms << " iterations/s" << std::endl;
+}
+
+int main()
+{
+    using Types = MonteCarloModel<MoldState<>>;
+    const size_t max_threads = std::max(std::thread::hardware_concurrency(), 1u);
+    for (size_t threads = 1; threads <= max_threads; threads *= 2)
+    {
+        for (const int virtual_loss : {0, 1, 4})
+        {
+            benchmark_<TreeBanditThreaded<Exp3<Types>>>(threads, virtual_loss);
+            benchmark_<TreeBanditThreaded<UCB<Types>>>(threads, virtual_loss);
+        }
+    }
+    return 0;
+}
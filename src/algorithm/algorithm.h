@@ -78,6 +78,22 @@ concept IsMultithreadedBanditTypes =
     } &&
     IsBanditAlgorithmTypes<Types>;
 
+template <typename Types>
+concept IsVirtualLossBanditTypes =
+    requires(
+        typename Types::BanditAlgorithm &bandit,
+        typename Types::MatrixStats &matrix_stats,
+        typename Types::Outcome &outcome,
+        typename Types::Mutex &mutex) {
+        {
+            bandit.apply_virtual_loss(matrix_stats, outcome, 0, mutex)
+        } -> std::same_as<void>;
+        {
+            bandit.revert_virtual_loss(matrix_stats, outcome, 0, mutex)
+        } -> std::same_as<void>;
+    } &&
+    IsMultithreadedBanditTypes<Types>;
+
 template <typename Types>
 concept IsOffPolicyBanditTypes =
     requires(
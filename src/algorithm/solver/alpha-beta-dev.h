@@ -1,6 +1,7 @@
 #pragma once
 
 #include <libpinyon/lrslib.h>
+#include <libpinyon/solution-cache.h>
 #include <types/matrix.h>
 #include <algorithm/algorithm.h>
 #include <tree/tree.h>
@@ -92,6 +93,7 @@ struct AlphaBetaDev : Types
         const size_t max_tries{1 << 6};
         const Types::Prob max_unexplored{typename Types::Q{0}};
         const Types::ObsHash hash_function{};
+        std::shared_ptr<SolutionCache<Types>> solution_cache{};
         Types::Prob min_chance_prob_base{0};
         Types::Prob min_chance_prob{1};
 
@@ -306,7 +308,8 @@ struct AlphaBetaDev : Types
                     int entry_idx = 0;
                     if (solved_exactly)
                     {
-                        typename Types::MatrixValue matrix{I.size(), J.size()};
+                        thread_local typename Types::MatrixValue matrix{};
+                        matrix.fill(I.size(), J.size());
                         for (auto row_idx : I)
                         {
                             for (auto col_idx : J)
@@ -316,13 +319,15 @@ struct AlphaBetaDev : Types
                                 ++entry_idx;
                             }
                         }
-                        LRSNash::solve(matrix, row_solution, col_solution);
+                        LRSNash::solve(solution_cache.get(), matrix, row_solution, col_solution);
 
                         // matrix.print();
                     }
                     else
                     {
-                        typename Types::MatrixValue alpha_matrix{I.size(), J.size()}, beta_matrix{I.size(), J.size()};
+                        thread_local typename Types::MatrixValue alpha_matrix{}, beta_matrix{};
+                        alpha_matrix.fill(I.size(), J.size());
+                        beta_matrix.fill(I.size(), J.size());
                         for (auto row_idx : I)
                         {
                             for (auto col_idx : J)
@@ -333,10 +338,10 @@ struct AlphaBetaDev : Types
                                 ++entry_idx;
                             }
                         }
-                        typename Types::VectorReal temp;
-                        LRSNash::solve(alpha_matrix, row_solution, temp);
+                        thread_local typename Types::VectorReal temp{};
+                        LRSNash::solve(solution_cache.get(), alpha_matrix, row_solution, temp);
                         temp.clear();
-                        LRSNash::solve(beta_matrix, temp, col_solution);
+                        LRSNash::solve(solution_cache.get(), beta_matrix, temp, col_solution);
                     }
                 }
 
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <libpinyon/lrslib.h>
+#include <libpinyon/solution-cache.h>
 #include <types/matrix.h>
 #include <algorithm/algorithm.h>
 #include <tree/tree.h>
@@ -93,6 +94,7 @@ struct AlphaBetaForce : Types
         const size_t max_tries{1 << 6};
         const Types::Prob max_unexplored{typename Types::Q{0}};
         const Types::ObsHash hash_function{};
+        std::shared_ptr<SolutionCache<Types>> solution_cache{};
 
         Search() {}
 
@@ -209,7 +211,8 @@ struct AlphaBetaForce : Types
                 int entry_idx = 0;
                 if (solved_exactly)
                 {
-                    typename Types::MatrixValue matrix{I.size(), J.size()};
+                    thread_local typename Types::MatrixValue matrix{};
+                    matrix.fill(I.size(), J.size());
                     for (auto row_idx : I)
                     {
                         for (auto col_idx : J)
@@ -219,11 +222,13 @@ struct AlphaBetaForce : Types
                             ++entry_idx;
                         }
                     }
-                    LRSNash::solve(matrix, row_solution, col_solution);
+                    LRSNash::solve(solution_cache.get(), matrix, row_solution, col_solution);
                 }
                 else
                 {
-                    typename Types::MatrixValue alpha_matrix{I.size(), J.size()}, beta_matrix{I.size(), J.size()};
+                    thread_local typename Types::MatrixValue alpha_matrix{}, beta_matrix{};
+                    alpha_matrix.fill(I.size(), J.size());
+                    beta_matrix.fill(I.size(), J.size());
                     for (auto row_idx : I)
                     {
                         for (auto col_idx : J)
@@ -234,10 +239,10 @@ struct AlphaBetaForce : Types
                             ++entry_idx;
                         }
                     }
-                    typename Types::VectorReal temp;
-                    LRSNash::solve(alpha_matrix, row_solution, temp);
+                    thread_local typename Types::VectorReal temp{};
+                    LRSNash::solve(solution_cache.get(), alpha_matrix, row_solution, temp);
                     temp.clear();
-                    LRSNash::solve(beta_matrix, temp, col_solution);
+                    LRSNash::solve(solution_cache.get(), beta_matrix, temp, col_solution);
                 }
 
                 std::pair<int, Real>
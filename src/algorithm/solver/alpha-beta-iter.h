@@ -0,0 +1,546 @@
+#pragma once
+
+#include <libpinyon/deadline.h>
+#include <algorithm/solver/alpha-beta.h>
+
+#include <algorithm>
+#include <atomic>
+#include <numeric>
+
+/*
+
+Anytime AlphaBeta. `run` solves the root to depth 1, 2, ... until its time budget runs out, on one tree that is kept
+between depths. Each matrix node keeps
+    * the support of its last solution, which is the first subgame (I, J) at the next depth
+    * the value of each action in the last best response scans, so the scans try the best actions first
+    * the chance branches of each entry, ordered by probability
+    * its bounds, which are returned as they are when no leaf below the node was a model inference
+
+A depth that runs out of time is discarded. The root stats hold the bounds and strategies of the last completed depth.
+The subgame solves and best response scans are those of `AlphaBeta`, with its own data and scan order.
+
+*/
+
+template <IsSingleModelTypes Types, template <typename...> typename NodePair = DefaultNodes>
+struct AlphaBetaIter : Types
+{
+    using Real = Types::Real;
+
+    struct Data
+    {
+        Types::Prob unexplored{1};
+        Real alpha_explored{0}, beta_explored{0};
+        int next_chance_idx = 0;
+        std::vector<typename Types::Obs> chance_actions{};
+        // 0 until the branch is explored
+        std::vector<typename Types::Prob> chance_probs{};
+
+        // clears the bounds for a new depth, and puts the most probable chance branches first
+        void reset()
+        {
+            unexplored = typename Types::Prob{1};
+            alpha_explored = Real{0};
+            beta_explored = Real{0};
+            next_chance_idx = 0;
+
+            std::vector<size_t> order(chance_actions.size());
+            std::iota(order.begin(), order.end(), 0);
+            std::stable_sort(
+                order.begin(), order.end(),
+                [this](const size_t a, const size_t b)
+                { return chance_probs[a] > chance_probs[b]; });
+            std::vector<typename Types::Obs> actions{};
+            std::vector<typename Types::Prob> probs{};
+            for (const size_t idx : order)
+            {
+                actions.push_back(chance_actions[idx]);
+                probs.push_back(chance_probs[idx]);
+            }
+            chance_actions.swap(actions);
+            chance_probs.swap(probs);
+        }
+
+        friend std::ostream &operator<<(std::ostream &os, const Data &data)
+        {
+            if constexpr (std::is_same_v<typename Types::Real, mpq_class>)
+            {
+                os << '(' << data.alpha_explored.get_d() << " " << data.beta_explored.get_d() << " " << data.unexplored.get_d() << ")";
+            }
+            else
+            {
+                os << '(' << data.alpha_explored << " " << data.beta_explored << " " << data.unexplored << ")";
+            }
+            return os;
+        }
+    };
+    struct MatrixStats
+    {
+        DataMatrix<Data> chance_data_matrix{};
+        // over all actions, not just I and J
+        Types::VectorReal row_solution{}, col_solution{};
+        unsigned int depth = 0;
+        unsigned int depth_solved_to = 0;
+
+        std::vector<int> I{}, J{};
+        std::vector<Real> row_values{}, col_values{};
+
+        Real alpha{0}, beta{0};
+        // no leaf of the last solve was a model inference, so the bounds hold at any depth
+        bool is_exact = false;
+    };
+    struct ChanceStats
+    {
+    };
+    using MatrixNode = NodePair<Types, MatrixStats, ChanceStats>::MatrixNode;
+    using ChanceNode = NodePair<Types, MatrixStats, ChanceStats>::ChanceNode;
+    // nodes that evict between descents would never evict here, since this search does not call begin_descent
+    static_assert(!IsDescentNodeTypes<NodePair<Types, MatrixStats, ChanceStats>>);
+
+    class Search : public AlphaBeta<Types, NodePair>::Search
+    {
+    public:
+        using AlphaBeta<Types, NodePair>::Search::min_val;
+        using AlphaBeta<Types, NodePair>::Search::max_val;
+        using AlphaBeta<Types, NodePair>::Search::solution_cache;
+
+        // if set, `run` returns early once the flag is true
+        const std::atomic<bool> *stop_flag = nullptr;
+
+        Search() {}
+
+        Search(Real min_val, Real max_val) : AlphaBeta<Types, NodePair>::Search{min_val, max_val} {}
+
+        // Solves one depth deeper than the root's `depth_solved_to` at a time, until `duration_ms` has passed,
+        // `max_depth` is solved or the root is solved exactly. Returns the depth of the last completed solve
+        size_t run(
+            const size_t duration_ms,
+            Types::PRNG &device,
+            const Types::State &state,
+            Types::Model &model,
+            MatrixNode &root,
+            const size_t max_depth = -1) const
+        {
+            Deadline deadline{duration_ms, stop_flag};
+            while (root.stats.depth_solved_to < max_depth && !root.stats.is_exact)
+            {
+                Iteration iteration{root.stats.depth_solved_to + 1u, &deadline};
+                auto state_copy = state;
+                double_oracle(iteration, device, state_copy, model, &root);
+                if (iteration.interrupted)
+                {
+                    break;
+                }
+            }
+            return root.stats.depth_solved_to;
+        }
+
+        // iterative deepening without a time limit
+        std::pair<Real, Real>
+        run_for_depth(
+            const size_t max_depth,
+            Types::PRNG &device,
+            const Types::State &state,
+            Types::Model &model,
+            MatrixNode &root) const
+        {
+            while (root.stats.depth_solved_to < max_depth && !root.stats.is_exact)
+            {
+                Iteration iteration{root.stats.depth_solved_to + 1u, nullptr};
+                auto state_copy = state;
+                double_oracle(iteration, device, state_copy, model, &root);
+            }
+            return {root.stats.alpha, root.stats.beta};
+        }
+
+    private:
+        using AlphaBeta<Types, NodePair>::Search::fuzzy_equals;
+        using AlphaBeta<Types, NodePair>::Search::solve_subgame;
+        using AlphaBeta<Types, NodePair>::Search::response_row;
+        using AlphaBeta<Types, NodePair>::Search::response_col;
+        using AlphaBeta<Types, NodePair>::Search::select_row;
+        using AlphaBeta<Types, NodePair>::Search::select_col;
+
+        struct Iteration
+        {
+            const size_t max_depth;
+            Deadline<> *deadline;
+            bool interrupted = false;
+        };
+
+        std::pair<Real, Real>
+        double_oracle(
+            Iteration &iteration,
+            Types::PRNG &device,
+            Types::State &state,
+            Types::Model &model,
+            MatrixNode *matrix_node) const
+        {
+            MatrixStats &stats = matrix_node->stats;
+
+            if (stats.is_exact)
+            {
+                return {stats.alpha, stats.beta};
+            }
+            if (iteration.deadline != nullptr && iteration.deadline->expired())
+            {
+                iteration.interrupted = true;
+                return {min_val, max_val};
+            }
+            if (state.is_terminal())
+            {
+                matrix_node->set_terminal();
+                const typename Types::Value payoff = state.get_payoff();
+                stats.alpha = payoff.get_row_value();
+                stats.beta = payoff.get_row_value();
+                stats.is_exact = true;
+                return {stats.alpha, stats.beta};
+            }
+
+            state.get_actions();
+
+            // not marked terminal, since the node is expanded at the next depth
+            if (stats.depth >= iteration.max_depth)
+            {
+                typename Types::ModelOutput model_output;
+                model.inference(std::move(state), model_output);
+                return {model_output.value.get_row_value(), model_output.value.get_row_value()};
+            }
+
+            const size_t rows = state.row_actions.size();
+            const size_t cols = state.col_actions.size();
+            matrix_node->expand(rows, cols);
+
+            DataMatrix<Data> &data_matrix = stats.chance_data_matrix;
+            if (data_matrix.size() == 0)
+            {
+                data_matrix.fill(rows, cols);
+                stats.row_values.resize(rows);
+                stats.col_values.resize(cols);
+            }
+            else
+            {
+                for (Data &data : data_matrix)
+                {
+                    data.reset();
+                }
+            }
+
+            // start from the support of the last solution, or else the best actions of the last scans
+            std::vector<int> I{}, J{};
+            for (const int row_idx : stats.I)
+            {
+                if (stats.row_solution[row_idx] > Real{0})
+                {
+                    I.push_back(row_idx);
+                }
+            }
+            if (I.empty())
+            {
+                I.push_back(std::distance(stats.row_values.begin(), std::max_element(stats.row_values.begin(), stats.row_values.end())));
+            }
+            for (const int col_idx : stats.J)
+            {
+                if (stats.col_solution[col_idx] > Real{0})
+                {
+                    J.push_back(col_idx);
+                }
+            }
+            if (J.empty())
+            {
+                J.push_back(std::distance(stats.col_values.begin(), std::min_element(stats.col_values.begin(), stats.col_values.end())));
+            }
+
+            bool solved_exactly = true;
+            bool is_exact = true;
+            for (const int row_idx : I)
+            {
+                for (const int col_idx : J)
+                {
+                    solved_exactly &= try_solve_chance_node(iteration, device, state, model, matrix_node, row_idx, col_idx, is_exact);
+                    if (iteration.interrupted)
+                    {
+                        return {min_val, max_val};
+                    }
+                }
+            }
+
+            Real alpha{min_val}, beta{max_val};
+            typename Types::VectorReal row_solution{}, col_solution{};
+
+            while (!fuzzy_equals(alpha, beta))
+            {
+                // solve newly expanded and explored game
+                solve_subgame(data_matrix, I, J, solved_exactly, row_solution, col_solution);
+
+                const std::pair<int, Real> iv = best_response_row(
+                    iteration, device, state, model, matrix_node, I, J, alpha, max_val, col_solution, is_exact);
+                if (iteration.interrupted)
+                {
+                    return {min_val, max_val};
+                }
+                const std::pair<int, Real> jv = best_response_col(
+                    iteration, device, state, model, matrix_node, I, J, min_val, beta, row_solution, is_exact);
+                if (iteration.interrupted)
+                {
+                    return {min_val, max_val};
+                }
+
+                // prune this node if no best response is as good as alpha/beta
+                if (iv.first == -1)
+                {
+                    return {min_val, min_val};
+                }
+                if (jv.first == -1)
+                {
+                    return {max_val, max_val};
+                }
+
+                bool smaller_bounds = false;
+                bool new_action = false;
+                const int latest_row_idx = iv.first;
+                const int latest_col_idx = jv.first;
+
+                if (std::find(I.begin(), I.end(), latest_row_idx) == I.end())
+                {
+                    I.push_back(latest_row_idx);
+                    for (const int col_idx : J)
+                    {
+                        solved_exactly &= try_solve_chance_node(iteration, device, state, model, matrix_node, latest_row_idx, col_idx, is_exact);
+                        if (iteration.interrupted)
+                        {
+                            return {min_val, max_val};
+                        }
+                    }
+                    new_action = true;
+                }
+                if (std::find(J.begin(), J.end(), latest_col_idx) == J.end())
+                {
+                    J.push_back(latest_col_idx);
+                    for (const int row_idx : I)
+                    {
+                        solved_exactly &= try_solve_chance_node(iteration, device, state, model, matrix_node, row_idx, latest_col_idx, is_exact);
+                        if (iteration.interrupted)
+                        {
+                            return {min_val, max_val};
+                        }
+                    }
+                    new_action = true;
+                }
+                if (jv.second > alpha)
+                {
+                    alpha = jv.second;
+                    smaller_bounds = true;
+                }
+                if (iv.second < beta)
+                {
+                    beta = iv.second;
+                    smaller_bounds = true;
+                }
+
+                if (!smaller_bounds && !new_action)
+                {
+                    break;
+                }
+            }
+
+            // the depth is complete, so it replaces the last solution
+            stats.row_solution.clear();
+            stats.row_solution.resize(rows);
+            for (int i = 0; i < row_solution.size(); ++i)
+            {
+                stats.row_solution[I[i]] = row_solution[i];
+            }
+            stats.col_solution.clear();
+            stats.col_solution.resize(cols);
+            for (int j = 0; j < col_solution.size(); ++j)
+            {
+                stats.col_solution[J[j]] = col_solution[j];
+            }
+            stats.I = std::move(I);
+            stats.J = std::move(J);
+
+            math::canonicalize(alpha);
+            math::canonicalize(beta);
+            stats.alpha = alpha;
+            stats.beta = beta;
+            stats.is_exact = is_exact;
+            stats.depth_solved_to = iteration.max_depth;
+
+            return {alpha, beta};
+        }
+
+        std::pair<int, Real>
+        best_response_row(
+            Iteration &iteration,
+            Types::PRNG &device,
+            const Types::State &state,
+            Types::Model &model,
+            MatrixNode *matrix_node,
+            const std::vector<int> &I,
+            const std::vector<int> &J,
+            const Real alpha, const Real beta,
+            const Types::VectorReal &col_strategy,
+            bool &is_exact) const
+        {
+            MatrixStats &stats = matrix_node->stats;
+            std::pair<int, Real> iv{-1, alpha};
+
+            // the best rows so far are scanned first, so the rest are cut off sooner
+            std::vector<int> row_order(state.row_actions.size());
+            std::iota(row_order.begin(), row_order.end(), 0);
+            std::stable_sort(
+                row_order.begin(), row_order.end(),
+                [&stats](const int a, const int b)
+                { return stats.row_values[a] > stats.row_values[b]; });
+
+            for (const int row_idx : row_order)
+            {
+                const Real value = response_row(
+                    stats.chance_data_matrix, I, J, row_idx, beta, col_strategy,
+                    explore(iteration, device, state, model, matrix_node, is_exact),
+                    [&iv]()
+                    { return iv.second; });
+                if (iteration.interrupted)
+                {
+                    return iv;
+                }
+                stats.row_values[row_idx] = value;
+                select_row(iv, row_idx, value);
+            }
+            return iv;
+        }
+
+        std::pair<int, Real>
+        best_response_col(
+            Iteration &iteration,
+            Types::PRNG &device,
+            const Types::State &state,
+            Types::Model &model,
+            MatrixNode *matrix_node,
+            const std::vector<int> &I,
+            const std::vector<int> &J,
+            const Real alpha, const Real beta,
+            const Types::VectorReal &row_strategy,
+            bool &is_exact) const
+        {
+            MatrixStats &stats = matrix_node->stats;
+            std::pair<int, Real> jv{-1, beta};
+
+            std::vector<int> col_order(state.col_actions.size());
+            std::iota(col_order.begin(), col_order.end(), 0);
+            std::stable_sort(
+                col_order.begin(), col_order.end(),
+                [&stats](const int a, const int b)
+                { return stats.col_values[a] < stats.col_values[b]; });
+
+            for (const int col_idx : col_order)
+            {
+                const Real value = response_col(
+                    stats.chance_data_matrix, I, J, col_idx, alpha, row_strategy,
+                    explore(iteration, device, state, model, matrix_node, is_exact),
+                    [&jv]()
+                    { return jv.second; });
+                if (iteration.interrupted)
+                {
+                    return jv;
+                }
+                stats.col_values[col_idx] = value;
+                select_col(jv, col_idx, value);
+            }
+            return jv;
+        }
+
+        // the explore hook of the best response scans, which ends a scan once the depth runs out of time
+        auto explore(
+            Iteration &iteration,
+            Types::PRNG &device,
+            const Types::State &state,
+            Types::Model &model,
+            MatrixNode *matrix_node,
+            bool &is_exact) const
+        {
+            return [this, &iteration, &device, &state, &model, matrix_node, &is_exact](
+                       const int row_idx, const int col_idx, Types::Prob &prob)
+            {
+                const std::pair<Real, Real> alpha_beta_pair = explore_next_branch(
+                    iteration, device, state, model, matrix_node, row_idx, col_idx, prob, is_exact);
+                if (iteration.interrupted)
+                {
+                    prob = typename Types::Prob{0};
+                }
+                return alpha_beta_pair;
+            };
+        }
+
+        // Solves the next chance branch of the entry and adds it to the entry's bounds.
+        // `prob` is the probability of the branch, or 0 if every branch was already explored
+        std::pair<Real, Real> explore_next_branch(
+            Iteration &iteration,
+            Types::PRNG &device,
+            const Types::State &state,
+            Types::Model &model,
+            MatrixNode *matrix_node,
+            const int row_idx, const int col_idx,
+            Types::Prob &prob,
+            bool &is_exact) const
+        {
+            MatrixStats &stats = matrix_node->stats;
+            Data &data = stats.chance_data_matrix.get(row_idx, col_idx);
+            const typename Types::Action row_action = state.row_actions[row_idx];
+            const typename Types::Action col_action = state.col_actions[col_idx];
+            if (data.chance_actions.size() == 0)
+            {
+                state.get_chance_actions(row_action, col_action, data.chance_actions);
+                data.chance_probs.resize(data.chance_actions.size());
+            }
+            if (data.next_chance_idx >= data.chance_actions.size())
+            {
+                prob = typename Types::Prob{0};
+                return {min_val, max_val};
+            }
+
+            const int chance_idx = data.next_chance_idx++;
+            typename Types::State state_copy = state;
+            state_copy.apply_actions(row_action, col_action, data.chance_actions[chance_idx]);
+            ChanceNode *chance_node = matrix_node->access(row_idx, col_idx);
+            MatrixNode *matrix_node_next = chance_node->access(state_copy.get_obs());
+            matrix_node_next->stats.depth = stats.depth + 1;
+            prob = state_copy.prob;
+            data.chance_probs[chance_idx] = prob;
+
+            const std::pair<Real, Real> alpha_beta_pair = double_oracle(iteration, device, state_copy, model, matrix_node_next);
+            is_exact &= matrix_node_next->stats.is_exact;
+
+            data.alpha_explored += alpha_beta_pair.first * prob;
+            data.beta_explored += alpha_beta_pair.second * prob;
+            data.unexplored -= prob;
+
+            if constexpr (std::is_same_v<Real, mpq_class>)
+            {
+                assert(data.unexplored >= Real{0});
+            }
+            return alpha_beta_pair;
+        }
+
+        inline bool try_solve_chance_node(
+            Iteration &iteration,
+            Types::PRNG &device,
+            const Types::State &state,
+            Types::Model &model,
+            MatrixNode *matrix_node,
+            const int row_idx, const int col_idx,
+            bool &is_exact) const
+        {
+            Data &data = matrix_node->stats.chance_data_matrix.get(row_idx, col_idx);
+            if (data.unexplored > typename Types::Prob{0})
+            {
+                typename Types::Prob prob;
+                do
+                {
+                    explore_next_branch(iteration, device, state, model, matrix_node, row_idx, col_idx, prob, is_exact);
+                } while (!iteration.interrupted && prob != typename Types::Prob{0});
+            }
+            return (data.alpha_explored == data.beta_explored) && (data.unexplored == Real{Rational<>{0}});
+        }
+    };
+};
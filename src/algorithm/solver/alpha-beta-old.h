@@ -59,6 +59,8 @@ struct AlphaBetaOld : Types
     };
     using MatrixNode = NodePair<Types, MatrixStats, ChanceStats>::MatrixNode;
     using ChanceNode = NodePair<Types, MatrixStats, ChanceStats>::ChanceNode;
+    // nodes that evict between descents would never evict here, since this search does not call begin_descent
+    static_assert(!IsDescentNodeTypes<NodePair<Types, MatrixStats, ChanceStats>>);
 
     class Search
     {
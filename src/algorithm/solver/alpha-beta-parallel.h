@@ -0,0 +1,501 @@
+#pragma once
+
+#include <libpinyon/task-pool.h>
+#include <algorithm/solver/alpha-beta.h>
+
+#include <memory>
+#include <mutex>
+
+/*
+
+AlphaBeta with the work of the matrix nodes near the root run as tasks on a `TaskPool`.
+
+The newly added entries of the explored sub game are expanded as one task per (row, col, chance) subgame, and both
+best responses run at the same time as one task per row and per column. The best response tasks of each player share
+their bound, so a row can be pruned by a better row that is being computed on another thread. The data, stats and
+nodes are those of `AlphaBeta`, so solved trees can be read the same way.
+
+Only matrix nodes with `depth < max_task_depth` spawn tasks, deeper nodes are solved serially by the task that reached
+them. With a single thread the search is the same as `AlphaBeta`. Otherwise the explored chance branches and the row/col
+chosen on ties can differ, but the solved values do not when the model is exact, e.g. when solving to terminal states.
+
+*/
+
+template <IsSingleModelTypes Types, template <typename...> typename NodePair = DefaultNodes>
+struct AlphaBetaParallel : AlphaBeta<Types, NodePair>
+{
+    using Real = Types::Real;
+    using Data = AlphaBeta<Types, NodePair>::Data;
+    using MatrixStats = AlphaBeta<Types, NodePair>::MatrixStats;
+    using ChanceStats = AlphaBeta<Types, NodePair>::ChanceStats;
+    using MatrixNode = AlphaBeta<Types, NodePair>::MatrixNode;
+    using ChanceNode = AlphaBeta<Types, NodePair>::ChanceNode;
+
+    class Search : public AlphaBeta<Types, NodePair>::Search
+    {
+    public:
+        using AlphaBeta<Types, NodePair>::Search::min_val;
+        using AlphaBeta<Types, NodePair>::Search::max_val;
+        using AlphaBeta<Types, NodePair>::Search::solution_cache;
+
+        std::shared_ptr<TaskPool> pool{std::make_shared<TaskPool>(1)};
+        size_t max_task_depth = 2;
+
+        Search() {}
+
+        Search(Real min_val, Real max_val, const size_t threads = 1, const size_t max_task_depth = 2)
+            : AlphaBeta<Types, NodePair>::Search{min_val, max_val},
+              pool{std::make_shared<TaskPool>(threads)},
+              max_task_depth{max_task_depth} {}
+
+        friend std::ostream &operator<<(std::ostream &os, const Search &search)
+        {
+            os << "AlphaBetaParallel(" << search.pool->size() << ")";
+            return os;
+        }
+
+        auto run(
+            const size_t max_depth,
+            Types::PRNG &device,
+            const Types::State &state,
+            Types::Model &model,
+            MatrixNode &root) const
+        {
+            auto state_copy = state;
+            return double_oracle(max_depth, device, state_copy, model, &root, min_val, max_val);
+        }
+
+        std::pair<Real, Real>
+        double_oracle(
+            const size_t max_depth,
+            Types::PRNG &device,
+            Types::State &state,
+            Types::Model &model,
+            MatrixNode *matrix_node,
+            Real alpha,
+            Real beta) const
+        {
+            if (state.is_terminal())
+            {
+                matrix_node->set_terminal();
+                const typename Types::Value payoff = state.get_payoff();
+                matrix_node->stats.solved_value = payoff;
+                return {payoff.get_row_value(), payoff.get_row_value()};
+            }
+
+            state.get_actions();
+            MatrixStats &stats = matrix_node->stats;
+
+            if (stats.depth >= max_depth)
+            {
+                matrix_node->set_terminal();
+                typename Types::ModelOutput model_output;
+                model.inference(std::move(state), model_output);
+                return {model_output.value.get_row_value(), model_output.value.get_row_value()};
+            }
+
+            const size_t rows = state.row_actions.size();
+            const size_t cols = state.col_actions.size();
+            matrix_node->expand(rows, cols);
+
+            stats.chance_data_matrix.resize(0);
+            stats.chance_data_matrix.fill(rows, cols);
+
+            const bool parallel = pool->size() > 1 && stats.depth < max_task_depth;
+            if (parallel)
+            {
+                // tasks only look up the chance nodes of this matrix node, they never insert one
+                for (int row_idx = 0; row_idx < rows; ++row_idx)
+                {
+                    for (int col_idx = 0; col_idx < cols; ++col_idx)
+                    {
+                        matrix_node->access(row_idx, col_idx);
+                    }
+                }
+            }
+
+            std::vector<int> &I = stats.I;
+            std::vector<int> &J = stats.J;
+            typename Types::VectorReal &row_solution = stats.row_solution;
+            typename Types::VectorReal &col_solution = stats.col_solution;
+
+            I.push_back(stats.row_pricipal_idx);
+            J.push_back(stats.col_pricipal_idx);
+
+            bool smaller_bounds = false;
+            bool new_action = true;
+            int latest_row_idx = stats.row_pricipal_idx;
+            int latest_col_idx = stats.col_pricipal_idx;
+            bool solved_exactly = true;
+
+            while (!fuzzy_equals(alpha, beta) && (smaller_bounds || new_action))
+            {
+                solved_exactly &= try_solve_chance_nodes(
+                    max_depth, device, state, model, matrix_node, latest_row_idx, latest_col_idx, parallel);
+
+                solve_subgame(stats.chance_data_matrix, I, J, solved_exactly, row_solution, col_solution);
+
+                const auto [iv, jv] = best_responses(
+                    max_depth, device, state, model, matrix_node, alpha, beta, row_solution, col_solution, parallel);
+
+                // prune this node if no best response is as good as alpha/beta
+                if (iv.first == -1)
+                {
+                    return {min_val, min_val};
+                }
+                if (jv.first == -1)
+                {
+                    return {max_val, max_val};
+                }
+
+                smaller_bounds = false;
+                new_action = false;
+                latest_row_idx = iv.first;
+                latest_col_idx = jv.first;
+
+                if (std::find(I.begin(), I.end(), latest_row_idx) == I.end())
+                {
+                    I.push_back(latest_row_idx);
+                    new_action = true;
+                }
+                if (std::find(J.begin(), J.end(), latest_col_idx) == J.end())
+                {
+                    J.push_back(latest_col_idx);
+                    new_action = true;
+                }
+                if (jv.second > alpha)
+                {
+                    alpha = jv.second;
+                    smaller_bounds = true;
+                }
+                if (iv.second < beta)
+                {
+                    beta = iv.second;
+                    smaller_bounds = true;
+                }
+            }
+
+            stats.row_pricipal_idx = I[std::distance(row_solution.begin(), std::max_element(row_solution.begin(), row_solution.end()))];
+            stats.col_pricipal_idx = J[std::distance(col_solution.begin(), std::max_element(col_solution.begin(), col_solution.end()))];
+
+            typename Types::VectorReal temp_strategy{};
+            temp_strategy.resize(rows);
+            for (int i = 0; i < row_solution.size(); ++i)
+            {
+                temp_strategy[I[i]] = row_solution[i];
+            }
+            row_solution = temp_strategy;
+            temp_strategy.clear();
+            temp_strategy.resize(cols);
+            for (int j = 0; j < col_solution.size(); ++j)
+            {
+                temp_strategy[J[j]] = col_solution[j];
+            }
+            col_solution = temp_strategy;
+
+            math::canonicalize(alpha);
+            math::canonicalize(beta);
+
+            return {alpha, beta};
+        }
+
+    private:
+        using AlphaBeta<Types, NodePair>::Search::fuzzy_equals;
+        using AlphaBeta<Types, NodePair>::Search::solve_subgame;
+        using AlphaBeta<Types, NodePair>::Search::response_row;
+        using AlphaBeta<Types, NodePair>::Search::response_col;
+        using AlphaBeta<Types, NodePair>::Search::select_row;
+        using AlphaBeta<Types, NodePair>::Search::select_col;
+        using AlphaBeta<Types, NodePair>::Search::explore_next_branch;
+
+        // runs the spawned calls inline, or as tasks with their own device and model
+        class Fork
+        {
+        public:
+            Fork(const Search &search, const bool parallel) : search{search}, parallel{parallel} {}
+
+            template <typename F>
+            void spawn(Types::PRNG &device, Types::Model &model, F &&f)
+            {
+                if (!parallel)
+                {
+                    f(device, model);
+                    return;
+                }
+                typename Types::PRNG task_device{device.random_seed()};
+                search.pool->submit(
+                    group,
+                    [f = std::forward<F>(f), task_device, task_model = model]() mutable
+                    { f(task_device, task_model); });
+            }
+
+            void join()
+            {
+                if (parallel)
+                {
+                    search.pool->wait(group);
+                }
+            }
+
+        private:
+            const Search &search;
+            const bool parallel;
+            TaskPool::TaskGroup group{};
+        };
+
+        class SharedBound
+        {
+        public:
+            SharedBound(const Real &value) : value{value} {}
+
+            Real get()
+            {
+                std::lock_guard<std::mutex> lock{mutex};
+                return value;
+            }
+
+            void raise(const Real &x)
+            {
+                std::lock_guard<std::mutex> lock{mutex};
+                if (x > value)
+                {
+                    value = x;
+                }
+            }
+
+            void lower(const Real &x)
+            {
+                std::lock_guard<std::mutex> lock{mutex};
+                if (x < value)
+                {
+                    value = x;
+                }
+            }
+
+        private:
+            std::mutex mutex{};
+            Real value;
+        };
+
+        struct Subgame
+        {
+            Types::State state;
+            MatrixNode *matrix_node;
+            Data *data;
+            Types::Prob prob;
+            std::pair<Real, Real> alpha_beta{};
+        };
+
+        /*
+        Explores the entries {I x latest_col} and {latest_row x J} in the same order as AlphaBeta.
+        The subgames are created serially, solved as tasks, and their values are added in order.
+        */
+        bool try_solve_chance_nodes(
+            const size_t max_depth,
+            Types::PRNG &device,
+            const Types::State &state,
+            Types::Model &model,
+            MatrixNode *matrix_node,
+            const int latest_row_idx, const int latest_col_idx,
+            const bool parallel) const
+        {
+            MatrixStats &stats = matrix_node->stats;
+            std::vector<std::pair<int, int>> entries{};
+            for (const int row_idx : stats.I)
+            {
+                entries.emplace_back(row_idx, latest_col_idx);
+            }
+            for (const int col_idx : stats.J)
+            {
+                if (col_idx != latest_col_idx)
+                {
+                    entries.emplace_back(latest_row_idx, col_idx);
+                }
+            }
+
+            std::vector<Subgame> subgames{};
+            for (const auto [row_idx, col_idx] : entries)
+            {
+                ChanceNode *chance_node = matrix_node->access(row_idx, col_idx);
+                Data &data = stats.chance_data_matrix.get(row_idx, col_idx);
+                if (!(data.unexplored > typename Types::Prob{0}))
+                {
+                    continue;
+                }
+                const auto row_action = state.row_actions[row_idx];
+                const auto col_action = state.col_actions[col_idx];
+                if (data.chance_actions.size() == 0)
+                {
+                    state.get_chance_actions(row_action, col_action, data.chance_actions);
+                }
+                for (; data.next_chance_idx < data.chance_actions.size(); ++data.next_chance_idx)
+                {
+                    typename Types::State state_copy = state;
+                    state_copy.apply_actions(row_action, col_action, data.chance_actions[data.next_chance_idx]);
+                    MatrixNode *matrix_node_next = chance_node->access(state_copy.get_obs());
+                    matrix_node_next->stats.depth = stats.depth + 1;
+                    const typename Types::Prob prob = state_copy.prob;
+                    subgames.push_back({std::move(state_copy), matrix_node_next, &data, prob});
+                }
+            }
+
+            Fork fork{*this, parallel};
+            if (!parallel)
+            {
+                for (Subgame &subgame : subgames)
+                {
+                    subgame.alpha_beta = double_oracle(
+                        max_depth, device, subgame.state, model, subgame.matrix_node, min_val, max_val);
+                }
+            }
+            else
+            {
+                // subgames that reach the same matrix node are solved in order by one task
+                std::vector<std::vector<Subgame *>> tasks{};
+                for (Subgame &subgame : subgames)
+                {
+                    auto task = std::find_if(
+                        tasks.begin(), tasks.end(),
+                        [&subgame](const auto &task)
+                        { return task.front()->matrix_node == subgame.matrix_node; });
+                    if (task == tasks.end())
+                    {
+                        tasks.push_back({&subgame});
+                    }
+                    else
+                    {
+                        task->push_back(&subgame);
+                    }
+                }
+                for (const auto &task : tasks)
+                {
+                    fork.spawn(
+                        device, model,
+                        [this, max_depth, task](Types::PRNG &device, Types::Model &model)
+                        {
+                            for (Subgame *subgame : task)
+                            {
+                                subgame->alpha_beta = double_oracle(
+                                    max_depth, device, subgame->state, model, subgame->matrix_node, min_val, max_val);
+                            }
+                        });
+                }
+                fork.join();
+            }
+
+            for (const Subgame &subgame : subgames)
+            {
+                Data &data = *subgame.data;
+                data.alpha_explored += subgame.alpha_beta.first * subgame.prob;
+                data.beta_explored += subgame.alpha_beta.second * subgame.prob;
+                data.unexplored -= subgame.prob;
+            }
+
+            bool solved_exactly = true;
+            for (const auto [row_idx, col_idx] : entries)
+            {
+                const Data &data = stats.chance_data_matrix.get(row_idx, col_idx);
+                solved_exactly &= (data.alpha_explored == data.beta_explored) && (data.unexplored == Real{Rational<>{0}});
+            }
+            return solved_exactly;
+        }
+
+        /*
+        Rows and columns only explore the entries {row x J} and {I x col} outside of the explored sub game,
+        so every response can be computed by its own task.
+        The ordered scan afterwards selects the response the same way the serial loop does.
+        */
+        std::pair<std::pair<int, Real>, std::pair<int, Real>>
+        best_responses(
+            const size_t max_depth,
+            Types::PRNG &device,
+            const Types::State &state,
+            Types::Model &model,
+            MatrixNode *matrix_node,
+            const Real alpha, const Real beta,
+            const Types::VectorReal &row_strategy,
+            const Types::VectorReal &col_strategy,
+            const bool parallel) const
+        {
+            const size_t rows = state.row_actions.size();
+            const size_t cols = state.col_actions.size();
+            MatrixStats &stats = matrix_node->stats;
+            std::vector<Real> row_values(rows), col_values(cols);
+            std::pair<int, Real> iv{-1, alpha}, jv{-1, beta};
+
+            // the children are solved with the device and model of the task that reaches them
+            const auto explore = [this, max_depth, &state, matrix_node](Types::PRNG &device, Types::Model &model)
+            {
+                return [this, max_depth, &state, matrix_node, &device, &model](
+                           const int row_idx, const int col_idx, Types::Prob &prob)
+                {
+                    return explore_next_branch(
+                        state, matrix_node, row_idx, col_idx, prob,
+                        [this, max_depth, &device, &model](Types::State &state_next, MatrixNode *matrix_node_next)
+                        { return double_oracle(max_depth, device, state_next, model, matrix_node_next, min_val, max_val); });
+                };
+            };
+
+            if (!parallel)
+            {
+                for (int row_idx = 0; row_idx < rows; ++row_idx)
+                {
+                    row_values[row_idx] = response_row(
+                        stats.chance_data_matrix, stats.I, stats.J, row_idx, max_val, col_strategy, explore(device, model),
+                        [&iv]()
+                        { return iv.second; });
+                    select_row(iv, row_idx, row_values[row_idx]);
+                }
+                for (int col_idx = 0; col_idx < cols; ++col_idx)
+                {
+                    col_values[col_idx] = response_col(
+                        stats.chance_data_matrix, stats.I, stats.J, col_idx, min_val, row_strategy, explore(device, model),
+                        [&jv]()
+                        { return jv.second; });
+                    select_col(jv, col_idx, col_values[col_idx]);
+                }
+                return {iv, jv};
+            }
+
+            SharedBound row_bound{alpha}, col_bound{beta};
+            Fork fork{*this, parallel};
+            for (int row_idx = 0; row_idx < rows; ++row_idx)
+            {
+                fork.spawn(
+                    device, model,
+                    [&, row_idx](Types::PRNG &device, Types::Model &model)
+                    {
+                        row_values[row_idx] = response_row(
+                            stats.chance_data_matrix, stats.I, stats.J, row_idx, max_val, col_strategy, explore(device, model),
+                            [&row_bound]()
+                            { return row_bound.get(); });
+                        row_bound.raise(row_values[row_idx]);
+                    });
+            }
+            for (int col_idx = 0; col_idx < cols; ++col_idx)
+            {
+                fork.spawn(
+                    device, model,
+                    [&, col_idx](Types::PRNG &device, Types::Model &model)
+                    {
+                        col_values[col_idx] = response_col(
+                            stats.chance_data_matrix, stats.I, stats.J, col_idx, min_val, row_strategy, explore(device, model),
+                            [&col_bound]()
+                            { return col_bound.get(); });
+                        col_bound.lower(col_values[col_idx]);
+                    });
+            }
+            fork.join();
+
+            for (int row_idx = 0; row_idx < rows; ++row_idx)
+            {
+                select_row(iv, row_idx, row_values[row_idx]);
+            }
+            for (int col_idx = 0; col_idx < cols; ++col_idx)
+            {
+                select_col(jv, col_idx, col_values[col_idx]);
+            }
+            return {iv, jv};
+        }
+    };
+};
@@ -2,6 +2,7 @@
 
 #include <libpinyon/math.h>
 #include <libpinyon/lrslib.h>
+#include <libpinyon/solution-cache.h>
 #include <types/matrix.h>
 #include <algorithm/algorithm.h>
 #include <tree/tree.h>
@@ -47,6 +48,8 @@ struct AlphaBeta : Types
     };
     using MatrixNode = NodePair<Types, MatrixStats, ChanceStats>::MatrixNode;
     using ChanceNode = NodePair<Types, MatrixStats, ChanceStats>::ChanceNode;
+    // nodes that evict between descents would never evict here, since this search does not call begin_descent
+    static_assert(!IsDescentNodeTypes<NodePair<Types, MatrixStats, ChanceStats>>);
 
     class Search
     {
@@ -59,6 +62,9 @@ struct AlphaBeta : Types
         const Real min_val{0}; // don't need to use the Game values if you happen to know that State's
         const Real max_val{1};
 
+        // shared by searches and threads, see libpinyon/solution-cache.h
+        std::shared_ptr<SolutionCache<Types>> solution_cache{};
+
         Search() {}
 
         Search(Real min_val, Real max_val) : min_val{min_val}, max_val{max_val} {}
@@ -145,40 +151,7 @@ struct AlphaBeta : Types
                 }
 
                 // solve newly expanded and explored game
-
-                int entry_idx = 0;
-                if (solved_exactly)
-                {
-                    typename Types::MatrixValue matrix{I.size(), J.size()};
-                    for (auto row_idx : I)
-                    {
-                        for (auto col_idx : J)
-                        {
-                            const Data &data = stats.chance_data_matrix.get(row_idx, col_idx);
-                            matrix[entry_idx] = data.alpha_explored;
-                            ++entry_idx;
-                        }
-                    }
-                    LRSNash::solve(matrix, row_solution, col_solution);
-                }
-                else
-                {
-                    typename Types::MatrixValue alpha_matrix{I.size(), J.size()}, beta_matrix{I.size(), J.size()};
-                    for (auto row_idx : I)
-                    {
-                        for (auto col_idx : J)
-                        {
-                            const Data &data = stats.chance_data_matrix.get(row_idx, col_idx);
-                            alpha_matrix[entry_idx] = static_cast<Real>(data.alpha_explored + data.unexplored * min_val);
-                            beta_matrix[entry_idx] = static_cast<Real>(data.beta_explored + data.unexplored * max_val);
-                            ++entry_idx;
-                        }
-                    }
-                    typename Types::VectorReal temp;
-                    LRSNash::solve(alpha_matrix, row_solution, temp);
-                    temp.clear();
-                    LRSNash::solve(beta_matrix, temp, col_solution);
-                }
+                solve_subgame(stats.chance_data_matrix, I, J, solved_exactly, row_solution, col_solution);
 
                 std::pair<int, Real>
                     iv = best_response_row(
@@ -272,107 +245,21 @@ struct AlphaBeta : Types
             const Real alpha, const Real beta,
             const Types::VectorReal &col_strategy) const
         {
-            Real best_response{alpha};
             MatrixStats &stats = matrix_node->stats;
-            std::vector<int> &I = stats.I;
-            std::vector<int> &J = stats.J;
-            int best_row_idx = -1;
-
+            const auto solve = [&](Types::State &state_next, MatrixNode *matrix_node_next)
+            { return double_oracle(max_depth, device, state_next, model, matrix_node_next, min_val, max_val); };
+            std::pair<int, Real> iv{-1, alpha};
             for (int row_idx = 0; row_idx < state.row_actions.size(); ++row_idx)
             {
-                bool skip_exploration = (std::find(I.begin(), I.end(), row_idx) != I.end());
-                const typename Types::Action row_action = state.row_actions[row_idx];
-
-                Real max_priority{0}, expected_value{0}, total_unexplored{0};
-                std::vector<Real> exploration_priorities;
-                int col_idx, next_j;
-                for (int j = 0; j < J.size(); ++j)
-                {
-                    const int col_idx_temp = J[j];
-                    Data &data = stats.chance_data_matrix.get(row_idx, col_idx_temp);
-                    // we still have to calculate expected score to return -1 if pruning is called for
-                    expected_value += col_strategy[j] * data.beta_explored;
-
-                    const Real priority =
-                        skip_exploration
-                            ? Real{0}
-                            : Real{col_strategy[j] * data.unexplored};
-                    total_unexplored += col_strategy[j] * data.unexplored;
-                    exploration_priorities.push_back(priority);
-                    if (priority > max_priority)
-                    {
-                        col_idx = col_idx_temp;
-                        max_priority = priority;
-                        next_j = j;
-                    }
-                }
-
-                while (
-                    (max_priority > Real{Rational<>{0}}) &&
-                    (Real{expected_value + beta * total_unexplored} >= best_response))
-                {
-                    Data &data = stats.chance_data_matrix.get(row_idx, col_idx);
-                    const typename Types::Action col_action = state.col_actions[col_idx];
-                    if (data.chance_actions.size() == 0)
-                    {
-                        state.get_chance_actions(row_action, col_action, data.chance_actions);
-                    }
-                    if (data.next_chance_idx >= data.chance_actions.size())
-                    {
-                        break;
-                    }
-                    typename Types::State state_copy = state;
-                    state_copy.apply_actions(row_action, col_action, data.chance_actions[data.next_chance_idx++]);
-                    ChanceNode *chance_node = matrix_node->access(row_idx, col_idx);
-                    MatrixNode *matrix_node_next = chance_node->access(state_copy.get_obs());
-                    matrix_node_next->stats.depth = stats.depth + 1;
-                    const typename Types::Prob prob = state_copy.prob;
-
-                    auto alpha_beta_pair = double_oracle(
-                        max_depth,
-                        device,
-                        state_copy,
-                        model,
-                        matrix_node_next,
-                        min_val, max_val);
-
-                    data.alpha_explored += alpha_beta_pair.first * prob;
-                    data.beta_explored += alpha_beta_pair.second * prob;
-                    expected_value += alpha_beta_pair.second * prob * col_strategy[next_j];
-
-                    data.unexplored -= prob;
-                    total_unexplored -= prob * col_strategy[next_j];
-                    exploration_priorities[next_j] -= prob * col_strategy[next_j];
-
-                    if constexpr (std::is_same_v<Real, mpq_class>)
-                    {
-                        assert(data.unexplored >= Real{0});
-                        assert(total_unexplored >= Real{0});
-                    }
-
-                    max_priority = typename Types::Prob{typename Types::Q{0}};
-                    for (int j = 0; j < J.size(); ++j)
-                    {
-                        const Real priority = exploration_priorities[j];
-                        if (priority > max_priority)
-                        {
-                            col_idx = J[j];
-                            max_priority = priority;
-                            next_j = j;
-                        }
-                    }
-                }
-
-                expected_value += total_unexplored * beta;
-                math::canonicalize(expected_value);
-
-                if (expected_value >= best_response || (best_row_idx == -1 && fuzzy_equals(expected_value, best_response)))
-                {
-                    best_row_idx = row_idx;
-                    best_response = expected_value;
-                }
+                const Real value = response_row(
+                    stats.chance_data_matrix, stats.I, stats.J, row_idx, beta, col_strategy,
+                    [&](const int row_idx, const int col_idx, Types::Prob &prob)
+                    { return explore_next_branch(state, matrix_node, row_idx, col_idx, prob, solve); },
+                    [&iv]()
+                    { return iv.second; });
+                select_row(iv, row_idx, value);
             }
-            return {best_row_idx, best_response};
+            return iv;
         }
 
         std::pair<int, Real> best_response_col(
@@ -384,144 +271,332 @@ struct AlphaBeta : Types
             const Real alpha, const Real beta,
             const Types::VectorReal &row_strategy) const
         {
-            Real best_response{beta};
             MatrixStats &stats = matrix_node->stats;
-            std::vector<int> &I = stats.I;
-            std::vector<int> &J = stats.J;
-            int best_col_idx = -1;
-
+            const auto solve = [&](Types::State &state_next, MatrixNode *matrix_node_next)
+            { return double_oracle(max_depth, device, state_next, model, matrix_node_next, min_val, max_val); };
+            std::pair<int, Real> jv{-1, beta};
             for (int col_idx = 0; col_idx < state.col_actions.size(); ++col_idx)
             {
-                bool skip_exploration = (std::find(J.begin(), J.end(), col_idx) != J.end());
-                const typename Types::Action col_action = state.col_actions[col_idx];
+                const Real value = response_col(
+                    stats.chance_data_matrix, stats.I, stats.J, col_idx, alpha, row_strategy,
+                    [&](const int row_idx, const int col_idx, Types::Prob &prob)
+                    { return explore_next_branch(state, matrix_node, row_idx, col_idx, prob, solve); },
+                    [&jv]()
+                    { return jv.second; });
+                select_col(jv, col_idx, value);
+            }
+            return jv;
+        }
 
-                Real max_priority{0}, expected_value{0}, total_unexplored{0};
-                std::vector<Real> exploration_priorities;
-                int row_idx, next_i;
-                for (int i = 0; i < I.size(); ++i)
-                {
-                    const int row_idx_temp = I[i];
-                    Data &data = stats.chance_data_matrix.get(row_idx_temp, col_idx);
-                    expected_value += row_strategy[i] * data.alpha_explored;
+    protected:
+        /*
+        Shared with AlphaBetaParallel and AlphaBetaIter, whose data matrices and explored subgames (I, J) are their
+        own. The recursion into a child and the bound a response has to beat are hooks, so each search can solve
+        children its own way and share the bound between tasks.
+        */
 
-                    const Real priority =
-                        skip_exploration
-                            ? Real{0}
-                            : Real{row_strategy[i] * data.unexplored};
+        template <typename T>
+        static bool fuzzy_equals(T x, T y)
+        {
+            if constexpr (std::is_same_v<T, mpq_class>)
+            {
+                math::canonicalize(x);
+                math::canonicalize(y);
+                return x == y;
+            }
+            else
+            {
+                static const Real epsilon{Rational{1, 1 << 24}};
+                static const Real neg_epsilon{Rational{-1, 1 << 24}};
+                T z{x - y};
+                return neg_epsilon < z && z < epsilon;
+            }
+        }
 
-                    total_unexplored += row_strategy[i] * data.unexplored;
-                    exploration_priorities.push_back(priority);
-                    if (priority > max_priority)
+        template <typename T>
+        static bool fuzzy_greater(T x, T y)
+        {
+            if constexpr (std::is_same_v<T, mpq_class>)
+            {
+                return x > y;
+            }
+            else
+            {
+                static const Real epsilon{Rational{1, 1 << 24}};
+                return x > y + epsilon;
+            }
+        }
+
+        // Solves the explored subgame for both strategies. If an entry is not solved exactly, the row strategy
+        // is solved on the lower bounds and the col strategy on the upper bounds
+        template <typename DataMatrix>
+        void solve_subgame(
+            DataMatrix &data_matrix,
+            const std::vector<int> &I,
+            const std::vector<int> &J,
+            const bool solved_exactly,
+            Types::VectorReal &row_solution,
+            Types::VectorReal &col_solution) const
+        {
+            int entry_idx = 0;
+            if (solved_exactly)
+            {
+                // scratch matrices are reused across calls; they are only read before the next recursion
+                thread_local typename Types::MatrixValue matrix{};
+                matrix.fill(I.size(), J.size());
+                for (auto row_idx : I)
+                {
+                    for (auto col_idx : J)
                     {
-                        row_idx = row_idx_temp;
-                        max_priority = priority;
-                        next_i = i;
+                        const auto &data = data_matrix.get(row_idx, col_idx);
+                        matrix[entry_idx] = data.alpha_explored;
+                        ++entry_idx;
                     }
                 }
-
-                while (
-                    fuzzy_greater(total_unexplored, Real{Rational<>{0}}) &&
-                    (Real{expected_value + alpha * total_unexplored} <= best_response))
+                LRSNash::solve(solution_cache.get(), matrix, row_solution, col_solution);
+            }
+            else
+            {
+                thread_local typename Types::MatrixValue alpha_matrix{}, beta_matrix{};
+                alpha_matrix.fill(I.size(), J.size());
+                beta_matrix.fill(I.size(), J.size());
+                for (auto row_idx : I)
                 {
-                    Data &data = stats.chance_data_matrix.get(row_idx, col_idx);
-                    const typename Types::Action row_action = state.row_actions[row_idx];
-                    if (data.chance_actions.size() == 0)
+                    for (auto col_idx : J)
                     {
-                        state.get_chance_actions(row_action, col_action, data.chance_actions);
+                        const auto &data = data_matrix.get(row_idx, col_idx);
+                        alpha_matrix[entry_idx] = static_cast<Real>(data.alpha_explored + data.unexplored * min_val);
+                        beta_matrix[entry_idx] = static_cast<Real>(data.beta_explored + data.unexplored * max_val);
+                        ++entry_idx;
                     }
+                }
+                thread_local typename Types::VectorReal temp{};
+                LRSNash::solve(solution_cache.get(), alpha_matrix, row_solution, temp);
+                temp.clear();
+                LRSNash::solve(solution_cache.get(), beta_matrix, temp, col_solution);
+            }
+        }
 
-                    if (data.next_chance_idx >= data.chance_actions.size())
-                    {
-                        break;
-                    }
-                    typename Types::State state_copy = state;
-                    state_copy.apply_actions(row_action, col_action, data.chance_actions[data.next_chance_idx++]);
-                    ChanceNode *chance_node = matrix_node->access(row_idx, col_idx);
-                    MatrixNode *matrix_node_next = chance_node->access(state_copy.get_obs());
-                    matrix_node_next->stats.depth = stats.depth + 1;
-                    const typename Types::Prob prob = state_copy.prob;
+        /*
+        The value of `row_idx` against `col_strategy`, which is over the columns `J`. Unless the row is in `I`, the
+        branches of its entries are explored, most probable first, while the value can still reach the bound hook
+        `best_response()`. Unexplored probability is worth `beta`.
+        `explore(row_idx, col_idx, prob)` solves the next branch of an entry and returns its bounds. It sets `prob` to
+        the probability of the branch, or to 0 to end the scan.
+        */
+        template <typename DataMatrix, typename Explore, typename Bound>
+        Real response_row(
+            DataMatrix &data_matrix,
+            const std::vector<int> &I,
+            const std::vector<int> &J,
+            const int row_idx,
+            const Real beta,
+            const Types::VectorReal &col_strategy,
+            const Explore &explore,
+            const Bound &best_response) const
+        {
+            bool skip_exploration = (std::find(I.begin(), I.end(), row_idx) != I.end());
 
-                    auto alpha_beta_pair = double_oracle(
-                        max_depth,
-                        device,
-                        state_copy,
-                        model,
-                        matrix_node_next,
-                        min_val, max_val);
+            Real max_priority{0}, expected_value{0}, total_unexplored{0};
+            std::vector<Real> exploration_priorities;
+            int col_idx, next_j;
+            for (int j = 0; j < J.size(); ++j)
+            {
+                const int col_idx_temp = J[j];
+                const auto &data = data_matrix.get(row_idx, col_idx_temp);
+                // we still have to calculate expected score to return -1 if pruning is called for
+                expected_value += col_strategy[j] * data.beta_explored;
+
+                const Real priority =
+                    skip_exploration
+                        ? Real{0}
+                        : Real{col_strategy[j] * data.unexplored};
+                total_unexplored += col_strategy[j] * data.unexplored;
+                exploration_priorities.push_back(priority);
+                if (priority > max_priority)
+                {
+                    col_idx = col_idx_temp;
+                    max_priority = priority;
+                    next_j = j;
+                }
+            }
 
-                    data.alpha_explored += alpha_beta_pair.first * prob;
-                    data.beta_explored += alpha_beta_pair.second * prob;
-                    expected_value += alpha_beta_pair.first * prob * row_strategy[next_i];
+            while (
+                (max_priority > Real{Rational<>{0}}) &&
+                (Real{expected_value + beta * total_unexplored} >= best_response()))
+            {
+                typename Types::Prob prob;
+                const std::pair<Real, Real> alpha_beta_pair = explore(row_idx, col_idx, prob);
+                if (prob == typename Types::Prob{0})
+                {
+                    break;
+                }
 
-                    data.unexplored -= prob;
-                    total_unexplored -= prob * row_strategy[next_i];
-                    exploration_priorities[next_i] -= prob * row_strategy[next_i];
+                expected_value += alpha_beta_pair.second * prob * col_strategy[next_j];
+                total_unexplored -= prob * col_strategy[next_j];
+                exploration_priorities[next_j] -= prob * col_strategy[next_j];
 
-                    if constexpr (std::is_same_v<Real, mpq_class>)
-                    {
-                        assert(data.unexplored >= Real{0});
-                        assert(total_unexplored >= Real{0});
-                    }
+                if constexpr (std::is_same_v<Real, mpq_class>)
+                {
+                    assert(total_unexplored >= Real{0});
+                }
 
-                    max_priority = Real{Rational<>{0}};
-                    for (int i = 0; i < I.size(); ++i)
+                max_priority = typename Types::Prob{typename Types::Q{0}};
+                for (int j = 0; j < J.size(); ++j)
+                {
+                    const Real priority = exploration_priorities[j];
+                    if (priority > max_priority)
                     {
-                        const Real priority = exploration_priorities[i];
-                        if (priority > max_priority)
-                        {
-                            row_idx = I[i];
-                            max_priority = priority;
-                            next_i = i;
-                        }
+                        col_idx = J[j];
+                        max_priority = priority;
+                        next_j = j;
                     }
                 }
+            }
+
+            expected_value += total_unexplored * beta;
+            math::canonicalize(expected_value);
+            return expected_value;
+        }
+
+        // as `response_row`, for the col player. Unexplored probability is worth `alpha`
+        template <typename DataMatrix, typename Explore, typename Bound>
+        Real response_col(
+            DataMatrix &data_matrix,
+            const std::vector<int> &I,
+            const std::vector<int> &J,
+            const int col_idx,
+            const Real alpha,
+            const Types::VectorReal &row_strategy,
+            const Explore &explore,
+            const Bound &best_response) const
+        {
+            bool skip_exploration = (std::find(J.begin(), J.end(), col_idx) != J.end());
+
+            Real max_priority{0}, expected_value{0}, total_unexplored{0};
+            std::vector<Real> exploration_priorities;
+            int row_idx, next_i;
+            for (int i = 0; i < I.size(); ++i)
+            {
+                const int row_idx_temp = I[i];
+                const auto &data = data_matrix.get(row_idx_temp, col_idx);
+                expected_value += row_strategy[i] * data.alpha_explored;
+
+                const Real priority =
+                    skip_exploration
+                        ? Real{0}
+                        : Real{row_strategy[i] * data.unexplored};
+
+                total_unexplored += row_strategy[i] * data.unexplored;
+                exploration_priorities.push_back(priority);
+                if (priority > max_priority)
+                {
+                    row_idx = row_idx_temp;
+                    max_priority = priority;
+                    next_i = i;
+                }
+            }
+
+            while (
+                fuzzy_greater(total_unexplored, Real{Rational<>{0}}) &&
+                (Real{expected_value + alpha * total_unexplored} <= best_response()))
+            {
+                typename Types::Prob prob;
+                const std::pair<Real, Real> alpha_beta_pair = explore(row_idx, col_idx, prob);
+                if (prob == typename Types::Prob{0})
+                {
+                    break;
+                }
 
-                expected_value += total_unexplored * alpha;
-                math::canonicalize(expected_value);
+                expected_value += alpha_beta_pair.first * prob * row_strategy[next_i];
+                total_unexplored -= prob * row_strategy[next_i];
+                exploration_priorities[next_i] -= prob * row_strategy[next_i];
 
-                if (expected_value <= best_response || (best_col_idx == -1 && fuzzy_equals(expected_value, best_response)))
+                if constexpr (std::is_same_v<Real, mpq_class>)
                 {
-                    best_col_idx = col_idx;
-                    best_response = expected_value;
+                    assert(total_unexplored >= Real{0});
+                }
+
+                max_priority = Real{Rational<>{0}};
+                for (int i = 0; i < I.size(); ++i)
+                {
+                    const Real priority = exploration_priorities[i];
+                    if (priority > max_priority)
+                    {
+                        row_idx = I[i];
+                        max_priority = priority;
+                        next_i = i;
+                    }
                 }
             }
-            return {best_col_idx, best_response};
+
+            expected_value += total_unexplored * alpha;
+            math::canonicalize(expected_value);
+            return expected_value;
         }
 
-    private:
-        template <typename T>
-        inline bool fuzzy_equals(T x, T y) const
+        // Solves the next chance branch of the entry with `solve(state, matrix_node)` and adds it to the entry's
+        // bounds. `prob` is the probability of the branch, or 0 if every branch was already explored
+        template <typename Solve>
+        std::pair<Real, Real> explore_next_branch(
+            const Types::State &state,
+            MatrixNode *matrix_node,
+            const int row_idx, const int col_idx,
+            Types::Prob &prob,
+            const Solve &solve) const
         {
-            if constexpr (std::is_same_v<T, mpq_class>)
+            MatrixStats &stats = matrix_node->stats;
+            Data &data = stats.chance_data_matrix.get(row_idx, col_idx);
+            const typename Types::Action row_action = state.row_actions[row_idx];
+            const typename Types::Action col_action = state.col_actions[col_idx];
+            if (data.chance_actions.size() == 0)
             {
-                math::canonicalize(x);
-                math::canonicalize(y);
-                return x == y;
+                state.get_chance_actions(row_action, col_action, data.chance_actions);
             }
-            else
+            if (data.next_chance_idx >= data.chance_actions.size())
             {
-                static const Real epsilon{Rational{1, 1 << 24}};
-                static const Real neg_epsilon{Rational{-1, 1 << 24}};
-                T z{x - y};
-                return neg_epsilon < z && z < epsilon;
+                prob = typename Types::Prob{0};
+                return {min_val, max_val};
+            }
+            typename Types::State state_copy = state;
+            state_copy.apply_actions(row_action, col_action, data.chance_actions[data.next_chance_idx++]);
+            ChanceNode *chance_node = matrix_node->access(row_idx, col_idx);
+            MatrixNode *matrix_node_next = chance_node->access(state_copy.get_obs());
+            matrix_node_next->stats.depth = stats.depth + 1;
+            prob = state_copy.prob;
+
+            const std::pair<Real, Real> alpha_beta_pair = solve(state_copy, matrix_node_next);
+
+            data.alpha_explored += alpha_beta_pair.first * prob;
+            data.beta_explored += alpha_beta_pair.second * prob;
+            data.unexplored -= prob;
+
+            if constexpr (std::is_same_v<Real, mpq_class>)
+            {
+                assert(data.unexplored >= Real{0});
             }
+            return alpha_beta_pair;
         }
 
-        template <typename T>
-        inline bool fuzzy_greater(T x, T y) const
+        // keeps the best row so far in `iv`. Ties go to the later row, and the first row within rounding of the
+        // bound is taken, so a pruned node still has a response
+        void select_row(std::pair<int, Real> &iv, const int row_idx, const Real &value) const
         {
-            if constexpr (std::is_same_v<T, mpq_class>)
+            if (value >= iv.second || (iv.first == -1 && fuzzy_equals(value, iv.second)))
             {
-                return x > y;
+                iv = {row_idx, value};
             }
-            else
+        }
+
+        void select_col(std::pair<int, Real> &jv, const int col_idx, const Real &value) const
+        {
+            if (value <= jv.second || (jv.first == -1 && fuzzy_equals(value, jv.second)))
             {
-                static const Real epsilon{Rational{1, 1 << 24}};
-                bool a = x > y + epsilon;
-                return a;
+                jv = {col_idx, value};
             }
         }
 
+    private:
         inline bool try_solve_chance_node(
             const size_t max_depth,
             Types::PRNG &device,
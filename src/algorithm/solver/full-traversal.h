@@ -1,13 +1,14 @@
 #pragma once
 
 #include <libpinyon/lrslib.h>
+#include <libpinyon/task-pool.h>
 #include <model/model.h>
 #include <tree/tree.h>
 #include <algorithm/algorithm.h>
 
 #include <string>
 #include <cassert>
-#include <thread>
+#include <atomic>
 
 /*
     This algorithm expands a node into a tree that is one-to-one with the abstract game tree
@@ -15,6 +16,10 @@
 
     The tree that is generated by this algorithm can then be wrapped in a TraversedState,
     which is a way of turning any StateChance into a SolvedState
+
+    With `threads > 1` the subtrees of matrix nodes with `depth < max_task_depth` are solved as tasks on a TaskPool,
+    and deeper subtrees are solved serially by the task that reached them. A matrix node is claimed by the first
+    call that expands it, so it is expanded and solved once, as soon as its own children are solved.
 */
 
 template <
@@ -26,31 +31,34 @@ struct FullTraversal : Types
     struct MatrixStats
     {
         Types::Value payoff{};
-         Types::VectorReal row_solution, col_solution;
-         Types::MatrixValue nash_payoff_matrix;
+        Types::VectorReal row_solution, col_solution;
+        Types::MatrixValue nash_payoff_matrix;
 
         size_t matrix_node_count = 1;
         unsigned int depth{};
-         Types::Prob prob;
+        Types::Prob prob;
 
-         Types::Mutex mutex{};
-        bool is_expanded = false;
+        std::atomic<bool> claimed{false};
     };
     struct ChanceStats
     {
         std::vector<typename Types::Obs> chance_actions;
         std::vector<typename Types::Prob> chance_strategy;
-        Types::Mutex mutex{};
-        bool is_solved{false};
     };
     using MatrixNode = typename NodePair<Types, MatrixStats, ChanceStats>::MatrixNode;
     using ChanceNode = typename NodePair<Types, MatrixStats, ChanceStats>::ChanceNode;
+    // nodes that evict between descents would never evict here, since this search does not call begin_descent
+    static_assert(!IsDescentNodeTypes<NodePair<Types, MatrixStats, ChanceStats>>);
 
     class Search
     {
     public:
+        size_t max_task_depth = 2;
+
         Search() {}
 
+        Search(const size_t max_task_depth) : max_task_depth{max_task_depth} {}
+
         std::pair<typename Types::Real, typename Types::Real>
         run(
             const size_t max_depth,
@@ -61,16 +69,8 @@ struct FullTraversal : Types
             const size_t threads = 1) const
         {
             auto state_ = state;
-            std::thread thread_pool[threads];
-            for (int i = 0; i < threads; ++i)
-            {
-                thread_pool[i] = std::thread(
-                    &Search::run_, this, max_depth, &state_, &model, &matrix_node);
-            }
-            for (int i = 0; i < threads; ++i)
-            {
-                thread_pool[i].join();
-            }
+            TaskPool pool{threads};
+            run_(max_depth, &state_, &model, &matrix_node, &pool);
             return {matrix_node.stats.payoff.get_row_value(), matrix_node.stats.payoff.get_row_value()};
         }
 
@@ -91,7 +91,8 @@ struct FullTraversal : Types
             const size_t max_depth,
             Types::State *state_ptr,
             Types::Model *model_ptr,
-            MatrixNode *matrix_node) const
+            MatrixNode *matrix_node,
+            TaskPool *pool = nullptr) const
         {
             typename Types::State &state = *state_ptr;
             typename Types::Model &model = *model_ptr;
@@ -118,12 +119,23 @@ struct FullTraversal : Types
                 return;
             }
 
-            stats.mutex.lock();
-            if (!stats.is_expanded)
+            // only the call that claims the node expands and solves it
+            if (stats.claimed.exchange(true))
+            {
+                return;
+            }
+
+            stats.nash_payoff_matrix.fill(rows, cols);
+            stats.row_solution.resize(rows);
+            stats.col_solution.resize(cols);
+
+            if (pool != nullptr && pool->size() > 1 && stats.depth < max_task_depth)
+            {
+                run_tasks(max_depth, state, model, matrix_node, *pool);
+            }
+            else
             {
-                stats.nash_payoff_matrix.fill(rows, cols);
-                stats.row_solution.resize(rows);
-                stats.col_solution.resize(cols);
+                // recurse
                 for (int row_idx = 0; row_idx < rows; ++row_idx)
                 {
                     for (int col_idx = 0; col_idx < cols; ++col_idx)
@@ -132,13 +144,59 @@ struct FullTraversal : Types
                         const typename Types::Action &col_action{state.col_actions[col_idx]};
 
                         ChanceNode *chance_node = matrix_node->access(row_idx, col_idx);
+
+                        auto &chance_actions = chance_node->stats.chance_actions;
+                        state.get_chance_actions(row_action, col_action, chance_actions);
+
+                        for (auto chance_action : chance_actions)
+                        {
+                            typename Types::State state_copy = state;
+                            state_copy.apply_actions(row_action, col_action, chance_action);
+                            MatrixNode *matrix_node_next = chance_node->access(state_copy.get_obs());
+                            assert(state_copy.get_obs() == chance_action);
+                            matrix_node_next->stats.depth = stats.depth + 1;
+                            matrix_node_next->stats.prob = state_copy.prob;
+                            chance_node->stats.chance_strategy.push_back(state_copy.prob);
+
+                            run_(max_depth, &state_copy, model_ptr, matrix_node_next, pool);
+
+                            stats.nash_payoff_matrix.get(row_idx, col_idx) +=
+                                matrix_node_next->stats.payoff *
+                                typename Types::Real{matrix_node_next->stats.prob};
+                            stats.matrix_node_count += matrix_node_next->stats.matrix_node_count;
+                        }
                     }
                 }
             }
-            stats.is_expanded = true;
-            stats.mutex.unlock();
 
-            // recurse
+            stats.payoff = LRSNash::solve(stats.nash_payoff_matrix, stats.row_solution, stats.col_solution);
+            math::canonicalize(stats.payoff);
+        }
+
+    private:
+        struct Branch
+        {
+            Types::State state;
+            MatrixNode *matrix_node;
+            int row_idx, col_idx;
+        };
+
+        /*
+        All the children are created before any task starts, so the tasks never insert into this node or its chance
+        nodes. Each task gets a copy of the model, and the payoffs are added in the same order as the serial loop.
+        */
+        void run_tasks(
+            const size_t max_depth,
+            const Types::State &state,
+            const Types::Model &model,
+            MatrixNode *matrix_node,
+            TaskPool &pool) const
+        {
+            MatrixStats &stats = matrix_node->stats;
+            const size_t rows = state.row_actions.size();
+            const size_t cols = state.col_actions.size();
+
+            std::vector<Branch> branches{};
             for (int row_idx = 0; row_idx < rows; ++row_idx)
             {
                 for (int col_idx = 0; col_idx < cols; ++col_idx)
@@ -148,16 +206,6 @@ struct FullTraversal : Types
 
                     ChanceNode *chance_node = matrix_node->access(row_idx, col_idx);
 
-                    if (!chance_node->stats.mutex.try_lock())
-                    {
-                        continue;
-                    }
-
-                    if (chance_node->stats.is_solved)
-                    {
-                        continue;
-                    }
-
                     auto &chance_actions = chance_node->stats.chance_actions;
                     state.get_chance_actions(row_action, col_action, chance_actions);
 
@@ -170,22 +218,29 @@ struct FullTraversal : Types
                         matrix_node_next->stats.depth = stats.depth + 1;
                         matrix_node_next->stats.prob = state_copy.prob;
                         chance_node->stats.chance_strategy.push_back(state_copy.prob);
-
-                        run_(max_depth, &state_copy, model_ptr, matrix_node_next);
-
-                        stats.nash_payoff_matrix.get(row_idx, col_idx) +=
-                            matrix_node_next->stats.payoff *
-                            typename Types::Real{matrix_node_next->stats.prob};
-                        stats.matrix_node_count += matrix_node_next->stats.matrix_node_count;
+                        branches.push_back({std::move(state_copy), matrix_node_next, row_idx, col_idx});
                     }
-
-                    chance_node->stats.is_solved = true;
-                    chance_node->stats.mutex.unlock();
                 }
             }
 
-            stats.payoff = LRSNash::solve(stats.nash_payoff_matrix, stats.row_solution, stats.col_solution);
-            math::canonicalize(stats.payoff);
+            TaskPool::TaskGroup group{};
+            for (Branch &branch : branches)
+            {
+                pool.submit(
+                    group,
+                    [this, max_depth, &branch, &pool, task_model = model]() mutable
+                    { run_(max_depth, &branch.state, &task_model, branch.matrix_node, &pool); });
+            }
+            pool.wait(group);
+
+            for (const Branch &branch : branches)
+            {
+                MatrixStats &next_stats = branch.matrix_node->stats;
+                stats.nash_payoff_matrix.get(branch.row_idx, branch.col_idx) +=
+                    next_stats.payoff *
+                    typename Types::Real{next_stats.prob};
+                stats.matrix_node_count += next_stats.matrix_node_count;
+            }
         }
     };
 };
@@ -0,0 +1,235 @@
+#pragma once
+
+#include <algorithm/algorithm.h>
+#include <libpinyon/math.h>
+#include <libpinyon/simd.h>
+#include <tree/tree.h>
+
+#include <atomic>
+#include <memory>
+#include <type_traits>
+
+/*
+
+Exp3 for multithreaded search without a stats mutex.
+
+Gains and visit counts are arrays of atomics. Visits are counted with relaxed fetch_add and gains are updated
+with a compare-and-swap loop, so threads that select or update the same node never block each other.
+The mutex overloads take the mutex only for interface compatibility and never lock it.
+
+A thread may select while another is renormalizing the gains. The softmax is invariant under a common shift,
+so this only perturbs the forecast by the pending update; the mutex version is equally stale between copying
+the gains and sampling.
+
+Only floating point `Real` is supported.
+
+*/
+
+template <IsValueModelTypes Types>
+    requires std::is_floating_point_v<typename Types::Real>
+struct Exp3Atomic : Types {
+    using Real = typename Types::Real;
+
+    struct MatrixStats {
+        size_t rows = 0;
+        size_t cols = 0;
+        std::unique_ptr<std::atomic<Real>[]> row_gains{};
+        std::unique_ptr<std::atomic<Real>[]> col_gains{};
+        std::unique_ptr<std::atomic<int>[]> row_visits{};
+        std::unique_ptr<std::atomic<int>[]> col_visits{};
+
+        std::atomic<int> visits{0};
+        std::atomic<Real> row_value_total{0};
+        std::atomic<Real> col_value_total{0};
+
+        MatrixStats() {}
+        MatrixStats(MatrixStats &&other) { *this = std::move(other); }
+        MatrixStats &operator=(MatrixStats &&other) {
+            rows = other.rows;
+            cols = other.cols;
+            row_gains = std::move(other.row_gains);
+            col_gains = std::move(other.col_gains);
+            row_visits = std::move(other.row_visits);
+            col_visits = std::move(other.col_visits);
+            visits.store(other.visits.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            row_value_total.store(other.row_value_total.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            col_value_total.store(other.col_value_total.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            return *this;
+        }
+    };
+    struct ChanceStats {};
+    struct Outcome {
+        int row_idx, col_idx;
+        Types::Value value;
+        Real row_mu, col_mu;
+    };
+
+    class BanditAlgorithm {
+       public:
+        Real gamma{.01};
+        Real one_minus_gamma{gamma * -1 + 1};
+
+        constexpr BanditAlgorithm() {}
+
+        constexpr BanditAlgorithm(Real gamma) : gamma(gamma), one_minus_gamma{gamma * -1 + 1} {}
+
+        friend std::ostream &operator<<(std::ostream &os, const BanditAlgorithm &search) {
+            os << "Exp3Atomic; gamma: " << search.gamma;
+            return os;
+        }
+
+        void get_empirical_strategies(const MatrixStats &stats, Types::VectorReal &row_strategy,
+                                      Types::VectorReal &col_strategy) const {
+            row_strategy.resize(stats.rows);
+            col_strategy.resize(stats.cols);
+            normalize_visits(stats.row_visits.get(), stats.rows, row_strategy);
+            normalize_visits(stats.col_visits.get(), stats.cols, col_strategy);
+        }
+
+        void get_empirical_value(const MatrixStats &stats, Types::Value &value) const {
+            const int visits = stats.visits.load(std::memory_order_relaxed);
+            const Real den = Real{1} / (visits + (visits == 0));
+            const Real row_value = stats.row_value_total.load(std::memory_order_relaxed) * den;
+            if constexpr (Types::Value::IS_CONSTANT_SUM) {
+                value = typename Types::Value{row_value};
+            } else {
+                const Real col_value = stats.col_value_total.load(std::memory_order_relaxed) * den;
+                value = typename Types::Value{PairReal<Real>{row_value, col_value}};
+            }
+        }
+
+        void get_refined_strategies(const MatrixStats &stats, Types::VectorReal &row_strategy,
+                                    Types::VectorReal &col_strategy) const {
+            get_empirical_strategies(stats, row_strategy, col_strategy);
+            denoise(row_strategy, col_strategy);
+        }
+
+        void get_refined_value(const MatrixStats &stats, Types::Value &value) const {
+            get_empirical_value(stats, value);
+        }
+
+        // protected:
+        void initialize_stats(int iterations, const Types::State &state, Types::Model &model,
+                              MatrixStats &stats) const {}
+
+        void expand(MatrixStats &stats, const size_t &rows, const size_t &cols,
+                    const Types::ModelOutput &output) const {
+            stats.rows = rows;
+            stats.cols = cols;
+            stats.row_gains = std::make_unique<std::atomic<Real>[]>(rows);
+            stats.col_gains = std::make_unique<std::atomic<Real>[]>(cols);
+            stats.row_visits = std::make_unique<std::atomic<int>[]>(rows);
+            stats.col_visits = std::make_unique<std::atomic<int>[]>(cols);
+        }
+
+        void select(Types::PRNG &device, const MatrixStats &stats, Outcome &outcome) const {
+            typename Types::VectorReal row_forecast(stats.rows);
+            typename Types::VectorReal col_forecast(stats.cols);
+            forecast(stats.row_gains.get(), stats.rows, row_forecast);
+            forecast(stats.col_gains.get(), stats.cols, col_forecast);
+            const int row_idx = device.sample_pdf(row_forecast);
+            const int col_idx = device.sample_pdf(col_forecast);
+            outcome.row_idx = row_idx;
+            outcome.col_idx = col_idx;
+            outcome.row_mu = row_forecast[row_idx];
+            outcome.col_mu = col_forecast[col_idx];
+        }
+
+        void update_matrix_stats(MatrixStats &stats, const Outcome &outcome) const {
+            atomic_add(stats.row_value_total, static_cast<Real>(outcome.value.get_row_value()));
+            atomic_add(stats.col_value_total, static_cast<Real>(outcome.value.get_col_value()));
+            stats.visits.fetch_add(1, std::memory_order_relaxed);
+            stats.row_visits[outcome.row_idx].fetch_add(1, std::memory_order_relaxed);
+            stats.col_visits[outcome.col_idx].fetch_add(1, std::memory_order_relaxed);
+            update_gains(stats.row_gains.get(), stats.rows, outcome.row_idx,
+                         outcome.value.get_row_value() / outcome.row_mu);
+            update_gains(stats.col_gains.get(), stats.cols, outcome.col_idx,
+                         outcome.value.get_col_value() / outcome.col_mu);
+        }
+
+        void update_chance_stats(ChanceStats &stats, const Outcome &outcome) const {}
+
+        // multithreaded
+
+        void select(Types::PRNG &device, const MatrixStats &stats, Outcome &outcome, Types::Mutex &) const {
+            select(device, stats, outcome);
+        }
+
+        void update_matrix_stats(MatrixStats &stats, const Outcome &outcome, Types::Mutex &) const {
+            update_matrix_stats(stats, outcome);
+        }
+
+        void update_chance_stats(ChanceStats &stats, const Outcome &outcome, Types::Mutex &) const {}
+
+        // virtual loss, same as Exp3
+
+        void apply_virtual_loss(MatrixStats &stats, const Outcome &outcome, const int virtual_loss,
+                                Types::Mutex &) const {
+            atomic_add(stats.row_gains[outcome.row_idx], -virtual_loss / outcome.row_mu);
+            atomic_add(stats.col_gains[outcome.col_idx], -virtual_loss / outcome.col_mu);
+        }
+
+        void revert_virtual_loss(MatrixStats &stats, const Outcome &outcome, const int virtual_loss,
+                                 Types::Mutex &) const {
+            atomic_add(stats.row_gains[outcome.row_idx], virtual_loss / outcome.row_mu);
+            atomic_add(stats.col_gains[outcome.col_idx], virtual_loss / outcome.col_mu);
+        }
+
+       private:
+        static Real atomic_add(std::atomic<Real> &x, const Real delta) {
+            Real expected = x.load(std::memory_order_relaxed);
+            while (!x.compare_exchange_weak(expected, expected + delta, std::memory_order_relaxed)) {
+            }
+            return expected + delta;
+        }
+
+        // Same as Exp3: once a gain becomes non-negative, shift every gain down by it
+        static void update_gains(std::atomic<Real> *gains, const size_t k, const int idx, const Real delta) {
+            const Real gain = atomic_add(gains[idx], delta);
+            if (gain >= 0) {
+                for (size_t i = 0; i < k; ++i) {
+                    atomic_add(gains[i], -gain);
+                }
+            }
+        }
+
+        inline void forecast(const std::atomic<Real> *gains, const size_t k, Types::VectorReal &forecast) const {
+            if (k == 1) {
+                forecast[0] = Real{1};
+                return;
+            }
+            const Real eta{gamma / static_cast<Real>(k)};
+            for (size_t i = 0; i < k; ++i) {
+                forecast[i] = gains[i].load(std::memory_order_relaxed);
+            }
+            math::exp3_forecast(forecast.data(), forecast.data(), k, eta, one_minus_gamma);
+        }
+
+        static void normalize_visits(const std::atomic<int> *visits, const size_t k, Types::VectorReal &strategy) {
+            Real sum = 0;
+            for (size_t i = 0; i < k; ++i) {
+                strategy[i] = static_cast<Real>(visits[i].load(std::memory_order_relaxed));
+                sum += strategy[i];
+            }
+            for (size_t i = 0; i < k; ++i) {
+                strategy[i] /= sum;
+            }
+        }
+
+        inline void denoise(Types::VectorReal &row_strategy, Types::VectorReal &col_strategy) const {
+            const size_t rows = row_strategy.size();
+            const size_t cols = col_strategy.size();
+            const auto &one_minus_gamma = this->one_minus_gamma;
+            if (rows > 1) {
+                const Real eta{gamma / static_cast<Real>(rows)};
+                std::transform(row_strategy.begin(), row_strategy.begin() + rows, row_strategy.begin(),
+                               [eta, one_minus_gamma](Real value) { return (value - eta) / one_minus_gamma; });
+            }
+            if (cols > 1) {
+                const Real eta{gamma / static_cast<Real>(cols)};
+                std::transform(col_strategy.begin(), col_strategy.begin() + cols, col_strategy.begin(),
+                               [eta, one_minus_gamma](Real value) { return (value - eta) / one_minus_gamma; });
+            }
+        }
+    };
+};
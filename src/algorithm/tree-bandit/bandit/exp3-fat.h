@@ -327,6 +327,32 @@ struct Exp3Fat : Types
         {
         }
 
+        // virtual loss, same as Exp3
+
+        void apply_virtual_loss(
+            MatrixStats &stats,
+            const Outcome &outcome,
+            const int virtual_loss,
+            Types::Mutex &mutex) const
+        {
+            mutex.lock();
+            stats.row_gains[outcome.row_idx] -= Real{static_cast<Real>(virtual_loss) / outcome.row_mu};
+            stats.col_gains[outcome.col_idx] -= Real{static_cast<Real>(virtual_loss) / outcome.col_mu};
+            mutex.unlock();
+        }
+
+        void revert_virtual_loss(
+            MatrixStats &stats,
+            const Outcome &outcome,
+            const int virtual_loss,
+            Types::Mutex &mutex) const
+        {
+            mutex.lock();
+            stats.row_gains[outcome.row_idx] += Real{static_cast<Real>(virtual_loss) / outcome.row_mu};
+            stats.col_gains[outcome.col_idx] += Real{static_cast<Real>(virtual_loss) / outcome.col_mu};
+            mutex.unlock();
+        }
+
         // off-policy
 
         void update_matrix_stats(
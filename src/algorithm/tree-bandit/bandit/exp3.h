@@ -1,5 +1,6 @@
 #include <algorithm/algorithm.h>
 #include <libpinyon/math.h>
+#include <libpinyon/simd.h>
 #include <tree/tree.h>
 
 template <IsValueModelTypes Types>
@@ -89,24 +90,19 @@ struct Exp3 : Types {
         void select(Types::PRNG &device, const MatrixStats &stats, Outcome &outcome) const {
             const size_t rows = stats.row_gains.size();
             const size_t cols = stats.col_gains.size();
-            const auto &one_minus_gamma = this->one_minus_gamma;
             typename Types::VectorReal row_forecast(rows);
             typename Types::VectorReal col_forecast(cols);
             if (rows == 1) {
                 row_forecast[0] = Rational<>{1};
             } else {
                 const Real eta{gamma / static_cast<Real>(rows)};
-                softmax(row_forecast, stats.row_gains, rows, eta);
-                std::transform(row_forecast.begin(), row_forecast.begin() + rows, row_forecast.begin(),
-                               [eta, one_minus_gamma](Real value) { return one_minus_gamma * value + eta; });
+                get_forecast(row_forecast, stats.row_gains, rows, eta);
             }
             if (cols == 1) {
                 col_forecast[0] = Rational<>{1};
             } else {
                 const Real eta{gamma / static_cast<Real>(cols)};
-                softmax(col_forecast, stats.col_gains, cols, eta);
-                std::transform(col_forecast.begin(), col_forecast.begin() + cols, col_forecast.begin(),
-                               [eta, one_minus_gamma](Real value) { return one_minus_gamma * value + eta; });
+                get_forecast(col_forecast, stats.col_gains, cols, eta);
             }
             const int row_idx = device.sample_pdf(row_forecast);
             const int col_idx = device.sample_pdf(col_forecast);
@@ -122,16 +118,10 @@ struct Exp3 : Types {
             stats.row_visits[outcome.row_idx] += 1;
             stats.col_visits[outcome.col_idx] += 1;
             if ((stats.row_gains[outcome.row_idx] += outcome.value.get_row_value() / outcome.row_mu) >= 0) {
-                const auto max = stats.row_gains[outcome.row_idx];
-                for (auto &v : stats.row_gains) {
-                    v -= max;
-                }
+                normalize(stats.row_gains, stats.row_gains[outcome.row_idx]);
             }
             if ((stats.col_gains[outcome.col_idx] += outcome.value.get_col_value() / outcome.col_mu) >= 0) {
-                const auto max = stats.col_gains[outcome.col_idx];
-                for (auto &v : stats.col_gains) {
-                    v -= max;
-                }
+                normalize(stats.col_gains, stats.col_gains[outcome.col_idx]);
             }
         }
 
@@ -148,23 +138,18 @@ struct Exp3 : Types {
             mutex.unlock();
             const size_t rows = row_forecast.size();
             const size_t cols = col_forecast.size();
-            const auto &one_minus_gamma = this->one_minus_gamma;
 
             if (rows == 1) {
                 row_forecast[0] = Rational<>{1};
             } else {
                 const Real eta{gamma / static_cast<Real>(rows)};
-                softmax(row_forecast, row_forecast, rows, eta);
-                std::transform(row_forecast.begin(), row_forecast.begin() + rows, row_forecast.begin(),
-                               [eta, one_minus_gamma](Real value) { return one_minus_gamma * value + eta; });
+                get_forecast(row_forecast, row_forecast, rows, eta);
             }
             if (cols == 1) {
                 col_forecast[0] = Rational<>{1};
             } else {
                 const Real eta{gamma / static_cast<Real>(cols)};
-                softmax(col_forecast, col_forecast, cols, eta);
-                std::transform(col_forecast.begin(), col_forecast.begin() + cols, col_forecast.begin(),
-                               [eta, one_minus_gamma](Real value) { return one_minus_gamma * value + eta; });
+                get_forecast(col_forecast, col_forecast, cols, eta);
             }
             const int row_idx = device.sample_pdf(row_forecast, rows);
             const int col_idx = device.sample_pdf(col_forecast, cols);
@@ -181,22 +166,37 @@ struct Exp3 : Types {
             stats.row_visits[outcome.row_idx] += 1;
             stats.col_visits[outcome.col_idx] += 1;
             if ((stats.row_gains[outcome.row_idx] += outcome.value.get_row_value() / outcome.row_mu) >= 0) {
-                const auto max = stats.row_gains[outcome.row_idx];
-                for (auto &v : stats.row_gains) {
-                    v -= max;
-                }
+                normalize(stats.row_gains, stats.row_gains[outcome.row_idx]);
             }
             if ((stats.col_gains[outcome.col_idx] += outcome.value.get_col_value() / outcome.col_mu) >= 0) {
-                const auto max = stats.col_gains[outcome.col_idx];
-                for (auto &v : stats.col_gains) {
-                    v -= max;
-                }
+                normalize(stats.col_gains, stats.col_gains[outcome.col_idx]);
             }
             mutex.unlock();
         }
 
         void update_chance_stats(ChanceStats &stats, const Outcome &outcome, Types::Mutex &mutex) const {}
 
+        // virtual loss: each pending visit is counted as a reward of -1, i.e. the selected gains are lowered by
+        // virtual_loss / mu. Values lie in [0, 1], so a reward of 0 would leave the gains unchanged; -1 is the
+        // lowest value minus the width of the range, one full reward below anything a real update can add.
+        // Reverted before the real update, so the update itself (including the normalization) is unchanged
+
+        void apply_virtual_loss(MatrixStats &stats, const Outcome &outcome, const int virtual_loss,
+                                Types::Mutex &mutex) const {
+            mutex.lock();
+            stats.row_gains[outcome.row_idx] -= Real{static_cast<Real>(virtual_loss) / outcome.row_mu};
+            stats.col_gains[outcome.col_idx] -= Real{static_cast<Real>(virtual_loss) / outcome.col_mu};
+            mutex.unlock();
+        }
+
+        void revert_virtual_loss(MatrixStats &stats, const Outcome &outcome, const int virtual_loss,
+                                 Types::Mutex &mutex) const {
+            mutex.lock();
+            stats.row_gains[outcome.row_idx] += Real{static_cast<Real>(virtual_loss) / outcome.row_mu};
+            stats.col_gains[outcome.col_idx] += Real{static_cast<Real>(virtual_loss) / outcome.col_mu};
+            mutex.unlock();
+        }
+
         // off-policy
 
         void update_matrix_stats_offpolicy(MatrixStats &stats, const Outcome &outcome) const {
@@ -205,16 +205,10 @@ struct Exp3 : Types {
             stats.row_visits[outcome.row_idx] += 1;
             stats.col_visits[outcome.col_idx] += 1;
             if ((stats.row_gains[outcome.row_idx] += outcome.value.get_row_value() / outcome.row_mu) >= 0) {
-                const auto max = stats.row_gains[outcome.row_idx];
-                for (auto &v : stats.row_gains) {
-                    v -= max;
-                }
+                normalize(stats.row_gains, stats.row_gains[outcome.row_idx]);
             }
             if ((stats.col_gains[outcome.col_idx] += outcome.value.get_col_value() / outcome.col_mu) >= 0) {
-                const auto max = stats.col_gains[outcome.col_idx];
-                for (auto &v : stats.col_gains) {
-                    v -= max;
-                }
+                normalize(stats.col_gains, stats.col_gains[outcome.col_idx]);
             }
         }
 
@@ -230,6 +224,34 @@ struct Exp3 : Types {
         void expand_inference_part(MatrixStats &stats, const Types::ModelOutput &output) const {}
 
        private:
+        // the vectorized kernels in simd.h cover float and double, anything else (e.g. mpq) goes through softmax
+        static constexpr bool use_kernels =
+            (std::is_same_v<Real, double> || std::is_same_v<Real, float>) &&
+            std::ranges::contiguous_range<typename Types::VectorReal>;
+
+        inline void get_forecast(Types::VectorReal &forecast, const Types::VectorReal &gains, const size_t k,
+                                 Real eta) const {
+            if constexpr (use_kernels) {
+                math::exp3_forecast(gains.data(), forecast.data(), k, eta, one_minus_gamma);
+            } else {
+                softmax(forecast, gains, k, eta);
+                const auto &one_minus_gamma = this->one_minus_gamma;
+                std::transform(forecast.begin(), forecast.begin() + k, forecast.begin(),
+                               [eta, one_minus_gamma](Real value) { return one_minus_gamma * value + eta; });
+            }
+        }
+
+        // subtracts the largest gain so the gains stay non-positive
+        inline void normalize(Types::VectorReal &gains, const Real max) const {
+            if constexpr (use_kernels) {
+                math::shift(gains.data(), gains.size(), max);
+            } else {
+                for (auto &v : gains) {
+                    v -= max;
+                }
+            }
+        }
+
         inline void softmax(Types::VectorReal &forecast, const Types::VectorReal &gains, const size_t k,
                             Real eta) const {
             Real sum = 0;
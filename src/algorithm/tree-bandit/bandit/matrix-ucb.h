@@ -4,7 +4,9 @@
 
 #include <algorithm/algorithm.h>
 #include <concepts>
+#include <libpinyon/lemke-howson.h>
 #include <libpinyon/lrslib.h>
+#include <libpinyon/solution-cache.h>
 #include <libpinyon/math.h>
 #include <tree/tree.h>
 #include <types/matrix.h>
@@ -23,11 +25,18 @@ struct MatrixUCB : Types {
         struct Data {
             Types::Value value;
             int visits;
+            // value / visits and 1 / sqrt(visits), with visits counted as at least 1. Only the updated entry changes
+            Real row_mean{0};
+            Real col_mean{0};
+            Real inv_sqrt_visits{1};
         };
         int total_visits{};
         DataMatrix<Data> data_matrix;
         Types::VectorReal row_strategy;
         Types::VectorReal col_strategy;
+        // reused by every select
+        MatrixPairReal ucb_matrix;
+        LemkeHowson::WarmStart solver;
     };
 
     struct ChanceStats {};
@@ -53,6 +62,8 @@ struct MatrixUCB : Types {
 
         const Types::Real c_uct{2};
         const Types::Real expl_threshold{.005};
+        // used by get_refined_strategies if set
+        std::shared_ptr<SolutionCache<Types>> solution_cache{};
         // bool require_interior = false;
 
         void initialize_stats(int playouts, Types::State &state, Types::Model &model, MatrixStats &stats) {}
@@ -77,7 +88,7 @@ struct MatrixUCB : Types {
         void get_refined_strategies(const MatrixStats &stats, Types::VectorReal &row_strategy,
                                     Types::VectorReal &col_strategy) {
             const auto value_matrix = get_ev_matrix(stats);
-            LRSNash::solve(value_matrix, row_strategy, col_strategy);
+            LRSNash::solve(solution_cache.get(), value_matrix, row_strategy, col_strategy);
         }
 
         void get_empirical_value(const MatrixStats &stats, Types::Value value) const
@@ -88,21 +99,25 @@ struct MatrixUCB : Types {
         void expand(MatrixStats &stats, const size_t &rows, const size_t &cols,
                     const Types::ModelOutput &output) const {  // matrix_node->is_expanded = true;
             stats.data_matrix.fill(rows, cols, {});
+            stats.ucb_matrix.fill(rows, cols);
             // uniform initialization of stats.strategies
             stats.row_strategy.resize(rows, 1 / static_cast<Real>(rows));
             stats.col_strategy.resize(cols, 1 / static_cast<Real>(cols));
         }
 
         void select(Types::PRNG &device, MatrixStats &stats, Outcome &outcome) const {
-            const size_t rows = stats.data_matrix.rows;
-            const size_t cols = stats.data_matrix.cols;
-            MatrixPairReal ucb_matrix{rows, cols};
+            MatrixPairReal &ucb_matrix = stats.ucb_matrix;
             get_ucb_matrix(stats, ucb_matrix);
             typename Types::VectorReal &row_strategy = stats.row_strategy;
             typename Types::VectorReal &col_strategy = stats.col_strategy;
             Real expl = math::exploitability(ucb_matrix, row_strategy, col_strategy);
             if (expl > expl_threshold) {
-                LRSNash::solve(ucb_matrix, row_strategy, col_strategy);
+                if constexpr (std::is_floating_point_v<Real>) {
+                    // the UCB matrix changes a little every visit, so the last equilibrium's supports usually still work
+                    stats.solver.solve(ucb_matrix, row_strategy, col_strategy);
+                } else {
+                    LRSNash::solve(ucb_matrix, row_strategy, col_strategy);
+                }
             }
             outcome.row_idx = device.sample_pdf(row_strategy);
             outcome.col_idx = device.sample_pdf(col_strategy);
@@ -113,27 +128,51 @@ struct MatrixUCB : Types {
             auto &data = stats.data_matrix.get(outcome.row_idx, outcome.col_idx);
             data.value += outcome.value;
             ++data.visits;
+            update_means(data);
         }
 
         void update_chance_stats(const ChanceStats &stats, const Outcome &outcome) const {}
 
+        // virtual loss: the selected entry is given `virtual_loss` visits with zero value for both players
+
+        void apply_virtual_loss(MatrixStats &stats, const Outcome &outcome, const int virtual_loss,
+                                Types::Mutex &mutex) const {
+            mutex.lock();
+            stats.total_visits += virtual_loss;
+            auto &data = stats.data_matrix.get(outcome.row_idx, outcome.col_idx);
+            data.visits += virtual_loss;
+            update_means(data);
+            mutex.unlock();
+        }
+
+        void revert_virtual_loss(MatrixStats &stats, const Outcome &outcome, const int virtual_loss,
+                                 Types::Mutex &mutex) const {
+            mutex.lock();
+            stats.total_visits -= virtual_loss;
+            auto &data = stats.data_matrix.get(outcome.row_idx, outcome.col_idx);
+            data.visits -= virtual_loss;
+            update_means(data);
+            mutex.unlock();
+        }
+
         // private:
+        void update_means(typename MatrixStats::Data &data) const {
+            const int n = data.visits + (data.visits == 0);
+            data.row_mean = data.value.get_row_value() / n;
+            data.col_mean = data.value.get_col_value() / n;
+            data.inv_sqrt_visits = 1 / std::sqrt(static_cast<Real>(n));
+        }
+
         void get_ucb_matrix(const MatrixStats &stats, MatrixPairReal &ucb_matrix) const {
             auto &data_matrix = stats.data_matrix;
-            const int rows = data_matrix.rows;
-            const int cols = data_matrix.cols;
-            const Real log_total = std::log(stats.total_visits);
-            for (int row_idx = 0; row_idx < rows; ++row_idx) {
-                for (int col_idx = 0; col_idx < cols; ++col_idx) {
-                    const int entry_idx = row_idx * cols + col_idx;
-                    const auto &data = data_matrix[entry_idx];
-                    auto &ucb_pair = ucb_matrix[entry_idx];
-                    int n = data.visits;
-                    n += (n == 0);
-                    const Real eta = this->c_uct * std::sqrt(log_total / n);
-                    ucb_pair.row_value = data.value.get_row_value() / n + eta;
-                    ucb_pair.col_value = data.value.get_col_value() / n + eta;
-                }
+            const size_t entries = data_matrix.rows * data_matrix.cols;
+            const Real c = this->c_uct * std::sqrt(std::log(stats.total_visits));
+            for (size_t entry_idx = 0; entry_idx < entries; ++entry_idx) {
+                const auto &data = data_matrix[entry_idx];
+                auto &ucb_pair = ucb_matrix[entry_idx];
+                const Real eta = c * data.inv_sqrt_visits;
+                ucb_pair.row_value = data.row_mean + eta;
+                ucb_pair.col_value = data.col_mean + eta;
             }
         }
 
@@ -59,5 +59,13 @@ struct Rand : Types {
         void update_matrix_stats(MatrixStats &stats, const Outcome &outcome, Types::Mutex &mutex) const {}
 
         void update_chance_stats(ChanceStats &stats, const Outcome &outcome, Types::Mutex &mutex) const {}
+
+        // selection does not depend on the stats, so there is nothing to discourage
+
+        void apply_virtual_loss(MatrixStats &stats, const Outcome &outcome, const int virtual_loss,
+                                Types::Mutex &mutex) const {}
+
+        void revert_virtual_loss(MatrixStats &stats, const Outcome &outcome, const int virtual_loss,
+                                 Types::Mutex &mutex) const {}
     };
 };
@@ -12,6 +12,8 @@ struct UCB : Types {
             Types::Real v{0};
             Types::Real log_n{1};
             Types::Real q{0};
+            // visits added by virtual loss that have not been reverted yet
+            int pending{0};
         };
         Types::template Vector<Data> row_ucb_vector;
         Types::template Vector<Data> col_ucb_vector;
@@ -100,15 +102,17 @@ struct UCB : Types {
         void select(Types::PRNG &device, const MatrixStats &stats, Outcome &outcome) const {
             Real max_val{-1};
             for (int i{}; i < stats.row_ucb_vector.size(); ++i) {
-                if (stats.row_ucb_vector[i].q > max_val) {
-                    max_val = stats.row_ucb_vector[i].q;
+                const Real q = score(stats, stats.row_ucb_vector[i]);
+                if (q > max_val) {
+                    max_val = q;
                     outcome.row_idx = i;
                 }
             }
             max_val = Real{-1};
             for (int i{}; i < stats.col_ucb_vector.size(); ++i) {
-                if (stats.col_ucb_vector[i].q > max_val) {
-                    max_val = stats.col_ucb_vector[i].q;
+                const Real q = score(stats, stats.col_ucb_vector[i]);
+                if (q > max_val) {
+                    max_val = q;
                     outcome.col_idx = i;
                 }
             }
@@ -151,5 +155,52 @@ struct UCB : Types {
             }
         }
         void update_chance_stats(ChanceStats &stats, const Outcome &outcome) const {}
+
+        // multithreaded
+
+        void select(Types::PRNG &device, const MatrixStats &stats, Outcome &outcome, Types::Mutex &mutex) const {
+            mutex.lock();
+            select(device, stats, outcome);
+            mutex.unlock();
+        }
+
+        void update_matrix_stats(MatrixStats &stats, const Outcome &outcome, Types::Mutex &mutex) const {
+            mutex.lock();
+            update_matrix_stats(stats, outcome);
+            mutex.unlock();
+        }
+
+        void update_chance_stats(ChanceStats &stats, const Outcome &outcome, Types::Mutex &mutex) const {}
+
+        // virtual loss: the selected actions are scored as if they had `virtual_loss` more visits of zero value
+
+        void apply_virtual_loss(MatrixStats &stats, const Outcome &outcome, const int virtual_loss,
+                                Types::Mutex &mutex) const {
+            mutex.lock();
+            stats.row_ucb_vector[outcome.row_idx].pending += virtual_loss;
+            stats.col_ucb_vector[outcome.col_idx].pending += virtual_loss;
+            mutex.unlock();
+        }
+
+        void revert_virtual_loss(MatrixStats &stats, const Outcome &outcome, const int virtual_loss,
+                                 Types::Mutex &mutex) const {
+            mutex.lock();
+            stats.row_ucb_vector[outcome.row_idx].pending -= virtual_loss;
+            stats.col_ucb_vector[outcome.col_idx].pending -= virtual_loss;
+            mutex.unlock();
+        }
+
+       private:
+        inline Real score(const MatrixStats &stats, const typename MatrixStats::Data &data) const {
+            if (data.pending == 0) {
+                return data.q;
+            }
+            Real big_log{std::log(static_cast<Real>(stats.visits))};
+            if (stats.visits <= 1) {
+                big_log = 1;
+            }
+            const Real n = static_cast<Real>(data.n + data.pending);
+            return data.v * data.n / n + big_log / std::log(n);
+        }
     };
 };
\ No newline at end of file
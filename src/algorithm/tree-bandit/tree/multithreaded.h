@@ -1,9 +1,13 @@
 #pragma once
 
 #include <algorithm/tree-bandit/tree/tree-bandit.h>
+#include <libpinyon/deadline.h>
+#include <libpinyon/worker-pool.h>
 
 #include <tree/tree.h>
 
+#include <memory>
+#include <numeric>
 #include <thread>
 #include <mutex>
 #include <atomic>
@@ -19,6 +23,15 @@ struct TreeBanditThreaded : Types
     {
         typename Types::Mutex stats_mutex{};
         typename Types::Mutex tree_mutex{};
+
+        MatrixStats() {}
+        // mutexes are not movable, so moved stats (e.g. from promoting a subtree) get fresh ones
+        MatrixStats(MatrixStats &&other) : Types::MatrixStats(std::move(other)) {}
+        MatrixStats &operator=(MatrixStats &&other)
+        {
+            Types::MatrixStats::operator=(std::move(other));
+            return *this;
+        }
     };
     struct ChanceStats : Types::ChanceStats
     {
@@ -27,6 +40,8 @@ struct TreeBanditThreaded : Types
     };
     using MatrixNode = NodePair<Types, MatrixStats, ChanceStats, typename Options::NodeActions>::MatrixNode;
     using ChanceNode = NodePair<Types, MatrixStats, ChanceStats, typename Options::NodeActions>::ChanceNode;
+    // nodes that evict between descents would never evict here, since this search does not call begin_descent
+    static_assert(!IsDescentNodeTypes<NodePair<Types, MatrixStats, ChanceStats, typename Options::NodeActions>>);
 
     class Search : public Types::BanditAlgorithm
     {
@@ -41,15 +56,38 @@ struct TreeBanditThreaded : Types
         {
         }
 
+        // share an existing pool, e.g. between the searches of several leaf models
+        Search(const Types::BanditAlgorithm &base, std::shared_ptr<WorkerPool> pool)
+            : Types::BanditAlgorithm{base}, threads{pool->size()}, pool{pool}
+        {
+        }
+
+        Search(const Types::BanditAlgorithm &base, size_t threads, int virtual_loss)
+            requires IsVirtualLossBanditTypes<Types>
+            : Types::BanditAlgorithm{base}, threads{threads}, virtual_loss{virtual_loss}
+        {
+        }
+
         friend std::ostream &operator<<(std::ostream &os, const Search &search)
         {
-            os << "TreeBanditThreaded; threads: " << search.threads << " - ";
+            os << "TreeBanditThreaded; threads: " << search.threads;
+            if (search.virtual_loss > 0)
+            {
+                os << ", virtual loss: " << search.virtual_loss;
+            }
+            os << " - ";
             os << static_cast<typename Types::BanditAlgorithm>(search);
             os << " - " << NodePair<Types, typename Types::MatrixStats, typename Types::ChanceStats>{};
             return os;
         }
 
         const size_t threads = 1;
+        // pending visits applied to a joint action between its selection and update, to spread out the threads
+        const int virtual_loss = 0;
+        // if set, `run` returns early once the flag is true
+        const std::atomic<bool> *stop_flag = nullptr;
+        // a copy of the search gets its own pool, unless this one was passed to the constructor
+        WorkerPoolHandle pool{threads};
 
         size_t run(
             const size_t duration_ms,
@@ -58,23 +96,11 @@ struct TreeBanditThreaded : Types
             Types::Model &model,
             MatrixNode &matrix_node) const
         {
-            std::thread thread_pool[threads];
-            size_t iterations[threads];
-            size_t total_iterations = 0;
-            for (int i = 0; i < threads; ++i)
-            {
-                thread_pool[i] = std::thread(
-                    &Search::run_thread, this, duration_ms, device.uniform_64(), &state, &model, &matrix_node, std::next(iterations, i));
-            }
-            for (int i = 0; i < threads; ++i)
-            {
-                thread_pool[i].join();
-            }
-            for (int i = 0; i < threads; ++i)
-            {
-                total_iterations += iterations[i];
-            }
-            return total_iterations;
+            const std::vector<typename Types::Seed> seeds = thread_seeds(device);
+            std::vector<size_t> iterations(threads);
+            pool->run([this, duration_ms, &seeds, &state, &model, &matrix_node, &iterations](const size_t thread_idx)
+                      { this->run_thread(duration_ms, seeds[thread_idx], &state, &model, &matrix_node, &iterations[thread_idx]); });
+            return std::accumulate(iterations.begin(), iterations.end(), size_t{0});
         }
 
         size_t run_for_iterations(
@@ -84,23 +110,27 @@ struct TreeBanditThreaded : Types
             Types::Model &model,
             MatrixNode &matrix_node) const
         {
-            std::thread thread_pool[threads];
             const size_t iterations_per_thread = iterations / threads;
             const auto start = std::chrono::high_resolution_clock::now();
-            for (int i = 0; i < threads; ++i)
-            {
-                thread_pool[i] = std::thread(
-                    &Search::run_thread_for_iterations, this, iterations_per_thread, device.uniform_64(), &state, &model, &matrix_node);
-            }
-            for (int i = 0; i < threads; ++i)
-            {
-                thread_pool[i].join();
-            }
+            const std::vector<typename Types::Seed> seeds = thread_seeds(device);
+            pool->run([this, iterations_per_thread, &seeds, &state, &model, &matrix_node](const size_t thread_idx)
+                      { this->run_thread_for_iterations(iterations_per_thread, seeds[thread_idx], &state, &model, &matrix_node); });
             const auto end = std::chrono::high_resolution_clock::now();
             const auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
             return duration.count();
         }
 
+        // One seed per thread from the caller's device, so a search is reproduced by the seed of `device`
+        std::vector<typename Types::Seed> thread_seeds(Types::PRNG &device) const
+        {
+            std::vector<typename Types::Seed> seeds(threads);
+            for (auto &seed : seeds)
+            {
+                seed = device.uniform_64();
+            }
+            return seeds;
+        }
+
         void run_thread(
             const size_t duration_ms,
             const Types::Seed thread_device_seed,
@@ -113,17 +143,14 @@ struct TreeBanditThreaded : Types
             typename Types::Model model_thread{*model};
             typename Types::ModelOutput model_output;
 
-            const auto start = std::chrono::high_resolution_clock::now();
-            auto end = std::chrono::high_resolution_clock::now();
-            auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
+            Deadline deadline{duration_ms, stop_flag};
             size_t thread_iterations = 0;
-            for (; duration.count() < duration_ms; ++thread_iterations)
+            IterationState<Types> iteration_state{*state};
+            for (; !deadline.expired(); ++thread_iterations)
             {
-                typename Types::State state_copy{*state};
+                typename Types::State &state_copy = iteration_state.reset();
                 state_copy.randomize_transition(device_thread);
                 this->run_iteration(device_thread, state_copy, model_thread, matrix_node, model_output);
-                end = std::chrono::high_resolution_clock::now();
-                duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
             }
             *iterations = thread_iterations;
         }
@@ -138,9 +165,10 @@ struct TreeBanditThreaded : Types
             typename Types::PRNG device_thread(thread_device_seed);
             typename Types::Model model_thread{*model};
             typename Types::ModelOutput model_output;
+            IterationState<Types> iteration_state{*state};
             for (size_t iteration = 0; iteration < iterations; ++iteration)
             {
-                typename Types::State state_copy{*state};
+                typename Types::State &state_copy = iteration_state.reset();
                 state_copy.randomize_transition(device_thread);
                 this->run_iteration(device_thread, state_copy, model_thread, matrix_node, model_output);
             }
@@ -209,6 +237,13 @@ struct TreeBanditThreaded : Types
                 {
                     typename Types::Outcome outcome;
                     this->select(device, matrix_node->stats, outcome);
+                    if constexpr (IsVirtualLossBanditTypes<Types>)
+                    {
+                        if (virtual_loss > 0)
+                        {
+                            this->apply_virtual_loss(matrix_node->stats, outcome, virtual_loss, stats_mutex);
+                        }
+                    }
 
                     if constexpr (!std::is_same_v<typename Options::NodeActions, void>)
                     {
@@ -224,10 +259,20 @@ struct TreeBanditThreaded : Types
                         state.get_actions();
                     }
 
-                    tree_mutex.lock();
-                    ChanceNode *chance_node = matrix_node->access(outcome.row_idx, outcome.col_idx);
-                    MatrixNode *matrix_node_next = chance_node->access(state.get_obs());
-                    tree_mutex.unlock();
+                    ChanceNode *chance_node;
+                    MatrixNode *matrix_node_next;
+                    if constexpr (IsLockFreeNodeTypes<NodePair<Types, MatrixStats, ChanceStats, typename Options::NodeActions>>)
+                    {
+                        chance_node = matrix_node->access_atomic(outcome.row_idx, outcome.col_idx);
+                        matrix_node_next = chance_node->access_atomic(state.get_obs());
+                    }
+                    else
+                    {
+                        tree_mutex.lock();
+                        chance_node = matrix_node->access(outcome.row_idx, outcome.col_idx);
+                        matrix_node_next = chance_node->access(state.get_obs());
+                        tree_mutex.unlock();
+                    }
 
                     MatrixNode *matrix_node_leaf = run_iteration(device, state, model, matrix_node_next, model_output);
 
@@ -239,6 +284,13 @@ struct TreeBanditThreaded : Types
                     {
                         this->get_empirical_value(matrix_node_next->stats, outcome.value);
                     }
+                    if constexpr (IsVirtualLossBanditTypes<Types>)
+                    {
+                        if (virtual_loss > 0)
+                        {
+                            this->revert_virtual_loss(matrix_node->stats, outcome, virtual_loss, stats_mutex);
+                        }
+                    }
                     this->update_matrix_stats(matrix_node->stats, outcome, stats_mutex);
                     this->update_chance_stats(chance_node->stats, outcome); // no guard
                     return matrix_node_leaf;
@@ -258,12 +310,25 @@ struct TreeBanditThreadPool : Types
     {
         int mutex_index = 0;
         std::atomic<int> atomic_mutex_index{-1};
+
+        MatrixStats() {}
+        MatrixStats(MatrixStats &&other)
+            : Types::MatrixStats(std::move(other)), mutex_index{other.mutex_index}, atomic_mutex_index{other.atomic_mutex_index.load()} {}
+        MatrixStats &operator=(MatrixStats &&other)
+        {
+            Types::MatrixStats::operator=(std::move(other));
+            mutex_index = other.mutex_index;
+            atomic_mutex_index.store(other.atomic_mutex_index.load());
+            return *this;
+        }
     };
     struct ChanceStats : Types::ChanceStats
     {
     };
     using MatrixNode = NodePair<Types, MatrixStats, ChanceStats, typename Options::NodeActions>::MatrixNode;
     using ChanceNode = NodePair<Types, MatrixStats, ChanceStats, typename Options::NodeActions>::ChanceNode;
+    // nodes that evict between descents would never evict here, since this search does not call begin_descent
+    static_assert(!IsDescentNodeTypes<NodePair<Types, MatrixStats, ChanceStats, typename Options::NodeActions>>);
 
     struct DoubleMutex
     {
@@ -291,7 +356,14 @@ struct TreeBanditThreadPool : Types
             mutex_pool.resize(pool_size);
         }
 
-        Search(const Search &other) : Types::BanditAlgorithm{other}, threads{other.threads}, pool_size{other.pool_size}
+        Search(const Types::BanditAlgorithm &base, std::shared_ptr<WorkerPool> pool, const size_t pool_size)
+            : Types::BanditAlgorithm{base}, threads{pool->size()}, pool_size{pool_size}, pool{pool}
+        {
+            mutex_pool.resize(pool_size);
+        }
+
+        Search(const Search &other)
+            : Types::BanditAlgorithm{other}, threads{other.threads}, pool_size{other.pool_size}, stop_flag{other.stop_flag}, pool{other.pool}
         {
             mutex_pool.resize(pool_size);
         }
@@ -308,8 +380,11 @@ struct TreeBanditThreadPool : Types
 
         const size_t threads = 1;
         const size_t pool_size = 64;
+        // if set, `run` returns early once the flag is true
+        const std::atomic<bool> *stop_flag = nullptr;
         std::vector<DoubleMutex> mutex_pool{};
         std::atomic<unsigned int> current_index{0};
+        WorkerPoolHandle pool{threads};
 
         size_t run(
             const size_t duration_ms,
@@ -318,23 +393,11 @@ struct TreeBanditThreadPool : Types
             Types::Model &model,
             MatrixNode &matrix_node)
         {
-            std::thread thread_pool[threads];
-            size_t iterations[threads];
-            size_t total_iterations = 0;
-            for (int i = 0; i < threads; ++i)
-            {
-                thread_pool[i] = std::thread(
-                    &Search::run_thread, this, duration_ms, device.uniform_64(), &state, &model, &matrix_node, std::next(iterations, i));
-            }
-            for (int i = 0; i < threads; ++i)
-            {
-                thread_pool[i].join();
-            }
-            for (int i = 0; i < threads; ++i)
-            {
-                total_iterations += iterations[i];
-            }
-            return total_iterations;
+            const std::vector<typename Types::Seed> seeds = thread_seeds(device);
+            std::vector<size_t> iterations(threads);
+            pool->run([this, duration_ms, &seeds, &state, &model, &matrix_node, &iterations](const size_t thread_idx)
+                      { this->run_thread(duration_ms, seeds[thread_idx], &state, &model, &matrix_node, &iterations[thread_idx]); });
+            return std::accumulate(iterations.begin(), iterations.end(), size_t{0});
         }
 
         size_t run_for_iterations(
@@ -344,23 +407,27 @@ struct TreeBanditThreadPool : Types
             Types::Model &model,
             MatrixNode &matrix_node)
         {
-            std::thread thread_pool[threads];
             size_t iterations_per_thread = iterations / threads;
             const auto start = std::chrono::high_resolution_clock::now();
-            for (int i = 0; i < threads; ++i)
-            {
-                thread_pool[i] = std::thread(
-                    &Search::run_thread_for_iterations, this, iterations_per_thread, device.uniform_64(), &state, &model, &matrix_node);
-            }
-            for (int i = 0; i < threads; ++i)
-            {
-                thread_pool[i].join();
-            }
+            const std::vector<typename Types::Seed> seeds = thread_seeds(device);
+            pool->run([this, iterations_per_thread, &seeds, &state, &model, &matrix_node](const size_t thread_idx)
+                      { this->run_thread_for_iterations(iterations_per_thread, seeds[thread_idx], &state, &model, &matrix_node); });
             const auto end = std::chrono::high_resolution_clock::now();
             const auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
             return duration.count();
         }
 
+        // See TreeBanditThreaded::Search::thread_seeds
+        std::vector<typename Types::Seed> thread_seeds(Types::PRNG &device) const
+        {
+            std::vector<typename Types::Seed> seeds(threads);
+            for (auto &seed : seeds)
+            {
+                seed = device.uniform_64();
+            }
+            return seeds;
+        }
+
         void run_thread(
             const size_t duration_ms,
             const Types::Seed thread_device_seed,
@@ -369,21 +436,18 @@ struct TreeBanditThreadPool : Types
             MatrixNode *const matrix_node,
             size_t *iterations)
         {
-            typename Types::PRNG device_thread{thread_device_seed}; // TODO deterministically provide new seed
-            typename Types::Model model_thread{*model};             // TODO go back to not making new ones? Perhaps only device needs new instance
+            typename Types::PRNG device_thread(thread_device_seed);
+            typename Types::Model model_thread{*model};
             typename Types::ModelOutput model_output;
 
-            const auto start = std::chrono::high_resolution_clock::now();
-            auto end = std::chrono::high_resolution_clock::now();
-            auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
+            Deadline deadline{duration_ms, stop_flag};
             size_t thread_iterations = 0;
-            for (; duration.count() < duration_ms; ++thread_iterations)
+            IterationState<Types> iteration_state{*state};
+            for (; !deadline.expired(); ++thread_iterations)
             {
-                typename Types::State state_copy{*state};
+                typename Types::State &state_copy = iteration_state.reset();
                 state_copy.randomize_transition(device_thread);
                 this->run_iteration(device_thread, state_copy, model_thread, matrix_node, model_output);
-                end = std::chrono::high_resolution_clock::now();
-                duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
             }
             *iterations = thread_iterations;
         }
@@ -395,12 +459,13 @@ struct TreeBanditThreadPool : Types
             const Types::Model *model,
             MatrixNode *const matrix_node)
         {
-            typename Types::PRNG device_thread{thread_device_seed};
+            typename Types::PRNG device_thread(thread_device_seed);
             typename Types::Model model_thread{*model};
             typename Types::ModelOutput model_output;
+            IterationState<Types> iteration_state{*state};
             for (size_t iteration = 0; iteration < iterations; ++iteration)
             {
-                typename Types::State state_copy{*state};
+                typename Types::State &state_copy = iteration_state.reset();
                 state_copy.randomize_transition(device_thread);
                 this->run_iteration(device_thread, state_copy, model_thread, matrix_node, model_output);
             }
@@ -496,10 +561,20 @@ struct TreeBanditThreadPool : Types
                         state.get_actions();
                     }
 
-                    tree_mutex.lock();
-                    ChanceNode *chance_node = matrix_node->access(outcome.row_idx, outcome.col_idx);
-                    MatrixNode *matrix_node_next = chance_node->access(state.get_obs());
-                    tree_mutex.unlock();
+                    ChanceNode *chance_node;
+                    MatrixNode *matrix_node_next;
+                    if constexpr (IsLockFreeNodeTypes<NodePair<Types, MatrixStats, ChanceStats, typename Options::NodeActions>>)
+                    {
+                        chance_node = matrix_node->access_atomic(outcome.row_idx, outcome.col_idx);
+                        matrix_node_next = chance_node->access_atomic(state.get_obs());
+                    }
+                    else
+                    {
+                        tree_mutex.lock();
+                        chance_node = matrix_node->access(outcome.row_idx, outcome.col_idx);
+                        matrix_node_next = chance_node->access(state.get_obs());
+                        tree_mutex.unlock();
+                    }
 
                     MatrixNode *matrix_node_leaf = run_iteration(device, state, model, matrix_node_next, model_output);
 
@@ -3,6 +3,7 @@
 #include <types/types.h>
 #include <tree/tree.h>
 #include <algorithm/algorithm.h>
+#include <libpinyon/deadline.h>
 
 template <
     IsBanditAlgorithmTypes Types,
@@ -20,6 +21,8 @@ struct OffPolicy : Types
     };
     using MatrixNode = NodePair<Types, MatrixStats, ChanceStats>::MatrixNode;
     using ChanceNode = NodePair<Types, MatrixStats, ChanceStats>::ChanceNode;
+    // nodes that evict between descents would never evict here, since this search does not call begin_descent
+    static_assert(!IsDescentNodeTypes<NodePair<Types, MatrixStats, ChanceStats>>);
 
     struct Frame
     {
@@ -49,6 +52,9 @@ struct OffPolicy : Types
             return os;
         }
 
+        // if set, `run` returns early once the flag is true
+        const std::atomic<bool> *stop_flag = nullptr;
+
         size_t run(
             const size_t duration_ms,
             const size_t actor_iterations_per,
@@ -57,14 +63,12 @@ struct OffPolicy : Types
             Types::Model &model,
             std::vector<MatrixNode> &matrix_nodes)
         {
-            auto start = std::chrono::high_resolution_clock::now();
-            auto end = std::chrono::high_resolution_clock::now();
-            auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
+            Deadline deadline{duration_ms, stop_flag};
 
             std::vector<Trajectory> trajectories{};
 
             size_t iterations = 0;
-            for (; duration.count() < duration_ms; ++iterations)
+            for (; !deadline.expired(); ++iterations)
             {
                 trajectories.clear();
                 typename Types::ModelBatchInput model_batch_input{};
@@ -75,7 +79,6 @@ struct OffPolicy : Types
                 model.inference(model_batch_input, model_batch_output);
 
                 update_using_trajectories(model, trajectories, model_batch_output);
-                duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
             }
             return iterations;
         }
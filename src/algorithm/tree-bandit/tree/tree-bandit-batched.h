@@ -0,0 +1,337 @@
+#pragma once
+
+#include <types/types.h>
+#include <algorithm/algorithm.h>
+#include <libpinyon/deadline.h>
+
+#include <tree/tree.h>
+
+#include <chrono>
+#include <limits>
+#include <vector>
+
+/*
+
+TreeBandit for models that are faster when evaluating many states at once.
+
+Each batch descends from the root until `batch_size` distinct unexpanded leaves have been collected,
+`batch_size` descents have ended somewhere else (a terminal node or a leaf already in the batch),
+or `max_wait_us` has passed. It then calls `model.inference(batch_input, batch_output)` once, and then
+expands the leaves and backpropagates every path.
+
+A leaf that is already waiting in the batch is not added again; the path that reached it shares its output.
+If the bandit provides virtual loss hooks, a pending loss is applied along each path during collection so that
+later descents in the same batch are pushed towards other leaves.
+
+Iterations always return after expanding a leaf. An unexpanded root is expanded by a batch of one path,
+since every other path in that batch would end at the same leaf.
+The wait is measured with a `Deadline`, so the clock is not read after every descent.
+
+*/
+
+template <
+    IsBanditAlgorithmTypes Types,
+    template <typename...> typename NodePair = DefaultNodes,
+    typename Options = SearchOptions<>>
+    requires IsBatchModelTypes<Types>
+struct TreeBanditBatched : Types
+{
+    struct MatrixStats : Types::MatrixStats
+    {
+        // index of this node's state in the current batch input, if it is waiting to be expanded
+        long int batch_index = -1;
+    };
+    struct ChanceStats : Types::ChanceStats
+    {
+    };
+    using MatrixNode = NodePair<Types, MatrixStats, ChanceStats, typename Options::NodeActions>::MatrixNode;
+    using ChanceNode = NodePair<Types, MatrixStats, ChanceStats, typename Options::NodeActions>::ChanceNode;
+
+    struct Frame
+    {
+        MatrixNode *matrix_node;
+        ChanceNode *chance_node;
+        typename Types::Outcome outcome;
+    };
+
+    struct Path
+    {
+        std::vector<Frame> frames{};
+        MatrixNode *leaf = nullptr;
+        // -1 if the leaf is terminal, in which case `value` is its payoff
+        long int batch_index = -1;
+        typename Types::Value value{};
+        size_t rows = 0;
+        size_t cols = 0;
+    };
+
+    class Search : public Types::BanditAlgorithm
+    {
+    public:
+        using Types::BanditAlgorithm::BanditAlgorithm;
+
+        Search(const Types::BanditAlgorithm &base) : Types::BanditAlgorithm{base} {}
+
+        Search(const Types::BanditAlgorithm &base, size_t batch_size, size_t max_wait_us)
+            : Types::BanditAlgorithm{base}, batch_size{batch_size}, max_wait_us{max_wait_us}
+        {
+        }
+
+        Search(const Types::BanditAlgorithm &base, size_t batch_size, size_t max_wait_us, int virtual_loss)
+            requires IsVirtualLossBanditTypes<Types>
+            : Types::BanditAlgorithm{base}, batch_size{batch_size}, max_wait_us{max_wait_us}, virtual_loss{virtual_loss}
+        {
+        }
+
+        friend std::ostream &operator<<(std::ostream &os, const Search &search)
+        {
+            os << "TreeBanditBatched; batch size: " << search.batch_size << ", max wait (us): " << search.max_wait_us;
+            if (search.virtual_loss > 0)
+            {
+                os << ", virtual loss: " << search.virtual_loss;
+            }
+            os << " - " << static_cast<typename Types::BanditAlgorithm>(search);
+            os << " - " << NodePair<Types, typename Types::MatrixStats, typename Types::ChanceStats>{};
+            return os;
+        }
+
+        const size_t batch_size = 32;
+        const size_t max_wait_us = 1000;
+        const int virtual_loss = IsVirtualLossBanditTypes<Types> ? 1 : 0;
+        // virtual loss hooks expect a mutex; the search is single threaded so it is never contended
+        mutable typename Types::Mutex mutex{};
+        // if set, `run` returns early once the flag is true
+        const std::atomic<bool> *stop_flag = nullptr;
+
+        size_t run(
+            size_t duration_ms,
+            Types::PRNG &device,
+            const Types::State &state,
+            Types::Model &model,
+            MatrixNode &matrix_node) const
+        {
+            Deadline deadline{duration_ms, stop_flag};
+            std::vector<Path> paths{};
+            size_t iterations = 0;
+            while (!deadline.expired())
+            {
+                iterations += run_batch(static_cast<size_t>(-1), device, state, model, matrix_node, paths);
+            }
+            return iterations;
+        }
+
+        size_t run_for_iterations(
+            const size_t iterations,
+            Types::PRNG &device,
+            const Types::State &state,
+            Types::Model &model,
+            MatrixNode &matrix_node) const
+        {
+            const auto start = std::chrono::high_resolution_clock::now();
+            std::vector<Path> paths{};
+            size_t iteration = 0;
+            while (iteration < iterations)
+            {
+                iteration += run_batch(iterations - iteration, device, state, model, matrix_node, paths);
+            }
+            const auto end = std::chrono::high_resolution_clock::now();
+            const auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
+            return duration.count();
+        }
+
+    protected:
+        // Collects at most `max_paths` paths into one batch, evaluates it and backpropagates. Returns the number of paths
+        size_t run_batch(
+            const size_t max_paths,
+            Types::PRNG &device,
+            const Types::State &state,
+            Types::Model &model,
+            MatrixNode &matrix_node,
+            std::vector<Path> &paths) const
+        {
+            typename Types::ModelBatchInput batch_input{};
+            size_t leaves = 0;
+            size_t n_paths = 0;
+            // every path would end at an unexpanded root, so it is expanded by a batch of its own
+            const size_t batch_paths = matrix_node.is_expanded() ? max_paths : 1;
+            Deadline deadline{std::chrono::microseconds{static_cast<std::chrono::microseconds::rep>(
+                std::min<size_t>(max_wait_us, std::numeric_limits<std::chrono::microseconds::rep>::max()))}};
+            IterationState<Types> iteration_state{state};
+            // the whole batch is one descent, so no path loses its nodes before it is backpropagated
+            if constexpr (IsDescentNodeTypes<NodePair<Types, MatrixStats, ChanceStats, typename Options::NodeActions>>)
+            {
+                matrix_node.begin_descent();
+            }
+            while (leaves < batch_size && n_paths - leaves < batch_size && n_paths < batch_paths)
+            {
+                if (paths.size() == n_paths)
+                {
+                    paths.emplace_back();
+                }
+                Path &path = paths[n_paths++];
+                typename Types::State &state_copy = iteration_state.reset();
+                state_copy.randomize_transition(device);
+                descend(device, state_copy, model, &matrix_node, path, batch_input, leaves);
+                if (deadline.expired())
+                {
+                    break;
+                }
+            }
+
+            typename Types::ModelBatchOutput batch_output{};
+            if (leaves > 0)
+            {
+                model.inference(batch_input, batch_output);
+            }
+
+            typename Types::ModelOutput model_output;
+            for (size_t path_idx = 0; path_idx < n_paths; ++path_idx)
+            {
+                Path &path = paths[path_idx];
+                if (path.batch_index >= 0)
+                {
+                    model.get_output(model_output, batch_output, path.batch_index);
+                    MatrixNode *leaf = path.leaf;
+                    if (!leaf->is_expanded())
+                    {
+                        leaf->expand(path.rows, path.cols);
+                        this->expand(leaf->stats, path.rows, path.cols, model_output);
+                        leaf->stats.batch_index = -1;
+                        if constexpr (!std::is_same_v<typename Options::NodeValue, void>)
+                        {
+                            leaf->value = model_output.value;
+                        }
+                    }
+                }
+                else
+                {
+                    model_output.value = path.value;
+                }
+                backpropagate(path, model_output);
+            }
+            return n_paths;
+        }
+
+        // Selects down to an unexpanded or terminal node and records the path. Only new leaves are added to the batch
+        void descend(
+            Types::PRNG &device,
+            Types::State &state,
+            Types::Model &model,
+            MatrixNode *matrix_node,
+            Path &path,
+            Types::ModelBatchInput &batch_input,
+            size_t &leaves) const
+        {
+            path.frames.clear();
+            while (true)
+            {
+                if (state.is_terminal())
+                {
+                    matrix_node->set_terminal();
+                    path.leaf = matrix_node;
+                    path.batch_index = -1;
+                    path.value = state.get_payoff();
+                    return;
+                }
+                if (!matrix_node->is_expanded())
+                {
+                    path.leaf = matrix_node;
+                    if (matrix_node->stats.batch_index >= 0)
+                    {
+                        path.batch_index = matrix_node->stats.batch_index;
+                        return;
+                    }
+                    if constexpr (!std::is_same_v<typename Options::NodeActions, void>)
+                    {
+                        state.get_actions(
+                            matrix_node->row_actions,
+                            matrix_node->col_actions);
+                        path.rows = matrix_node->row_actions.size();
+                        path.cols = matrix_node->col_actions.size();
+                    }
+                    else
+                    {
+                        path.rows = state.row_actions.size();
+                        path.cols = state.col_actions.size();
+                    }
+                    path.batch_index = static_cast<long int>(leaves++);
+                    matrix_node->stats.batch_index = path.batch_index;
+                    model.add_to_batch_input(std::move(state), batch_input);
+                    return;
+                }
+
+                Frame &frame = path.frames.emplace_back();
+                frame.matrix_node = matrix_node;
+                this->select(device, matrix_node->stats, frame.outcome);
+                if constexpr (IsVirtualLossBanditTypes<Types>)
+                {
+                    if (virtual_loss > 0)
+                    {
+                        this->apply_virtual_loss(matrix_node->stats, frame.outcome, virtual_loss, mutex);
+                    }
+                }
+
+                frame.chance_node = matrix_node->access(frame.outcome.row_idx, frame.outcome.col_idx);
+
+                if constexpr (!std::is_same_v<typename Options::NodeActions, void>)
+                {
+                    state.apply_actions(
+                        matrix_node->row_actions[frame.outcome.row_idx],
+                        matrix_node->col_actions[frame.outcome.col_idx]);
+                }
+                else
+                {
+                    state.apply_actions(
+                        state.row_actions[frame.outcome.row_idx],
+                        state.col_actions[frame.outcome.col_idx]);
+                    state.get_actions();
+                }
+
+                if constexpr (IsTranspositionNodeTypes<NodePair<Types, MatrixStats, ChanceStats, typename Options::NodeActions>> &&
+                              IsHashableStateTypes<Types>)
+                {
+                    if constexpr (!std::is_same_v<typename Options::NodeActions, void>)
+                    {
+                        // the action counts tell apart states whose hashes collide
+                        state.get_actions();
+                    }
+                    matrix_node = frame.chance_node->access(
+                        state.get_obs(), state.get_hash(), state.row_actions.size(), state.col_actions.size());
+                }
+                else
+                {
+                    matrix_node = frame.chance_node->access(state.get_obs());
+                }
+            }
+        }
+
+        void backpropagate(
+            Path &path,
+            const Types::ModelOutput &model_output) const
+        {
+            for (size_t frame_idx = path.frames.size(); frame_idx-- > 0;)
+            {
+                Frame &frame = path.frames[frame_idx];
+                if constexpr (std::is_same_v<typename Options::update_using_average, void>)
+                {
+                    frame.outcome.value = model_output.value;
+                }
+                else
+                {
+                    const MatrixNode *matrix_node_next =
+                        (frame_idx + 1 < path.frames.size()) ? path.frames[frame_idx + 1].matrix_node : path.leaf;
+                    this->get_empirical_value(matrix_node_next->stats, frame.outcome.value);
+                }
+                if constexpr (IsVirtualLossBanditTypes<Types>)
+                {
+                    if (virtual_loss > 0)
+                    {
+                        this->revert_virtual_loss(frame.matrix_node->stats, frame.outcome, virtual_loss, mutex);
+                    }
+                }
+                this->update_matrix_stats(frame.matrix_node->stats, frame.outcome);
+                this->update_chance_stats(frame.chance_node->stats, frame.outcome);
+            }
+        }
+    };
+};
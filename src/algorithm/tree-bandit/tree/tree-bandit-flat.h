@@ -1,4 +1,21 @@
-#include <unordered_map>
+#pragma once
+
+#include <types/random.h>
+
+#include <vector>
+
+/*
+
+Tree bandit search where the tree is stored in flat arrays owned by the search, rather than in linked nodes.
+
+Matrix nodes are indices into `matrix_data`, and node 0 is the root. A transition (parent, row_idx, col_idx, obs) is
+mapped to its child index by an open addressing hash table with linear probing. The table stores the full transition,
+so two transitions are only merged if they are equal.
+
+The storage is kept between calls to `run_for_iterations`. Clearing the table is O(1) since a slot is only occupied if
+its generation is the current one, and a node's data is reset when its index is handed out again.
+
+*/
 
 template <
     typename Types,
@@ -35,6 +52,90 @@ struct TreeBanditFlat : Types
 
     using MatrixData = MData<typename Types::MatrixStats, typename Options::NodeActions, typename Options::NodeValue>;
 
+    class TransitionTable
+    {
+    public:
+        struct Slot
+        {
+            uint32_t generation = 0;
+            int parent;
+            int row_idx;
+            int col_idx;
+            int child;
+            uint64_t hash;
+            typename Types::Obs obs;
+        };
+
+        std::vector<Slot> slots{};
+        size_t size = 0;
+        uint32_t generation = 1;
+
+        // Returns the child of the transition. If the transition is new, it is inserted with `child`
+        int get(
+            const int parent,
+            const int row_idx,
+            const int col_idx,
+            const Types::Obs &obs,
+            const uint64_t hash,
+            const int child)
+        {
+            // the load factor is at most 1/2
+            if (2 * (size + 1) > slots.size())
+            {
+                grow();
+            }
+            const size_t mask = slots.size() - 1;
+            for (size_t i = hash & mask;; i = (i + 1) & mask)
+            {
+                Slot &slot = slots[i];
+                if (slot.generation != generation)
+                {
+                    slot = Slot{generation, parent, row_idx, col_idx, child, hash, obs};
+                    ++size;
+                    return child;
+                }
+                if (slot.hash == hash && slot.parent == parent && slot.row_idx == row_idx &&
+                    slot.col_idx == col_idx && slot.obs == obs)
+                {
+                    return slot.child;
+                }
+            }
+        }
+
+        void clear()
+        {
+            size = 0;
+            if (++generation == 0)
+            {
+                for (Slot &slot : slots)
+                {
+                    slot.generation = 0;
+                }
+                generation = 1;
+            }
+        }
+
+    private:
+        void grow()
+        {
+            std::vector<Slot> old_slots(std::max(slots.size() * 2, size_t{1 << 10}));
+            std::swap(slots, old_slots);
+            const size_t mask = slots.size() - 1;
+            for (const Slot &slot : old_slots)
+            {
+                if (slot.generation == generation)
+                {
+                    size_t i = slot.hash & mask;
+                    while (slots[i].generation == generation)
+                    {
+                        i = (i + 1) & mask;
+                    }
+                    slots[i] = slot;
+                }
+            }
+        }
+    };
+
     class Search : public Types::BanditAlgorithm
     {
     public:
@@ -42,14 +143,19 @@ struct TreeBanditFlat : Types
 
         Search(const Types::BanditAlgorithm &base) : Types::BanditAlgorithm{base} {}
 
-        std::array<MatrixData, Options::max_iterations> matrix_data{};
-
-        // reset every run call
-        size_t iteration = 0;
+        // side by side: was_seen and is_expanded (state, e.g. expanded vectors)
+        struct NodeInfo
+        {
+            bool seen = false;
+            bool expanded = false;
+        };
 
-        bool info[2 * Options::max_iterations];
+        // grows as needed and is kept between runs. Only the first `n_nodes` entries belong to the current tree
+        std::vector<MatrixData> matrix_data{};
+        std::vector<NodeInfo> info{};
+        size_t n_nodes = 0;
 
-        std::unordered_map<uint64_t, int> transition{};
+        TransitionTable transition{};
 
         // reset every iteration
         int depth = 0;
@@ -61,7 +167,9 @@ struct TreeBanditFlat : Types
 
         std::array<typename Types::Outcome, Options::max_depth> outcomes{};
 
-        std::array<int, Options::max_depth> matrix_indices{};
+        // the node at each depth of the descent. One longer than `outcomes`, since a descent that stops at `max_depth`
+        // still records the node it stopped at
+        std::array<int, Options::max_depth + 1> matrix_indices{};
 
         size_t run_for_iterations(
             const size_t iterations,
@@ -69,12 +177,14 @@ struct TreeBanditFlat : Types
             const Types::State &state,
             Types::Model &model)
         {
-            transition = std::unordered_map<uint64_t, int>{};
-            memset(info, false, 2 * Options::max_iterations * sizeof(bool));
+            transition.clear();
+            n_nodes = 0;
+            new_node();
             const auto start = std::chrono::high_resolution_clock::now();
-            for (iteration = 0; iteration < iterations; ++iteration)
+            IterationState<Types> iteration_state{state};
+            for (size_t iteration = 0; iteration < iterations; ++iteration)
             {
-                typename Types::State state_copy = state;
+                typename Types::State &state_copy = iteration_state.reset();
                 state_copy.randomize_transition(device);
                 run_iteration(device, state_copy, model);
             }
@@ -91,21 +201,17 @@ struct TreeBanditFlat : Types
             depth = 0;
             index = 0;
 
-            // side by side: was_seen and is_expanded (state, e.g. expanded vectors)
-            bool *info_ptr = &info[2 * index];
-
-            while (*info_ptr && !state.is_terminal() && depth < Options::max_depth)
+            while (info[index].seen && !state.is_terminal() && depth < Options::max_depth)
             {
                 typename Types::Outcome &outcome = outcomes[depth];
-                typename Types::MatrixStats &stats = matrix_data[index].stats;
                 MatrixData &current_data = matrix_data[index];
 
                 // not really expanded
-                if (!*(info_ptr + 1))
+                if (!info[index].expanded)
                 {
                     if constexpr (!std::is_same_v<typename Options::NodeActions, void>)
                     {
-                        state.get_actions(matrix_data[index].row_actions, current_data.col_actions);
+                        state.get_actions(current_data.row_actions, current_data.col_actions);
                         rows = current_data.row_actions.size();
                         cols = current_data.col_actions.size();
                     }
@@ -114,11 +220,11 @@ struct TreeBanditFlat : Types
                         rows = state.row_actions.size();
                         cols = state.col_actions.size();
                     }
-                    this->expand_state_part(stats, rows, cols);
-                    *(info_ptr + 1) = true;
+                    this->expand_state_part(current_data.stats, rows, cols);
+                    info[index].expanded = true;
                 }
 
-                this->select(device, stats, outcome);
+                this->select(device, current_data.stats, outcome);
 
                 if constexpr (!std::is_same_v<typename Options::NodeActions, void>)
                 {
@@ -135,24 +241,24 @@ struct TreeBanditFlat : Types
                 }
 
                 ++depth;
-                uint64_t hash_ = hash(index, outcome.row_idx, outcome.col_idx, hash_function(state.get_obs()));
-
-                if (transition[hash_] == 0)
+                const uint64_t hash_ = hash(index, outcome.row_idx, outcome.col_idx, hash_function(state.get_obs()));
+                const int child = transition.get(index, outcome.row_idx, outcome.col_idx, state.get_obs(), hash_,
+                                                 static_cast<int>(n_nodes));
+                // `current_data` may be invalidated from here on
+                const bool is_new = child == static_cast<int>(n_nodes);
+                if (is_new)
                 {
-                    index = iteration;
-                    transition[hash_] = iteration;
-                    info_ptr = &info[2 * index];
-                    if constexpr (std::is_same_v<typename Options::return_after_expand, void>)
+                    new_node();
+                }
+                index = child;
+                matrix_indices[depth] = index;
+                if constexpr (std::is_same_v<typename Options::return_after_expand, void>)
+                {
+                    if (is_new)
                     {
                         break;
                     }
                 }
-                else
-                {
-                    index = transition[hash_];
-                    info_ptr = &info[2 * index];
-                }
-                matrix_indices[depth] = index;
             }
 
             if (state.is_terminal())
@@ -161,7 +267,7 @@ struct TreeBanditFlat : Types
             }
             else
             {
-                *info_ptr = true;
+                info[index].seen = true;
                 model.inference(std::move(state), leaf_output);
             }
 
@@ -179,7 +285,7 @@ struct TreeBanditFlat : Types
                 }
                 else
                 {
-                    // TODO fix!! check d + 1
+                    // the child that outcome `d` led to
                     this->get_empirical_value(matrix_data[matrix_indices[d + 1]].stats, outcomes[d].value);
                 }
 
@@ -193,13 +299,25 @@ struct TreeBanditFlat : Types
             const int col_idx,
             const uint64_t obs_hash) const
         {
-            size_t h = 17;
-            h = h * 31 + index;
-            h = h * 31 + row_idx;
-            h = h * 31 + col_idx;
-            h = h * 31 + static_cast<uint64_t>(obs_hash);
-            h = h * 31 + static_cast<uint64_t>(obs_hash >> 32);
-            return h;
+            uint64_t h = static_cast<uint64_t>(index) << 32 ^ static_cast<uint64_t>(row_idx) << 16 ^ col_idx;
+            h = splitmix64(h) ^ obs_hash;
+            return splitmix64(h);
+        }
+
+    private:
+        void new_node()
+        {
+            if (n_nodes < matrix_data.size())
+            {
+                matrix_data[n_nodes] = MatrixData{};
+                info[n_nodes] = NodeInfo{};
+            }
+            else
+            {
+                matrix_data.emplace_back();
+                info.emplace_back();
+            }
+            ++n_nodes;
         }
     };
 };
@@ -2,6 +2,7 @@
 
 #include <types/types.h>
 #include <algorithm/algorithm.h>
+#include <libpinyon/deadline.h>
 #include <types/matrix.h>
 
 #include <tree/tree.h>
@@ -38,6 +39,9 @@ struct TreeBanditRootMatrix : Types
             return os;
         }
 
+        // if set, `run` returns early once the flag is true
+        const std::atomic<bool> *stop_flag = nullptr;
+
         size_t run(
             size_t duration_ms,
             Types::PRNG &device,
@@ -48,18 +52,15 @@ struct TreeBanditRootMatrix : Types
             this->empirical_matrix.clear();
             this->empirical_matrix.fill(state.row_actions.size(), state.col_actions.size());
 
-            auto start = std::chrono::high_resolution_clock::now();
-            auto end = std::chrono::high_resolution_clock::now();
-            auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
+            Deadline deadline{duration_ms, stop_flag};
             typename Types::ModelOutput model_output;
             size_t iterations = 0;
-            for (; duration.count() < duration_ms; ++iterations)
+            IterationState<Types> iteration_state{state};
+            for (; !deadline.expired(); ++iterations)
             {
-                typename Types::State state_copy = state;
+                typename Types::State &state_copy = iteration_state.reset();
                 state_copy.randomize_transition(device);
                 this->run_iteration<true>(device, state_copy, model, &matrix_node, model_output);
-                end = std::chrono::high_resolution_clock::now();
-                duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
             }
             return iterations;
         }
@@ -76,9 +77,10 @@ struct TreeBanditRootMatrix : Types
 
             const auto start = std::chrono::high_resolution_clock::now();
             typename Types::ModelOutput model_output;
+            IterationState<Types> iteration_state{state};
             for (size_t iteration = 0; iteration < iterations; ++iteration)
             {
-                typename Types::State state_copy = state;
+                typename Types::State &state_copy = iteration_state.reset();
                 state_copy.randomize_transition(device);
                 this->run_iteration<true>(device, state_copy, model, &matrix_node, model_output);
             }
@@ -96,6 +98,10 @@ struct TreeBanditRootMatrix : Types
             MatrixNode *matrix_node,
             Types::ModelOutput &model_output)
         {
+            if constexpr (IS_ROOT && IsDescentNodeTypes<NodePair<Types, typename Types::MatrixStats, typename Types::ChanceStats, typename Options::NodeActions>>)
+            {
+                matrix_node->begin_descent();
+            }
             if (state.is_terminal())
             {
                 matrix_node->set_terminal();
@@ -156,7 +162,22 @@ struct TreeBanditRootMatrix : Types
                         state.get_actions();
                     }
 
-                    MatrixNode *matrix_node_next = chance_node->access(state.get_obs());
+                    MatrixNode *matrix_node_next;
+                    if constexpr (IsTranspositionNodeTypes<NodePair<Types, typename Types::MatrixStats, typename Types::ChanceStats, typename Options::NodeActions>> &&
+                                  IsHashableStateTypes<Types>)
+                    {
+                        if constexpr (!std::is_same_v<typename Options::NodeActions, void>)
+                        {
+                            // the action counts tell apart states whose hashes collide
+                            state.get_actions();
+                        }
+                        matrix_node_next = chance_node->access(
+                            state.get_obs(), state.get_hash(), state.row_actions.size(), state.col_actions.size());
+                    }
+                    else
+                    {
+                        matrix_node_next = chance_node->access(state.get_obs());
+                    }
 
                     MatrixNode *matrix_node_leaf = run_iteration<false>(device, state, model, matrix_node_next, model_output);
 
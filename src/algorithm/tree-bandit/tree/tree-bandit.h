@@ -2,10 +2,12 @@
 
 #include <types/types.h>
 #include <algorithm/algorithm.h>
+#include <libpinyon/deadline.h>
 
 #include <tree/tree.h>
 
 #include <chrono>
+#include <vector>
 
 template <
     IsBanditAlgorithmTypes Types,
@@ -17,6 +19,15 @@ struct TreeBandit : Types
 {
     using MatrixNode = NodePair<Types, typename Types::MatrixStats, typename Types::ChanceStats, typename Options::NodeActions>::MatrixNode;
     using ChanceNode = NodePair<Types, typename Types::MatrixStats, typename Types::ChanceStats, typename Options::NodeActions>::ChanceNode;
+
+    // one level of the descent; iterations keep an explicit stack of these instead of recursing
+    struct Frame
+    {
+        MatrixNode *matrix_node;
+        ChanceNode *chance_node;
+        typename Types::Outcome outcome;
+    };
+
     class Search : public Types::BanditAlgorithm
     {
     public:
@@ -32,6 +43,9 @@ struct TreeBandit : Types
             return os;
         }
 
+        // if set, `run` returns early once the flag is true
+        const std::atomic<bool> *stop_flag = nullptr;
+
         size_t run(
             size_t duration_ms,
             Types::PRNG &device,
@@ -39,18 +53,16 @@ struct TreeBandit : Types
             Types::Model &model,
             MatrixNode &matrix_node) const
         {
-            auto start = std::chrono::high_resolution_clock::now();
-            auto end = std::chrono::high_resolution_clock::now();
-            auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
+            Deadline deadline{duration_ms, stop_flag};
             typename Types::ModelOutput model_output;
+            std::vector<Frame> path{};
             size_t iterations = 0;
-            for (; duration.count() < duration_ms; ++iterations)
+            IterationState<Types> iteration_state{state};
+            for (; !deadline.expired(); ++iterations)
             {
-                typename Types::State state_copy = state;
+                typename Types::State &state_copy = iteration_state.reset();
                 state_copy.randomize_transition(device);
-                this->run_iteration(device, state_copy, model, &matrix_node, model_output);
-                end = std::chrono::high_resolution_clock::now();
-                duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
+                this->run_iteration(device, state_copy, model, &matrix_node, model_output, path);
             }
             return iterations;
         }
@@ -64,11 +76,13 @@ struct TreeBandit : Types
         {
             const auto start = std::chrono::high_resolution_clock::now();
             typename Types::ModelOutput model_output;
+            std::vector<Frame> path{};
+            IterationState<Types> iteration_state{state};
             for (size_t iteration = 0; iteration < iterations; ++iteration)
             {
-                typename Types::State state_copy = state;
+                typename Types::State &state_copy = iteration_state.reset();
                 state_copy.randomize_transition(device);
-                this->run_iteration(device, state_copy, model, &matrix_node, model_output);
+                this->run_iteration(device, state_copy, model, &matrix_node, model_output, path);
             }
             const auto end = std::chrono::high_resolution_clock::now();
             const auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
@@ -76,21 +90,28 @@ struct TreeBandit : Types
         }
 
     protected:
+        // Selects down to an unexpanded or terminal node, then backpropagates along `path`. Returns the leaf
         MatrixNode *run_iteration(
             Types::PRNG &device,
             Types::State &state,
             Types::Model &model,
             MatrixNode *matrix_node,
-            Types::ModelOutput &model_output) const
+            Types::ModelOutput &model_output,
+            std::vector<Frame> &path) const
         {
-            if (state.is_terminal())
+            if constexpr (IsDescentNodeTypes<NodePair<Types, typename Types::MatrixStats, typename Types::ChanceStats, typename Options::NodeActions>>)
             {
-                matrix_node->set_terminal();
-                model_output.value = state.get_payoff();
-                return matrix_node;
+                matrix_node->begin_descent();
             }
-            else
+            path.clear();
+            while (true)
             {
+                if (state.is_terminal())
+                {
+                    matrix_node->set_terminal();
+                    model_output.value = state.get_payoff();
+                    break;
+                }
                 if (!matrix_node->is_expanded())
                 {
                     if constexpr (!std::is_same_v<typename Options::NodeActions, void>)
@@ -119,48 +140,65 @@ struct TreeBandit : Types
                     }
                     if constexpr (std::is_same_v<typename Options::return_after_expand, void>)
                     {
-                        return matrix_node;
+                        break;
                     }
                 }
+
+                Frame &frame = path.emplace_back();
+                frame.matrix_node = matrix_node;
+                this->select(device, matrix_node->stats, frame.outcome);
+
+                frame.chance_node = matrix_node->access(frame.outcome.row_idx, frame.outcome.col_idx);
+
+                if constexpr (!std::is_same_v<typename Options::NodeActions, void>)
+                {
+                    state.apply_actions(
+                        matrix_node->row_actions[frame.outcome.row_idx],
+                        matrix_node->col_actions[frame.outcome.col_idx]);
+                }
                 else
                 {
-                    typename Types::Outcome outcome;
-                    this->select(device, matrix_node->stats, outcome);
-
-                    ChanceNode *chance_node = matrix_node->access(outcome.row_idx, outcome.col_idx);
+                    state.apply_actions(
+                        state.row_actions[frame.outcome.row_idx],
+                        state.col_actions[frame.outcome.col_idx]);
+                    state.get_actions();
+                }
 
+                if constexpr (IsTranspositionNodeTypes<NodePair<Types, typename Types::MatrixStats, typename Types::ChanceStats, typename Options::NodeActions>> &&
+                              IsHashableStateTypes<Types>)
+                {
                     if constexpr (!std::is_same_v<typename Options::NodeActions, void>)
                     {
-                        state.apply_actions(
-                            matrix_node->row_actions[outcome.row_idx],
-                            matrix_node->col_actions[outcome.col_idx]);
-                    }
-                    else
-                    {
-                        state.apply_actions(
-                            state.row_actions[outcome.row_idx],
-                            state.col_actions[outcome.col_idx]);
+                        // the action counts tell apart states whose hashes collide
                         state.get_actions();
                     }
+                    matrix_node = frame.chance_node->access(
+                        state.get_obs(), state.get_hash(), state.row_actions.size(), state.col_actions.size());
+                }
+                else
+                {
+                    matrix_node = frame.chance_node->access(state.get_obs());
+                }
+            }
 
-                    MatrixNode *matrix_node_next = chance_node->access(state.get_obs());
-
-                    MatrixNode *matrix_node_leaf = run_iteration(device, state, model, matrix_node_next, model_output);
-
-                    if constexpr (std::is_same_v<typename Options::update_using_average, void>)
-                    {
-                        outcome.value = model_output.value;
-                    }
-                    else
-                    {
-                        this->get_empirical_value(matrix_node_next->stats, outcome.value);
-                    }
-
-                    this->update_matrix_stats(matrix_node->stats, outcome);
-                    this->update_chance_stats(chance_node->stats, outcome);
-                    return matrix_node_leaf;
+            MatrixNode *matrix_node_next = matrix_node;
+            for (size_t frame_idx = path.size(); frame_idx-- > 0;)
+            {
+                Frame &frame = path[frame_idx];
+                if constexpr (std::is_same_v<typename Options::update_using_average, void>)
+                {
+                    frame.outcome.value = model_output.value;
                 }
+                else
+                {
+                    this->get_empirical_value(matrix_node_next->stats, frame.outcome.value);
+                }
+
+                this->update_matrix_stats(frame.matrix_node->stats, frame.outcome);
+                this->update_chance_stats(frame.chance_node->stats, frame.outcome);
+                matrix_node_next = frame.matrix_node;
             }
+            return matrix_node;
         }
     };
 };
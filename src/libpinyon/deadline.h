@@ -0,0 +1,153 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <limits>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+/*
+
+Time limit for the loop of a timed search.
+
+Reading the clock after every iteration is a measurable cost when iterations take ~100ns. `expired()` instead
+reads the clock only every `interval` calls, where `interval` is re-estimated at each read from the measured
+iteration rate so that the clock is read roughly every `resolution` (and never planned past the deadline).
+
+An optional stop flag is checked on every call, so another thread can end the search early.
+
+*/
+
+template <typename Clock = std::chrono::steady_clock>
+class Deadline
+{
+public:
+    static constexpr std::chrono::microseconds resolution{100};
+    static constexpr size_t max_interval = size_t{1} << 16;
+
+    Deadline(const size_t duration_ms, const std::atomic<bool> *stop_flag = nullptr)
+        : Deadline{std::chrono::milliseconds{static_cast<std::chrono::milliseconds::rep>(
+                       std::min<size_t>(duration_ms, std::numeric_limits<std::chrono::milliseconds::rep>::max()))},
+                   stop_flag}
+    {
+    }
+
+    // A duration too long for the clock never expires
+    template <typename Rep, typename Period>
+    Deadline(const std::chrono::duration<Rep, Period> duration, const std::atomic<bool> *stop_flag = nullptr)
+        : stop_flag{stop_flag},
+          last_check{Clock::now()},
+          end{saturating_add(last_check, duration)}
+    {
+    }
+
+    // Call once before each iteration. Once this returns true it always will
+    inline bool expired()
+    {
+        if (stop_flag != nullptr && stop_flag->load(std::memory_order_relaxed)) [[unlikely]]
+        {
+            done = true;
+        }
+        if (done || ++count < interval) [[likely]]
+        {
+            return done;
+        }
+        return check();
+    }
+
+private:
+    const std::atomic<bool> *stop_flag;
+    typename Clock::time_point last_check;
+    const typename Clock::time_point end;
+    size_t count = 0;
+    size_t interval = 1;
+    bool done = false;
+
+    template <typename Rep, typename Period>
+    static typename Clock::time_point saturating_add(
+        const typename Clock::time_point start,
+        const std::chrono::duration<Rep, Period> duration)
+    {
+        // compared in the units of `duration`, since converting it to clock ticks could overflow
+        if (duration >= std::chrono::duration_cast<std::chrono::duration<Rep, Period>>(Clock::time_point::max() - start))
+        {
+            return Clock::time_point::max();
+        }
+        return start + std::chrono::duration_cast<typename Clock::duration>(duration);
+    }
+
+    bool check()
+    {
+        const auto now = Clock::now();
+        if (now >= end)
+        {
+            done = true;
+            return true;
+        }
+        const auto elapsed = (now - last_check).count();
+        const auto target = std::min(
+                                std::chrono::duration_cast<typename Clock::duration>(resolution),
+                                end - now)
+                                .count();
+        if (elapsed > 0)
+        {
+            // calls that fit in `target` at the rate measured since the last check
+            const double estimate = static_cast<double>(count) * target / elapsed;
+            interval = std::clamp(static_cast<size_t>(estimate), size_t{1}, max_interval);
+        }
+        else
+        {
+            interval = std::min(interval * 2, max_interval);
+        }
+        count = 0;
+        last_check = now;
+        return false;
+    }
+};
+
+#if defined(__x86_64__) || defined(__i386__)
+
+/*
+
+Clock backed by the time stamp counter, e.g. `Deadline<TSCClock>`. Ticks are converted to nanoseconds with a
+ratio measured against steady_clock the first time it is used (which takes about a millisecond).
+Assumes an invariant TSC, as on any recent x86 processor.
+
+*/
+
+struct TSCClock
+{
+    using duration = std::chrono::nanoseconds;
+    using rep = duration::rep;
+    using period = duration::period;
+    using time_point = std::chrono::time_point<TSCClock>;
+    static constexpr bool is_steady = true;
+
+    static time_point now()
+    {
+        return time_point{duration{static_cast<rep>(static_cast<double>(__rdtsc()) * ns_per_tick())}};
+    }
+
+private:
+    static double ns_per_tick()
+    {
+        static const double ratio = []
+        {
+            const auto start = std::chrono::steady_clock::now();
+            const auto start_ticks = __rdtsc();
+            while (std::chrono::steady_clock::now() - start < std::chrono::milliseconds{1})
+            {
+            }
+            const auto end_ticks = __rdtsc();
+            const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+            return static_cast<double>(ns.count()) / static_cast<double>(end_ticks - start_ticks);
+        }();
+        return ratio;
+    }
+};
+
+#endif
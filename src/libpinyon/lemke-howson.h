@@ -0,0 +1,347 @@
+#pragma once
+
+#include <types/types.h>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+/*
+
+Lemke-Howson for bimatrix games with floating point payoffs. It finds one Nash equilibrium in double precision,
+without the discretization and GMP round trip of lrs. Constant-sum games are bimatrix games too, so their unique value
+is found exactly (up to rounding).
+
+Payoffs are rescaled to [1, 2] so both tableaux are positive and the tolerance does not depend on the payoff range.
+Ties in the ratio test are broken lexicographically, so degenerate games (e.g. a matrix of equal entries) cannot cycle.
+
+*/
+
+namespace LemkeHowson {
+
+namespace detail {
+
+// Rows of `M v + I w = 1` for one player. Columns are indexed by label, followed by the right hand side
+struct Tableau {
+    size_t rows;
+    size_t labels;
+    // first label of the slack identity columns
+    size_t slack_begin;
+    std::vector<double> data;
+    // label of the basic variable of each row
+    std::vector<size_t> basis;
+
+    static constexpr double eps = 1e-12;
+
+    Tableau(size_t rows, size_t labels, size_t slack_begin)
+        : rows{rows}, labels{labels}, slack_begin{slack_begin}, data((labels + 1) * rows), basis(rows) {
+        for (size_t row_idx = 0; row_idx < rows; ++row_idx) {
+            at(row_idx, slack_begin + row_idx) = 1;
+            at(row_idx, labels) = 1;
+            basis[row_idx] = slack_begin + row_idx;
+        }
+    }
+
+    inline double &at(size_t row_idx, size_t label) { return data[row_idx * (labels + 1) + label]; }
+
+    // true if `row_idx` is lexicographically smaller than `best_idx` in (rhs, slack columns) / pivot column
+    bool lex_less(size_t row_idx, size_t best_idx, size_t entering) {
+        const double a = at(row_idx, entering);
+        const double b = at(best_idx, entering);
+        for (size_t k = 0; k <= rows; ++k) {
+            const size_t label = (k == 0) ? labels : slack_begin + k - 1;
+            const double x = at(row_idx, label) / a;
+            const double y = at(best_idx, label) / b;
+            if (x < y - eps) {
+                return true;
+            }
+            if (x > y + eps) {
+                return false;
+            }
+        }
+        return false;
+    }
+
+    // Brings `entering` into the basis and returns the label that left it
+    size_t pivot(size_t entering) {
+        size_t best_idx = rows;
+        for (size_t row_idx = 0; row_idx < rows; ++row_idx) {
+            if (at(row_idx, entering) > eps && (best_idx == rows || lex_less(row_idx, best_idx, entering))) {
+                best_idx = row_idx;
+            }
+        }
+        // the tableaux are positive, so some row always limits the entering variable
+        const double a = at(best_idx, entering);
+        for (size_t label = 0; label <= labels; ++label) {
+            at(best_idx, label) /= a;
+        }
+        for (size_t row_idx = 0; row_idx < rows; ++row_idx) {
+            const double f = at(row_idx, entering);
+            if (row_idx == best_idx || f == 0) {
+                continue;
+            }
+            for (size_t label = 0; label <= labels; ++label) {
+                at(row_idx, label) -= f * at(best_idx, label);
+            }
+        }
+        const size_t leaving = basis[best_idx];
+        basis[best_idx] = entering;
+        return leaving;
+    }
+
+    // Normalized values of the basic variables with labels in [begin, begin + size)
+    template <typename Vector>
+    void get_strategy(size_t begin, size_t size, Vector &strategy) {
+        strategy.resize(size);
+        std::vector<double> x(size, 0);
+        double sum = 0;
+        for (size_t row_idx = 0; row_idx < rows; ++row_idx) {
+            const size_t label = basis[row_idx];
+            if (label >= begin && label < begin + size) {
+                x[label - begin] = std::max(at(row_idx, labels), 0.0);
+                sum += x[label - begin];
+            }
+        }
+        for (size_t idx = 0; idx < size; ++idx) {
+            strategy[idx] = static_cast<typename Vector::value_type>(x[idx] / sum);
+        }
+    }
+};
+
+template <template <typename...> typename Vector, template <typename...> typename Matrix,
+          template <typename> typename Value, typename Real>
+Value<Real> get_payoff(const Matrix<Value<Real>> &payoff_matrix, const Vector<Real> &row_strategy,
+                       const Vector<Real> &col_strategy) {
+    const size_t rows = payoff_matrix.rows;
+    const size_t cols = payoff_matrix.cols;
+    Real row_payoff{0}, col_payoff{0};
+    for (size_t row_idx = 0; row_idx < rows; ++row_idx) {
+        for (size_t col_idx = 0; col_idx < cols; ++col_idx) {
+            const Value<Real> &value = payoff_matrix[row_idx * cols + col_idx];
+            const Real p = row_strategy[row_idx] * col_strategy[col_idx];
+            row_payoff += p * value.get_row_value();
+            col_payoff += p * value.get_col_value();
+        }
+    }
+
+    if constexpr (Value<Real>::IS_CONSTANT_SUM == true) {
+        return {row_payoff};
+    } else {
+        return {row_payoff, col_payoff};
+    }
+}
+
+// Solves the square system `m x = rhs` in place by Gaussian elimination; `rhs` becomes x. False if it is singular
+inline bool solve_linear(const size_t n, std::vector<double> &m, std::vector<double> &rhs) {
+    for (size_t k = 0; k < n; ++k) {
+        size_t pivot = k;
+        for (size_t r = k + 1; r < n; ++r) {
+            if (std::abs(m[r * n + k]) > std::abs(m[pivot * n + k])) {
+                pivot = r;
+            }
+        }
+        if (std::abs(m[pivot * n + k]) < Tableau::eps) {
+            return false;
+        }
+        if (pivot != k) {
+            std::swap_ranges(m.begin() + k * n, m.begin() + (k + 1) * n, m.begin() + pivot * n);
+            std::swap(rhs[k], rhs[pivot]);
+        }
+        for (size_t r = k + 1; r < n; ++r) {
+            const double f = m[r * n + k] / m[k * n + k];
+            for (size_t c = k; c < n; ++c) {
+                m[r * n + c] -= f * m[k * n + c];
+            }
+            rhs[r] -= f * rhs[k];
+        }
+    }
+    for (size_t k = n; k-- > 0;) {
+        for (size_t c = k + 1; c < n; ++c) {
+            rhs[k] -= m[k * n + c] * rhs[c];
+        }
+        rhs[k] /= m[k * n + k];
+    }
+    return true;
+}
+
+};  // namespace detail
+
+// Row strategy labels are [0, rows), column strategy labels are [rows, rows + cols). `missing_label` is dropped first
+template <template <typename...> typename Vector, template <typename...> typename Matrix,
+          template <typename> typename Value, typename Real>
+    requires std::is_floating_point_v<Real>
+Value<Real> solve(const Matrix<Value<Real>> &payoff_matrix, Vector<Real> &row_strategy, Vector<Real> &col_strategy,
+                  const size_t missing_label = 0) {
+    const size_t rows = payoff_matrix.rows;
+    const size_t cols = payoff_matrix.cols;
+    const size_t entries = rows * cols;
+    const size_t labels = rows + cols;
+
+    double row_min = payoff_matrix[0].get_row_value(), row_max = row_min;
+    double col_min = payoff_matrix[0].get_col_value(), col_max = col_min;
+    for (size_t i = 0; i < entries; ++i) {
+        const double u = payoff_matrix[i].get_row_value();
+        const double v = payoff_matrix[i].get_col_value();
+        row_min = std::min(row_min, u);
+        row_max = std::max(row_max, u);
+        col_min = std::min(col_min, v);
+        col_max = std::max(col_max, v);
+    }
+    const double row_range = (row_max == row_min) ? 1 : row_max - row_min;
+    const double col_range = (col_max == col_min) ? 1 : col_max - col_min;
+
+    // column player's constraints B^T x + r = 1, and row player's A y + s = 1
+    detail::Tableau x_tableau{cols, labels, rows};
+    detail::Tableau y_tableau{rows, labels, 0};
+    for (size_t row_idx = 0; row_idx < rows; ++row_idx) {
+        for (size_t col_idx = 0; col_idx < cols; ++col_idx) {
+            const Value<Real> &value = payoff_matrix[row_idx * cols + col_idx];
+            x_tableau.at(col_idx, row_idx) = (value.get_col_value() - col_min) / col_range + 1;
+            y_tableau.at(row_idx, rows + col_idx) = (value.get_row_value() - row_min) / row_range + 1;
+        }
+    }
+
+    size_t entering = missing_label;
+    bool x_side = entering < rows;
+    while (true) {
+        const size_t leaving = (x_side ? x_tableau : y_tableau).pivot(entering);
+        if (leaving == missing_label) {
+            break;
+        }
+        entering = leaving;
+        x_side = !x_side;
+    }
+
+    x_tableau.get_strategy(0, rows, row_strategy);
+    y_tableau.get_strategy(rows, cols, col_strategy);
+
+    return detail::get_payoff(payoff_matrix, row_strategy, col_strategy);
+}
+
+/*
+
+Warm started solves of a matrix that changes a little between calls, e.g. the UCB matrix of a MatrixUCB node.
+The supports of the last equilibrium are kept. The next solve first assumes the same supports and solves the
+indifference conditions, one small linear system per player. If the result is an equilibrium of the new matrix it is
+returned, otherwise the matrix is solved from scratch with Lemke-Howson and the supports are updated.
+
+*/
+
+class WarmStart {
+    std::vector<size_t> row_support{};
+    std::vector<size_t> col_support{};
+    // scratch space for the linear systems
+    std::vector<double> system{};
+    std::vector<double> solution{};
+
+    static constexpr double eps = 1e-9;
+
+    // Strategy of the player choosing among `support` that makes every action in `other_support` indifferent.
+    // `get(own_idx, other_idx)` is the other player's payoff. Returns the other player's payoff, or NaN on failure
+    template <typename Get, typename Vector>
+    double solve_indifference(const std::vector<size_t> &support, const std::vector<size_t> &other_support,
+                              const size_t actions, const Get &get, Vector &strategy) {
+        const size_t k = support.size();
+        const size_t n = k + 1;
+        system.assign(n * n, 0);
+        solution.assign(n, 0);
+        for (size_t e = 0; e < k; ++e) {
+            for (size_t v = 0; v < k; ++v) {
+                system[e * n + v] = get(support[v], other_support[e]);
+            }
+            system[e * n + k] = -1;
+            system[k * n + e] = 1;
+        }
+        solution[k] = 1;
+        if (!detail::solve_linear(n, system, solution)) {
+            return NAN;
+        }
+        strategy.resize(actions);
+        std::fill(strategy.begin(), strategy.end(), typename Vector::value_type{0});
+        for (size_t v = 0; v < k; ++v) {
+            if (solution[v] < -eps) {
+                return NAN;
+            }
+            strategy[support[v]] = static_cast<typename Vector::value_type>(std::max(solution[v], 0.0));
+        }
+        return solution[k];
+    }
+
+    template <typename Vector>
+    static void get_support(const Vector &strategy, std::vector<size_t> &support) {
+        support.clear();
+        for (size_t idx = 0; idx < strategy.size(); ++idx) {
+            if (strategy[idx] > eps) {
+                support.push_back(idx);
+            }
+        }
+    }
+
+    template <template <typename...> typename Vector, template <typename...> typename Matrix,
+              template <typename> typename Value, typename Real>
+    bool solve_on_supports(const Matrix<Value<Real>> &payoff_matrix, Vector<Real> &row_strategy,
+                           Vector<Real> &col_strategy) {
+        const size_t rows = payoff_matrix.rows;
+        const size_t cols = payoff_matrix.cols;
+        if (row_support.empty() || row_support.size() != col_support.size() || row_support.back() >= rows ||
+            col_support.back() >= cols) {
+            return false;
+        }
+        const double col_payoff = solve_indifference(
+            row_support, col_support, rows,
+            [&payoff_matrix, cols](size_t row_idx, size_t col_idx) {
+                return static_cast<double>(payoff_matrix[row_idx * cols + col_idx].get_col_value());
+            },
+            row_strategy);
+        const double row_payoff = solve_indifference(
+            col_support, row_support, cols,
+            [&payoff_matrix, cols](size_t col_idx, size_t row_idx) {
+                return static_cast<double>(payoff_matrix[row_idx * cols + col_idx].get_row_value());
+            },
+            col_strategy);
+        if (std::isnan(row_payoff) || std::isnan(col_payoff)) {
+            return false;
+        }
+        // no action outside the supports may be a better response
+        for (size_t row_idx = 0; row_idx < rows; ++row_idx) {
+            double u = 0;
+            for (const size_t col_idx : col_support) {
+                u += col_strategy[col_idx] * payoff_matrix[row_idx * cols + col_idx].get_row_value();
+            }
+            if (u > row_payoff + eps) {
+                return false;
+            }
+        }
+        for (size_t col_idx = 0; col_idx < cols; ++col_idx) {
+            double v = 0;
+            for (const size_t row_idx : row_support) {
+                v += row_strategy[row_idx] * payoff_matrix[row_idx * cols + col_idx].get_col_value();
+            }
+            if (v > col_payoff + eps) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+   public:
+    // number of solves that needed a full Lemke-Howson solve
+    size_t cold_solves = 0;
+
+    template <template <typename...> typename Vector, template <typename...> typename Matrix,
+              template <typename> typename Value, typename Real>
+        requires std::is_floating_point_v<Real>
+    Value<Real> solve(const Matrix<Value<Real>> &payoff_matrix, Vector<Real> &row_strategy,
+                      Vector<Real> &col_strategy) {
+        if (solve_on_supports(payoff_matrix, row_strategy, col_strategy)) {
+            return detail::get_payoff(payoff_matrix, row_strategy, col_strategy);
+        }
+        ++cold_solves;
+        const Value<Real> value = LemkeHowson::solve(payoff_matrix, row_strategy, col_strategy);
+        get_support(row_strategy, row_support);
+        get_support(col_strategy, col_support);
+        return value;
+    }
+};
+
+};  // namespace LemkeHowson
@@ -1,10 +1,73 @@
 #pragma once
 
 #include <types/types.h>
+#include <libpinyon/lemke-howson.h>
+
+#include <vector>
 
 #include "../../extern/lrslib/include/lib.h"
 
 namespace LRSNash {
+
+// Pointer arrays and lrs output buffers that the `solve` overloads reuse between calls.
+// They only grow, when a larger matrix arrives. Each thread has its own, see `local()`
+struct NashSolverWorkspace {
+    std::vector<const mpq_t *> rpd{}, cpd{};
+    std::vector<long> payoff_data{};
+    mpz_t *row_solution_data = nullptr;
+    mpz_t *col_solution_data = nullptr;
+    size_t row_capacity = 0, col_capacity = 0;
+    // for the floating point conversions
+    mpq_class q{};
+
+    NashSolverWorkspace() {}
+    NashSolverWorkspace(const NashSolverWorkspace &) = delete;
+    NashSolverWorkspace &operator=(const NashSolverWorkspace &) = delete;
+
+    ~NashSolverWorkspace() {
+        if (row_solution_data != nullptr) {
+            dealloc(row_solution_data, row_capacity);
+        }
+        if (col_solution_data != nullptr) {
+            dealloc(col_solution_data, col_capacity);
+        }
+    }
+
+    static NashSolverWorkspace &local() {
+        thread_local NashSolverWorkspace workspace{};
+        return workspace;
+    }
+
+    // the solution buffers hold `rows + 2` and `cols + 2` entries: denominator, strategy numerators, payoff numerator
+    void reserve(const size_t rows, const size_t cols) {
+        if (row_capacity < rows + 2) {
+            if (row_solution_data != nullptr) {
+                dealloc(row_solution_data, row_capacity);
+            }
+            row_capacity = rows + 2;
+            row_solution_data = alloc(row_capacity);
+        }
+        if (col_capacity < cols + 2) {
+            if (col_solution_data != nullptr) {
+                dealloc(col_solution_data, col_capacity);
+            }
+            col_capacity = cols + 2;
+            col_solution_data = alloc(col_capacity);
+        }
+    }
+
+    // `x = num / den` without temporaries
+    static void set(mpq_class &x, const mpz_t num, const mpz_t den) {
+        mpq_set_num(x.get_mpq_t(), num);
+        mpq_set_den(x.get_mpq_t(), den);
+    }
+
+    double get_d(const mpz_t num, const mpz_t den) {
+        set(q, num, den);
+        return q.get_d();
+    }
+};
+
 // Solve matrix of mpq_class
 template <template <typename...> typename Vector, template <typename...> typename Matrix,
           template <typename> typename Value>
@@ -13,33 +76,34 @@ Value<mpq_class> solve(const Matrix<Value<mpq_class>> &payoff_matrix, Vector<mpq
     const size_t rows = payoff_matrix.rows;
     const size_t cols = payoff_matrix.cols;
     const size_t entries = rows * cols;
-    std::vector<const mpq_t *> rpd{entries}, cpd{entries};
+    NashSolverWorkspace &workspace = NashSolverWorkspace::local();
+    workspace.reserve(rows, cols);
+    workspace.rpd.resize(entries);
+    workspace.cpd.resize(entries);
 
     for (size_t i = 0; i < entries; ++i) {
-        rpd[i] = reinterpret_cast<mpq_t *>(&payoff_matrix[i].row_value);
-        cpd[i] = reinterpret_cast<mpq_t *>(&payoff_matrix[i].col_value);
+        workspace.rpd[i] = reinterpret_cast<const mpq_t *>(&payoff_matrix[i].row_value);
+        workspace.cpd[i] = reinterpret_cast<const mpq_t *>(&payoff_matrix[i].col_value);
     }
 
-    mpz_t *row_solution_data = alloc(rows + 2);
-    mpz_t *col_solution_data = alloc(cols + 2);
+    mpz_t *row_solution_data = workspace.row_solution_data;
+    mpz_t *col_solution_data = workspace.col_solution_data;
 
-    solve_gmp_pointer(rows, cols, rpd.data(), cpd.data(), row_solution_data, col_solution_data);
+    solve_gmp_pointer(rows, cols, workspace.rpd.data(), workspace.cpd.data(), row_solution_data, col_solution_data);
 
-    mpz_class row_den{row_solution_data[0]}, col_den{col_solution_data[0]};
+    row_strategy.resize(rows);
+    col_strategy.resize(cols);
     for (int row_idx = 0; row_idx < rows; ++row_idx) {
-        row_strategy[row_idx] = mpq_class{mpq_class{mpz_class{row_solution_data[row_idx + 1]}, row_den}};
+        NashSolverWorkspace::set(row_strategy[row_idx], row_solution_data[row_idx + 1], row_solution_data[0]);
     }
     for (int col_idx = 0; col_idx < cols; ++col_idx) {
-        col_strategy[col_idx] = mpq_class{mpq_class{mpz_class{col_solution_data[col_idx + 1]}, col_den}};
+        NashSolverWorkspace::set(col_strategy[col_idx], col_solution_data[col_idx + 1], col_solution_data[0]);
     }
 
-    mpq_class row_payoff{mpz_class{col_solution_data[cols + 1]}, col_den};
-    mpq_class col_payoff{mpz_class{row_solution_data[rows + 1]}, row_den};
-
-    dealloc(row_solution_data, rows + 2);
-    dealloc(col_solution_data, cols + 2);
-
-    return {mpq_class{row_payoff}, mpq_class{col_payoff}};
+    Value<mpq_class> payoff{};
+    NashSolverWorkspace::set(payoff.row_value, col_solution_data[cols + 1], col_solution_data[0]);
+    NashSolverWorkspace::set(payoff.col_value, row_solution_data[rows + 1], row_solution_data[0]);
+    return payoff;
 }
 
 // Solve constant-sum (ConstantSum<1, 1>) matrix of mpq_class
@@ -51,36 +115,32 @@ Value<mpq_class> solve(const Matrix<Value<mpq_class>> &payoff_matrix, Vector<mpq
     const size_t rows = payoff_matrix.rows;
     const size_t cols = payoff_matrix.cols;
     const size_t entries = rows * cols;
-    std::vector<const mpq_t *> rpd{entries};
+    NashSolverWorkspace &workspace = NashSolverWorkspace::local();
+    workspace.reserve(rows, cols);
+    workspace.rpd.resize(entries);
 
     for (size_t i = 0; i < entries; ++i) {
-        rpd[i] = reinterpret_cast<const mpq_t *>(&payoff_matrix[i].row_value);
+        workspace.rpd[i] = reinterpret_cast<const mpq_t *>(&payoff_matrix[i].row_value);
     }
 
-    mpz_t *row_solution_data = alloc(rows + 2);
-    mpz_t *col_solution_data = alloc(cols + 2);
+    mpz_t *row_solution_data = workspace.row_solution_data;
+    mpz_t *col_solution_data = workspace.col_solution_data;
 
-    solve_gmp_pointer_constant_sum(rows, cols, rpd.data(), row_solution_data, col_solution_data, 1, 1);
+    solve_gmp_pointer_constant_sum(rows, cols, workspace.rpd.data(), row_solution_data, col_solution_data, 1, 1);
 
-    mpz_class row_den{row_solution_data[0]}, col_den{col_solution_data[0]};
     row_strategy.resize(rows);
     col_strategy.resize(cols);
     for (int row_idx = 0; row_idx < rows; ++row_idx) {
-        row_strategy[row_idx] = mpq_class{mpz_class{row_solution_data[row_idx + 1]}, row_den};
+        NashSolverWorkspace::set(row_strategy[row_idx], row_solution_data[row_idx + 1], row_solution_data[0]);
     }
     for (int col_idx = 0; col_idx < cols; ++col_idx) {
-        col_strategy[col_idx] = mpq_class{mpz_class{col_solution_data[col_idx + 1]}, col_den};
+        NashSolverWorkspace::set(col_strategy[col_idx], col_solution_data[col_idx + 1], col_solution_data[0]);
     }
 
-    mpq_class row_payoff{mpz_class{col_solution_data[cols + 1]}, col_den};
-    mpq_class col_payoff{mpz_class{row_solution_data[rows + 1]}, row_den};
-
-    dealloc(row_solution_data, rows + 2);
-    dealloc(col_solution_data, cols + 2);
-
-    row_payoff.canonicalize();
-
-    return {row_payoff};
+    Value<mpq_class> payoff{};
+    NashSolverWorkspace::set(payoff.row_value, col_solution_data[cols + 1], col_solution_data[0]);
+    payoff.row_value.canonicalize();
+    return payoff;
 }
 
 // AB refactor temp method
@@ -88,46 +148,42 @@ template <template <typename...> typename Vector>
 mpq_class solve(const size_t rows, const size_t cols, const Vector<mpq_class> &payoff_matrix, Vector<mpq_class> &row_strategy,
                 Vector<mpq_class> &col_strategy) {
     const size_t entries = rows * cols;
-    std::vector<const mpq_t *> rpd{entries};
+    NashSolverWorkspace &workspace = NashSolverWorkspace::local();
+    workspace.reserve(rows, cols);
+    workspace.rpd.resize(entries);
 
     for (size_t i = 0; i < entries; ++i) {
-        rpd[i] = reinterpret_cast<const mpq_t *>(&payoff_matrix[i]);
+        workspace.rpd[i] = reinterpret_cast<const mpq_t *>(&payoff_matrix[i]);
     }
 
-    mpz_t *row_solution_data = alloc(rows + 2);
-    mpz_t *col_solution_data = alloc(cols + 2);
+    mpz_t *row_solution_data = workspace.row_solution_data;
+    mpz_t *col_solution_data = workspace.col_solution_data;
 
-    solve_gmp_pointer_constant_sum(rows, cols, rpd.data(), row_solution_data, col_solution_data, 1, 1);
+    solve_gmp_pointer_constant_sum(rows, cols, workspace.rpd.data(), row_solution_data, col_solution_data, 1, 1);
 
-    mpz_class row_den{row_solution_data[0]}, col_den{col_solution_data[0]};
     row_strategy.resize(rows);
     col_strategy.resize(cols);
     for (int row_idx = 0; row_idx < rows; ++row_idx) {
-        row_strategy[row_idx] = mpq_class{mpz_class{row_solution_data[row_idx + 1]}, row_den};
+        NashSolverWorkspace::set(row_strategy[row_idx], row_solution_data[row_idx + 1], row_solution_data[0]);
         row_strategy[row_idx].canonicalize();
     }
     for (int col_idx = 0; col_idx < cols; ++col_idx) {
-        col_strategy[col_idx] = mpq_class{mpz_class{col_solution_data[col_idx + 1]}, col_den};
+        NashSolverWorkspace::set(col_strategy[col_idx], col_solution_data[col_idx + 1], col_solution_data[0]);
         col_strategy[col_idx].canonicalize();
     }
 
-    mpq_class row_payoff{mpz_class{col_solution_data[cols + 1]}, col_den};
-    mpq_class col_payoff{mpz_class{row_solution_data[rows + 1]}, row_den};
-
-    dealloc(row_solution_data, rows + 2);
-    dealloc(col_solution_data, cols + 2);
-
+    mpq_class row_payoff{};
+    NashSolverWorkspace::set(row_payoff, col_solution_data[cols + 1], col_solution_data[0]);
     row_payoff.canonicalize();
-
     return row_payoff;
 }
 
-// Solve for everything else, mostly for doubles
+// Solve for everything else with lrs, after discretizing the payoffs to multiples of 1 / `den`
 template <template <typename...> typename Vector, template <typename...> typename Matrix,
           template <typename> typename Value, typename Real>
     requires(std::is_same_v<Real, mpq_class> == false)
 Value<Real> solve(const Matrix<Value<Real>> &payoff_matrix, Vector<Real> &row_strategy, Vector<Real> &col_strategy,
-                  int den = 100) {
+                  int den) {
     const size_t rows = payoff_matrix.rows;
     const size_t cols = payoff_matrix.cols;
     const size_t entries = rows * cols;
@@ -136,7 +192,10 @@ Value<Real> solve(const Matrix<Value<Real>> &payoff_matrix, Vector<Real> &row_st
     const Real max = payoff_matrix.max();
     const Real range{max == min ? Real{1} : max - min};
 
-    long *payoff_data = new long[2 * entries];
+    NashSolverWorkspace &workspace = NashSolverWorkspace::local();
+    workspace.reserve(rows, cols);
+    workspace.payoff_data.resize(2 * entries);
+    long *payoff_data = workspace.payoff_data.data();
 
     for (size_t i = 0; i < entries; ++i) {
         const Value<Real> &value = payoff_matrix[i];
@@ -146,32 +205,26 @@ Value<Real> solve(const Matrix<Value<Real>> &payoff_matrix, Vector<Real> &row_st
         payoff_data[2 * i + 1] = ceil(b);
     }
 
-    mpz_t *row_solution_data = alloc(rows + 2);
-    mpz_t *col_solution_data = alloc(cols + 2);
-    const mpz_t *const_row_solution_data = row_solution_data;
-    const mpz_t *const_col_solution_data = col_solution_data;
+    mpz_t *row_solution_data = workspace.row_solution_data;
+    mpz_t *col_solution_data = workspace.col_solution_data;
 
     solve_gmp_float(rows, cols, payoff_data, den, row_solution_data, col_solution_data);
 
-    mpz_class row_den{const_row_solution_data[0]}, col_den{const_col_solution_data[0]};
     row_strategy.resize(rows);
     col_strategy.resize(cols);
     for (int row_idx = 0; row_idx < rows; ++row_idx) {
         row_strategy[row_idx] =
-            Real{static_cast<Real>(mpq_class{mpz_class{const_row_solution_data[row_idx + 1]}, row_den}.get_d())};
+            Real{static_cast<Real>(workspace.get_d(row_solution_data[row_idx + 1], row_solution_data[0]))};
     }
     for (int col_idx = 0; col_idx < cols; ++col_idx) {
         col_strategy[col_idx] =
-            Real{static_cast<Real>(mpq_class{mpz_class{const_col_solution_data[col_idx + 1]}, col_den}.get_d())};
+            Real{static_cast<Real>(workspace.get_d(col_solution_data[col_idx + 1], col_solution_data[0]))};
     }
 
-    Real row_payoff{static_cast<Real>(mpq_class{mpz_class{const_col_solution_data[cols + 1]}, col_den}.get_d())};
-    Real col_payoff{static_cast<Real>(mpq_class{mpz_class{const_row_solution_data[rows + 1]}, row_den}.get_d())};
+    Real row_payoff{static_cast<Real>(workspace.get_d(col_solution_data[cols + 1], col_solution_data[0]))};
+    Real col_payoff{static_cast<Real>(workspace.get_d(row_solution_data[rows + 1], row_solution_data[0]))};
     row_payoff = row_payoff * range + min;
     col_payoff = col_payoff * range + min;
-    dealloc(row_solution_data, rows + 2);
-    dealloc(col_solution_data, cols + 2);
-    delete[] payoff_data;
 
     if constexpr (Value<Real>::IS_CONSTANT_SUM == true) {
         return {row_payoff};
@@ -180,4 +233,16 @@ Value<Real> solve(const Matrix<Value<Real>> &payoff_matrix, Vector<Real> &row_st
     }
 }
 
-}; // End namespace LRSNash
\ No newline at end of file
+// Floating point payoffs skip lrs and use Lemke-Howson in double precision. Pass `den` to use lrs anyway
+template <template <typename...> typename Vector, template <typename...> typename Matrix,
+          template <typename> typename Value, typename Real>
+    requires(std::is_same_v<Real, mpq_class> == false)
+Value<Real> solve(const Matrix<Value<Real>> &payoff_matrix, Vector<Real> &row_strategy, Vector<Real> &col_strategy) {
+    if constexpr (std::is_floating_point_v<Real>) {
+        return LemkeHowson::solve(payoff_matrix, row_strategy, col_strategy);
+    } else {
+        return solve(payoff_matrix, row_strategy, col_strategy, 100);
+    }
+}
+
+}; // End namespace LRSNash
@@ -0,0 +1,178 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+/*
+
+Vectorized kernels for the Exp3 family.
+
+The kernels use GCC/Clang vector extensions rather than intrinsics. On x86 each kernel is compiled for AVX-512, AVX2
+and the baseline ISA (`target_clones`), and the best one is picked at load time. Other compilers, and forecasts over
+fewer than 8 actions, use the scalar loop.
+
+`exp` is the Cephes single precision polynomial, accurate to about 1 ulp of float. Exp3 already computed the softmax
+in float (`std::exp(static_cast<float>(...))`), so the forecast has the same precision as before.
+
+*/
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__)) && !defined(PINYON_NO_MULTIVERSIONING)
+#define PINYON_TARGET_CLONES __attribute__((target_clones("arch=x86-64-v4", "arch=x86-64-v3", "default")))
+#else
+#define PINYON_TARGET_CLONES
+#endif
+
+// the shared bodies must be inlined into each clone to be compiled for its ISA
+#if defined(__GNUC__)
+#define PINYON_ALWAYS_INLINE __attribute__((always_inline))
+#else
+#define PINYON_ALWAYS_INLINE
+#endif
+
+namespace math {
+
+namespace detail {
+
+template <typename Real>
+PINYON_ALWAYS_INLINE inline void exp3_forecast_scalar(const Real *gains, Real *forecast, const size_t k, const Real eta,
+                                                      const Real one_minus_gamma) {
+    Real total = 0;
+    for (size_t i = 0; i < k; ++i) {
+        forecast[i] = std::exp(static_cast<float>(gains[i] * eta));
+        total += forecast[i];
+    }
+    const Real scale = one_minus_gamma / total;
+    for (size_t i = 0; i < k; ++i) {
+        forecast[i] = forecast[i] * scale + eta;
+    }
+}
+
+#if defined(__GNUC__)
+
+// 8 float lanes. On AVX2 and AVX-512 targets this is one register, on the baseline it is lowered to two SSE registers
+typedef float float8 __attribute__((vector_size(32)));
+typedef int32_t int8 __attribute__((vector_size(32)));
+
+PINYON_ALWAYS_INLINE inline void exp_poly(float8 &x) {
+    x = x < -87.3f ? -87.3f : x;
+    x = x > 88.3f ? 88.3f : x;
+    // round to nearest by adding and subtracting 1.5 * 2^23
+    const float8 n = (x * 1.44269504088896341f + 12582912.0f) - 12582912.0f;
+    const float8 r = (x - n * 0.693359375f) + n * 2.12194440e-4f;
+    float8 p = r * 1.9875691500e-4f + 1.3981999507e-3f;
+    p = p * r + 8.3334519073e-3f;
+    p = p * r + 4.1665795894e-2f;
+    p = p * r + 1.6666665459e-1f;
+    p = p * r + 5.0000001201e-1f;
+    p = p * r * r + r + 1.0f;
+    const int8 e = (__builtin_convertvector(n, int8) + 127) << 23;
+    x = p * (float8)e;
+}
+
+typedef double double8 __attribute__((vector_size(64)));
+
+// unaligned loads and stores of 8 lanes, converted to and from float
+PINYON_ALWAYS_INLINE inline void load8(const float *x, float8 &v) { std::memcpy(&v, x, sizeof(v)); }
+
+PINYON_ALWAYS_INLINE inline void load8(const double *x, float8 &v) {
+    double8 w;
+    std::memcpy(&w, x, sizeof(w));
+    v = __builtin_convertvector(w, float8);
+}
+
+PINYON_ALWAYS_INLINE inline void store8(float *x, const float8 &v) { std::memcpy(x, &v, sizeof(v)); }
+
+PINYON_ALWAYS_INLINE inline void store8(double *x, const float8 &v) {
+    const double8 w = __builtin_convertvector(v, double8);
+    std::memcpy(x, &w, sizeof(w));
+}
+
+template <typename Real>
+PINYON_ALWAYS_INLINE inline void exp3_forecast(const Real *gains, Real *forecast, const size_t k, const Real eta,
+                                               const Real one_minus_gamma) {
+    // below one full block, gathering the lanes costs more than the scalar exp
+    if (k < 8) {
+        exp3_forecast_scalar(gains, forecast, k, eta, one_minus_gamma);
+        return;
+    }
+    // a partial last block is handled as the last 8 lanes, overlapping the previous block.
+    // it is loaded first since `gains` and `forecast` may alias
+    const size_t overlap = (8 - k % 8) % 8;
+    const float eta_float = static_cast<float>(eta);
+    float8 last;
+    load8(gains + k - 8, last);
+    last *= eta_float;
+    float8 sum{};
+    size_t i = 0;
+    for (; i + 8 <= k; i += 8) {
+        float8 x;
+        load8(gains + i, x);
+        x *= eta_float;
+        exp_poly(x);
+        store8(forecast + i, x);
+        sum += x;
+    }
+    if (overlap) {
+        exp_poly(last);
+        store8(forecast + k - 8, last);
+        const int8 lane{0, 1, 2, 3, 4, 5, 6, 7};
+        sum += lane >= static_cast<int32_t>(overlap) ? last : 0;
+    }
+    Real total = 0;
+    for (size_t j = 0; j < 8; ++j) {
+        total += sum[j];
+    }
+    const Real scale = one_minus_gamma / total;
+    for (i = 0; i < k; ++i) {
+        forecast[i] = forecast[i] * scale + eta;
+    }
+}
+
+#else
+
+template <typename Real>
+inline void exp3_forecast(const Real *gains, Real *forecast, const size_t k, const Real eta, const Real one_minus_gamma) {
+    exp3_forecast_scalar(gains, forecast, k, eta, one_minus_gamma);
+}
+
+#endif
+
+template <typename Real>
+PINYON_ALWAYS_INLINE inline void shift(Real *x, const size_t k, const Real c) {
+    size_t i = 0;
+    // fixed trip count so the block is vectorized even without -O3
+    for (; i + 8 <= k; i += 8) {
+        for (size_t j = 0; j < 8; ++j) {
+            x[i + j] -= c;
+        }
+    }
+    for (; i < k; ++i) {
+        x[i] -= c;
+    }
+}
+
+};  // namespace detail
+
+// forecast = (1 - gamma) * softmax(eta * gains) + eta, where eta = gamma / k
+PINYON_TARGET_CLONES
+inline void exp3_forecast(const double *gains, double *forecast, const size_t k, const double eta,
+                          const double one_minus_gamma) {
+    detail::exp3_forecast(gains, forecast, k, eta, one_minus_gamma);
+}
+
+PINYON_TARGET_CLONES
+inline void exp3_forecast(const float *gains, float *forecast, const size_t k, const float eta,
+                          const float one_minus_gamma) {
+    detail::exp3_forecast(gains, forecast, k, eta, one_minus_gamma);
+}
+
+// x -= c, used to renormalize the gains
+PINYON_TARGET_CLONES
+inline void shift(double *x, const size_t k, const double c) { detail::shift(x, k, c); }
+
+PINYON_TARGET_CLONES
+inline void shift(float *x, const size_t k, const float c) { detail::shift(x, k, c); }
+
+}  // namespace math
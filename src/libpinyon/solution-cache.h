@@ -0,0 +1,221 @@
+#pragma once
+
+#include <libpinyon/lrslib.h>
+#include <types/random.h>
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+/*
+
+Bounded cache of solved matrix games, which can be shared by any number of searches and threads.
+
+A game is keyed by its dimensions and entries. `mpq_class` entries are canonicalized before they are hashed and
+compared, so 2/4 and 1/2 are the same entry. Floating point entries must be exactly equal. On a hit the stored
+strategies are copied out instead of calling `LRSNash::solve`.
+
+The table is 4-way set associative and its capacity is fixed at construction. A full set replaces its least recently
+used entry. Each set has its own lock and the solve itself runs unlocked, so two threads that miss on the same game at
+the same time both solve it.
+
+*/
+
+template <typename Types>
+class SolutionCache
+{
+public:
+    using Real = Types::Real;
+
+    static constexpr size_t ways = 4;
+
+    // `capacity` is rounded up to a power of two
+    SolutionCache(const size_t capacity = 1 << 12)
+        : sets{std::bit_ceil(std::max(capacity, ways)) / ways},
+          entries(sets * ways),
+          locks{std::make_unique<std::mutex[]>(sets)} {}
+
+    SolutionCache(const SolutionCache &) = delete;
+    SolutionCache &operator=(const SolutionCache &) = delete;
+
+    Types::Value solve(
+        const Types::MatrixValue &payoff_matrix,
+        Types::VectorReal &row_strategy,
+        Types::VectorReal &col_strategy)
+    {
+        std::vector<Real> key{};
+        const uint64_t hash = get_key(payoff_matrix, key);
+        const size_t set_idx = hash & (sets - 1);
+        Entry *const set = &entries[set_idx * ways];
+
+        {
+            std::lock_guard<std::mutex> lock{locks[set_idx]};
+            for (size_t way = 0; way < ways; ++way)
+            {
+                Entry &entry = set[way];
+                if (entry.last_used != 0 && entry.hash == hash &&
+                    entry.rows == payoff_matrix.rows && entry.cols == payoff_matrix.cols && entry.key == key)
+                {
+                    entry.last_used = clock.fetch_add(1, std::memory_order_relaxed) + 1;
+                    row_strategy = entry.row_strategy;
+                    col_strategy = entry.col_strategy;
+                    hits_.fetch_add(1, std::memory_order_relaxed);
+                    return entry.value;
+                }
+            }
+        }
+
+        misses_.fetch_add(1, std::memory_order_relaxed);
+        const typename Types::Value value = LRSNash::solve(payoff_matrix, row_strategy, col_strategy);
+
+        std::lock_guard<std::mutex> lock{locks[set_idx]};
+        Entry *victim = std::min_element(
+            set, set + ways,
+            [](const Entry &a, const Entry &b)
+            { return a.last_used < b.last_used; });
+        victim->hash = hash;
+        victim->last_used = clock.fetch_add(1, std::memory_order_relaxed) + 1;
+        victim->rows = payoff_matrix.rows;
+        victim->cols = payoff_matrix.cols;
+        victim->key = std::move(key);
+        victim->value = value;
+        victim->row_strategy = row_strategy;
+        victim->col_strategy = col_strategy;
+        return value;
+    }
+
+    size_t hits() const
+    {
+        return hits_.load(std::memory_order_relaxed);
+    }
+
+    size_t misses() const
+    {
+        return misses_.load(std::memory_order_relaxed);
+    }
+
+    double hit_rate() const
+    {
+        const size_t total = hits() + misses();
+        return total == 0 ? 0 : static_cast<double>(hits()) / total;
+    }
+
+    size_t capacity() const
+    {
+        return entries.size();
+    }
+
+    // empties the table and resets the counters. Not safe while another thread is solving
+    void clear()
+    {
+        for (Entry &entry : entries)
+        {
+            entry = Entry{};
+        }
+        hits_ = 0;
+        misses_ = 0;
+    }
+
+    friend std::ostream &operator<<(std::ostream &os, const SolutionCache &cache)
+    {
+        os << "SolutionCache(" << cache.capacity() << "); hits: " << cache.hits() << ", misses: " << cache.misses();
+        return os;
+    }
+
+private:
+    struct Entry
+    {
+        uint64_t hash = 0;
+        // 0 for an empty entry
+        uint64_t last_used = 0;
+        size_t rows = 0, cols = 0;
+        std::vector<Real> key{};
+        Types::Value value{};
+        Types::VectorReal row_strategy{}, col_strategy{};
+    };
+
+    const size_t sets;
+    std::vector<Entry> entries;
+    std::unique_ptr<std::mutex[]> locks;
+    std::atomic<uint64_t> clock{0};
+    std::atomic<size_t> hits_{0}, misses_{0};
+
+    static uint64_t mix(uint64_t hash, const uint64_t x)
+    {
+        hash ^= x * 0xBF58476D1CE4E5B9;
+        return splitmix64(hash);
+    }
+
+    static uint64_t hash_mpz(uint64_t hash, mpz_srcptr z)
+    {
+        hash = mix(hash, static_cast<uint64_t>(mpz_sgn(z)));
+        const size_t limbs = mpz_size(z);
+        for (size_t i = 0; i < limbs; ++i)
+        {
+            hash = mix(hash, static_cast<uint64_t>(mpz_getlimbn(z, i)));
+        }
+        return hash;
+    }
+
+    // canonicalizes `x` for the key and adds it to the hash
+    static uint64_t hash_real(uint64_t hash, Real &x)
+    {
+        if constexpr (std::is_same_v<Real, mpq_class>)
+        {
+            x.canonicalize();
+            hash = hash_mpz(hash, x.get_num_mpz_t());
+            return hash_mpz(hash, x.get_den_mpz_t());
+        }
+        else
+        {
+            // adding 0 turns -0 into 0, which compare equal
+            return mix(hash, std::bit_cast<uint64_t>(static_cast<double>(x) + 0.0));
+        }
+    }
+
+    static uint64_t get_key(const Types::MatrixValue &payoff_matrix, std::vector<Real> &key)
+    {
+        const size_t size = payoff_matrix.rows * payoff_matrix.cols;
+        uint64_t hash = mix(payoff_matrix.rows, payoff_matrix.cols);
+        if constexpr (Types::Value::IS_CONSTANT_SUM)
+        {
+            key.reserve(size);
+        }
+        else
+        {
+            key.reserve(2 * size);
+        }
+        for (size_t i = 0; i < size; ++i)
+        {
+            const typename Types::Value &value = payoff_matrix[i];
+            hash = hash_real(hash, key.emplace_back(value.get_row_value()));
+            if constexpr (!Types::Value::IS_CONSTANT_SUM)
+            {
+                hash = hash_real(hash, key.emplace_back(value.get_col_value()));
+            }
+        }
+        return hash;
+    }
+};
+
+namespace LRSNash
+{
+    // consults `cache` first when there is one
+    template <typename Types>
+    typename Types::Value solve(
+        SolutionCache<Types> *cache,
+        const typename Types::MatrixValue &payoff_matrix,
+        typename Types::VectorReal &row_strategy,
+        typename Types::VectorReal &col_strategy)
+    {
+        if (cache != nullptr)
+        {
+            return cache->solve(payoff_matrix, row_strategy, col_strategy);
+        }
+        return LRSNash::solve(payoff_matrix, row_strategy, col_strategy);
+    }
+};
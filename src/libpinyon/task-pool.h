@@ -0,0 +1,197 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/*
+
+Work-stealing pool for fork-join parallelism, e.g. recursive solvers.
+
+Tasks are submitted to a `TaskGroup` and `wait(group)` returns once all of them have run. A thread that waits does not
+block: it runs queued tasks, so tasks may submit and wait on groups of their own. Each worker has its own deque. It
+runs its newest task first and otherwise steals the oldest task of another deque. Threads outside the pool share one
+more deque.
+
+`TaskPool{threads}` spawns `threads - 1` workers, since the thread that waits also runs tasks. With one thread every
+task runs inside `wait`, in the order of submission. Tasks must not throw.
+
+*/
+
+class TaskPool
+{
+public:
+    using Task = std::function<void()>;
+
+    class TaskGroup
+    {
+        friend class TaskPool;
+        std::atomic<size_t> pending{0};
+    };
+
+    TaskPool(const size_t threads = 1) : size_{std::max(threads, size_t{1})}
+    {
+        for (size_t i = 0; i < size_; ++i)
+        {
+            queues.push_back(std::make_unique<Queue>());
+        }
+        workers.reserve(size_ - 1);
+        for (size_t thread_idx = 0; thread_idx < size_ - 1; ++thread_idx)
+        {
+            workers.emplace_back(&TaskPool::work, this, thread_idx);
+        }
+    }
+
+    TaskPool(const TaskPool &) = delete;
+    TaskPool &operator=(const TaskPool &) = delete;
+
+    ~TaskPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock{sleep_mutex};
+            stopping = true;
+        }
+        wake.notify_all();
+        for (auto &worker : workers)
+        {
+            worker.join();
+        }
+    }
+
+    size_t size() const
+    {
+        return size_;
+    }
+
+    void submit(TaskGroup &group, Task task)
+    {
+        group.pending.fetch_add(1, std::memory_order_relaxed);
+        Queue &queue = *queues[queue_idx()];
+        {
+            std::lock_guard<std::mutex> lock{queue.mutex};
+            queue.entries.push_back({std::move(task), &group});
+        }
+        queued.fetch_add(1, std::memory_order_release);
+        if (!workers.empty())
+        {
+            // a worker that saw an empty pool is either still holding `sleep_mutex` or already waiting
+            {
+                std::lock_guard<std::mutex> lock{sleep_mutex};
+            }
+            wake.notify_one();
+        }
+    }
+
+    void wait(TaskGroup &group)
+    {
+        const size_t idx = queue_idx();
+        while (group.pending.load(std::memory_order_acquire) > 0)
+        {
+            if (!run_one(idx))
+            {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+private:
+    struct Entry
+    {
+        Task task;
+        TaskGroup *group;
+    };
+
+    struct Queue
+    {
+        std::mutex mutex{};
+        std::deque<Entry> entries{};
+    };
+
+    const size_t size_;
+    // one per worker, and the last one for threads outside the pool
+    std::vector<std::unique_ptr<Queue>> queues{};
+    std::vector<std::thread> workers{};
+
+    std::atomic<size_t> queued{0};
+    std::mutex sleep_mutex{};
+    std::condition_variable wake{};
+    bool stopping = false;
+
+    inline static thread_local const TaskPool *current_pool = nullptr;
+    inline static thread_local size_t current_idx = 0;
+
+    size_t queue_idx() const
+    {
+        return current_pool == this ? current_idx : size_ - 1;
+    }
+
+    bool pop(const size_t idx, Entry &entry)
+    {
+        Queue &own = *queues[idx];
+        {
+            std::lock_guard<std::mutex> lock{own.mutex};
+            if (!own.entries.empty())
+            {
+                entry = std::move(own.entries.back());
+                own.entries.pop_back();
+                return true;
+            }
+        }
+        for (size_t i = 1; i < size_; ++i)
+        {
+            Queue &other = *queues[(idx + i) % size_];
+            std::lock_guard<std::mutex> lock{other.mutex};
+            if (!other.entries.empty())
+            {
+                entry = std::move(other.entries.front());
+                other.entries.pop_front();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool run_one(const size_t idx)
+    {
+        if (queued.load(std::memory_order_acquire) == 0)
+        {
+            return false;
+        }
+        Entry entry;
+        if (!pop(idx, entry))
+        {
+            return false;
+        }
+        queued.fetch_sub(1, std::memory_order_relaxed);
+        entry.task();
+        entry.group->pending.fetch_sub(1, std::memory_order_release);
+        return true;
+    }
+
+    void work(const size_t thread_idx)
+    {
+        current_pool = this;
+        current_idx = thread_idx;
+        while (true)
+        {
+            if (run_one(thread_idx))
+            {
+                continue;
+            }
+            std::unique_lock<std::mutex> lock{sleep_mutex};
+            wake.wait(lock, [this]
+                      { return stopping || queued.load(std::memory_order_acquire) > 0; });
+            if (stopping)
+            {
+                return;
+            }
+        }
+    }
+};
@@ -0,0 +1,153 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/*
+
+Fixed size set of long-lived threads that park on a condition variable between jobs.
+
+run(job) wakes every worker, calls job(thread_idx) once on each, and blocks until all of them have returned.
+The threads are only spawned on the first call, so constructing a pool (e.g. as a default member of a Search) is cheap.
+Concurrent calls to run() from different threads are serialized.
+
+A search holds its pool through a WorkerPoolHandle. Copying the handle makes a new pool of the same size, so copies
+of a search (e.g. inside a copied SearchModel) never wait on each other. Only a pool that was passed in as a
+shared_ptr is shared by the copies.
+
+*/
+
+class WorkerPool
+{
+public:
+    using Job = std::function<void(size_t)>;
+
+    WorkerPool(const size_t size = 1) : size_{size} {}
+    WorkerPool(const WorkerPool &) = delete;
+    WorkerPool &operator=(const WorkerPool &) = delete;
+
+    ~WorkerPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock{mutex};
+            stopping = true;
+        }
+        wake.notify_all();
+        for (auto &worker : workers)
+        {
+            worker.join();
+        }
+    }
+
+    size_t size() const
+    {
+        return size_;
+    }
+
+    void run(const Job &job)
+    {
+        std::lock_guard<std::mutex> dispatch_lock{dispatch_mutex};
+        if (workers.empty())
+        {
+            workers.reserve(size_);
+            for (size_t thread_idx = 0; thread_idx < size_; ++thread_idx)
+            {
+                workers.emplace_back(&WorkerPool::work, this, thread_idx);
+            }
+        }
+        {
+            std::lock_guard<std::mutex> lock{mutex};
+            current_job = &job;
+            active = size_;
+            ++generation;
+        }
+        wake.notify_all();
+        std::unique_lock<std::mutex> lock{mutex};
+        done.wait(lock, [this]
+                  { return active == 0; });
+        current_job = nullptr;
+    }
+
+private:
+    const size_t size_;
+    std::vector<std::thread> workers{};
+
+    std::mutex dispatch_mutex{};
+    std::mutex mutex{};
+    std::condition_variable wake{};
+    std::condition_variable done{};
+
+    const Job *current_job = nullptr;
+    size_t generation = 0;
+    size_t active = 0;
+    bool stopping = false;
+
+    void work(const size_t thread_idx)
+    {
+        size_t seen_generation = 0;
+        std::unique_lock<std::mutex> lock{mutex};
+        while (true)
+        {
+            wake.wait(lock, [this, seen_generation]
+                      { return stopping || generation != seen_generation; });
+            if (stopping)
+            {
+                return;
+            }
+            seen_generation = generation;
+            const Job *job = current_job;
+            lock.unlock();
+            (*job)(thread_idx);
+            lock.lock();
+            if (--active == 0)
+            {
+                done.notify_one();
+            }
+        }
+    }
+};
+
+class WorkerPoolHandle
+{
+public:
+    WorkerPoolHandle(const size_t size) : pool{std::make_shared<WorkerPool>(size)} {}
+
+    WorkerPoolHandle(std::shared_ptr<WorkerPool> pool) : pool{std::move(pool)}, shared{true} {}
+
+    WorkerPoolHandle(const WorkerPoolHandle &other)
+        : pool{other.shared ? other.pool : std::make_shared<WorkerPool>(other.pool->size())}, shared{other.shared}
+    {
+    }
+
+    WorkerPoolHandle &operator=(const WorkerPoolHandle &other)
+    {
+        if (this != &other)
+        {
+            pool = other.shared ? other.pool : std::make_shared<WorkerPool>(other.pool->size());
+            shared = other.shared;
+        }
+        return *this;
+    }
+
+    WorkerPoolHandle(WorkerPoolHandle &&) = default;
+    WorkerPoolHandle &operator=(WorkerPoolHandle &&) = default;
+
+    WorkerPool *operator->() const
+    {
+        return pool.get();
+    }
+
+    WorkerPool *get() const
+    {
+        return pool.get();
+    }
+
+private:
+    std::shared_ptr<WorkerPool> pool;
+    bool shared = false;
+};
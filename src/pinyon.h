@@ -3,10 +3,15 @@
 // Util
 
 #include <libpinyon/math.h>
+#include <libpinyon/simd.h>
 #include <libpinyon/lrslib.h>
+#include <libpinyon/solution-cache.h>
 #include <libpinyon/generator.h>
 #include <libpinyon/search-type.h>
 #include <libpinyon/dynamic-wrappers.h>
+#include <libpinyon/worker-pool.h>
+#include <libpinyon/task-pool.h>
+#include <libpinyon/deadline.h>
 
 // Types
 
@@ -35,15 +40,19 @@
 #include <algorithm/tree-bandit/tree/tree-bandit-flat.h>
 #include <algorithm/tree-bandit/tree/multithreaded.h>
 #include <algorithm/tree-bandit/tree/off-policy.h>
+#include <algorithm/tree-bandit/tree/tree-bandit-batched.h>
 
 #include <algorithm/tree-bandit/bandit/exp3.h>
 #include <algorithm/tree-bandit/bandit/exp3-fat.h>
+#include <algorithm/tree-bandit/bandit/exp3-atomic.h>
 #include <algorithm/tree-bandit/bandit/rand.h>
 #include <algorithm/tree-bandit/bandit/matrix-ucb.h>
 #include <algorithm/tree-bandit/bandit/ucb.h>
 
 #include <algorithm/solver/full-traversal.h>
 #include <algorithm/solver/alpha-beta.h>
+#include <algorithm/solver/alpha-beta-parallel.h>
+#include <algorithm/solver/alpha-beta-iter.h>
 #include <algorithm/solver/alpha-beta-dev.h>
 #include <algorithm/solver/alpha-beta-force.h>
 
@@ -53,3 +62,6 @@
 #include <tree/tree-obs.h>
 #include <tree/tree-debug.h>
 #include <tree/tree-flat.h>
+#include <tree/tree-arena.h>
+#include <tree/tree-transposition.h>
+#include <tree/tree-packed.h>
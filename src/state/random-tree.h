@@ -7,7 +7,20 @@
 #include <types/types.h>
 #include <vector>
 
-template <IsTypeList Types = RandomTreeFloatTypes>
+/*
+
+By default a transition advances the state's PRNG by the transition index with `discard` and then draws the chance
+strategies for every joint action of the child. Both are linear in `rows * cols * transitions`.
+
+With `hashed_transitions`, the state instead holds a 64 bit node seed. The seed of a child is a hash of the node seed
+and the transition index, and the PRNG is reseeded from it. Chance strategies are not stored: the weight of each
+transition is a hash of the node seed and its index, so only the distribution of the committed joint actions is ever
+computed. This mode generates different trees from the same seed, so the default is kept for reproducibility.
+Reseeding is only cheap for small generators, so it is best paired with `RandomTreeFastTypes`.
+
+*/
+
+template <IsTypeList Types = RandomTreeFloatTypes, bool hashed_transitions = false>
 struct RandomTree : Types {
     class State : public PerfectInfoState<Types> {
        public:
@@ -21,6 +34,8 @@ struct RandomTree : Types {
         typename Types::Q chance_threshold{1, static_cast<int>(transitions + 1)};
         std::vector<typename Types::Prob> chance_strategies;
         int chance_denominator = 10;
+        // only used with hashed_transitions
+        uint64_t node_seed = 0;
 
         int (*depth_bound_func)(State *, int) = &(State::depth_bound_default);
         int (*actions_func)(State *, int) = &(State::actions_default);
@@ -37,7 +52,7 @@ struct RandomTree : Types {
               transitions{transitions},
               chance_threshold{chance_threshold} {
             this->init_range_actions(rows, cols);
-            get_chance_strategies();
+            init_chance();
         }
 
         State(const Types::PRNG &device, size_t depth_bound, size_t rows, size_t cols, size_t transitions,
@@ -53,13 +68,16 @@ struct RandomTree : Types {
               actions_func{actions_func},
               payoff_bias_func{payoff_bias_func} {
             this->init_range_actions(rows, cols);
-            get_chance_strategies();
+            init_chance();
         }
 
         void randomize_transition(Types::PRNG &device) { transition_seed = device.uniform_64(); }
 
         void randomize_transition(Types::Seed seed) { transition_seed = seed; }
 
+        // copy assignment keeps the capacity of `chance_strategies` and the action vectors
+        void restore(const State &state) { *this = state; }
+
         void get_actions() { this->init_range_actions(rows, cols); }
 
         void get_actions(Types::VectorAction &row_actions, Types::VectorAction &col_actions) const {
@@ -77,6 +95,18 @@ struct RandomTree : Types {
                                 std::vector<typename Types::Obs> &chance_actions) const {
             chance_actions.clear();
             const size_t start_idx = get_transition_idx(row_action, col_action, {0});
+            if constexpr (hashed_transitions) {
+                if (chance_weight_sum(start_idx) == 0) {
+                    chance_actions.push_back(typename Types::Obs{0});
+                    return;
+                }
+                for (int chance_idx = 0; chance_idx < transitions; ++chance_idx) {
+                    if (chance_weight(start_idx + chance_idx) > 0) {
+                        chance_actions.push_back(typename Types::Obs{chance_idx});
+                    }
+                }
+                return;
+            }
             for (int chance_idx = 0; chance_idx < transitions; ++chance_idx) {
                 if (chance_strategies[start_idx + chance_idx] > typename Types::Prob{0}) {
                     chance_actions.push_back(typename Types::Obs{chance_idx});
@@ -86,11 +116,16 @@ struct RandomTree : Types {
 
         void apply_actions(Types::Action row_action, Types::Action col_action, Types::Obs chance_action) {
             const int transition_idx = get_transition_idx(row_action, col_action, chance_action);
-            device.discard(transition_idx);
-            // advance the Types::PRNG so that different player/chance actions have different outcomes
-
             this->obs = chance_action;
-            this->prob = chance_strategies[transition_idx];
+            if constexpr (hashed_transitions) {
+                this->prob = get_chance_prob(transition_idx - chance_action, chance_action);
+                node_seed = hash(node_seed, 2 * transition_idx + 1);
+                device = typename Types::PRNG{node_seed};
+            } else {
+                // advance the Types::PRNG so that different player/chance actions have different outcomes
+                device.discard(transition_idx);
+                this->prob = chance_strategies[transition_idx];
+            }
 
             depth_bound = (*depth_bound_func)(this, depth_bound);
             depth_bound *= depth_bound >= 0;
@@ -104,7 +139,9 @@ struct RandomTree : Types {
             } else {
                 rows = (*actions_func)(this, rows);
                 cols = (*actions_func)(this, cols);
-                get_chance_strategies();
+                if constexpr (!hashed_transitions) {
+                    get_chance_strategies();
+                }
             }
         }
 
@@ -115,9 +152,25 @@ struct RandomTree : Types {
         void apply_actions(Types::Action row_action, Types::Action col_action) {
             // get_chance_actions has always 'just been called' since its in the ctor and apply_actions()
             // Therefore we should just be able to sample it
+            const int start = this->get_transition_idx(row_action, col_action, 0);
+            if constexpr (hashed_transitions) {
+                // the weights are integers, so the chance action is sampled without constructing a PRNG
+                const int sum = chance_weight_sum(start);
+                if (sum > 0) {
+                    int x = (hash(this->transition_seed, 0) >> 32) * sum >> 32;
+                    for (int c{}; c < this->transitions; ++c) {
+                        x -= chance_weight(start + c);
+                        if (x < 0) {
+                            this->apply_actions(row_action, col_action, c);
+                            return;
+                        }
+                    }
+                }
+                this->apply_actions(row_action, col_action, 0);
+                return;
+            }
             typename Types::PRNG temp_device{this->transition_seed};
 
-            const int start = this->get_transition_idx(row_action, col_action, 0);
             double p = temp_device.uniform();
             for (int c{}; c < this->transitions; ++c) {
                 const double q = math::to_double(this->chance_strategies[start + c]);
@@ -151,6 +204,44 @@ struct RandomTree : Types {
             return row_action * cols * transitions + col_action * transitions + chance_action;
         }
 
+        // counter based hash. Counter 0 is reserved since `PRNG{seed}` draws from splitmix64(seed) itself
+        static uint64_t hash(uint64_t seed, const uint64_t counter) {
+            seed ^= counter * 0xD1B54A32D192ED03;
+            return splitmix64(seed);
+        }
+
+        void init_chance() {
+            if constexpr (hashed_transitions) {
+                node_seed = device.uniform_64();
+            } else {
+                get_chance_strategies();
+            }
+        }
+
+        // unnormalized weight of a transition, the same distribution as `get_chance_strategies`
+        int chance_weight(const size_t transition_idx) const {
+            const int num = ((hash(node_seed, 2 * transition_idx + 2) >> 32) * chance_denominator >> 32) + 1;
+            return (typename Types::Q{num, chance_denominator} < chance_threshold) ? 0 : num;
+        }
+
+        int chance_weight_sum(const size_t start_idx) const {
+            int sum = 0;
+            for (int chance_idx = 0; chance_idx < transitions; ++chance_idx) {
+                sum += chance_weight(start_idx + chance_idx);
+            }
+            return sum;
+        }
+
+        Types::Prob get_chance_prob(const size_t start_idx, const int chance_idx) const {
+            const int sum = chance_weight_sum(start_idx);
+            if (sum == 0) {
+                return typename Types::Prob{typename Types::Q{chance_idx == 0}};
+            }
+            typename Types::Q x{chance_weight(start_idx + chance_idx), sum};
+            x.canonicalize();
+            return typename Types::Prob{x};
+        }
+
         void get_chance_strategies() {
             std::vector<typename Types::Q> chance_strategies_;
             // place holder that uses Q rationals, because they are better behaved than mpq_class Prob's
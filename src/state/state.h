@@ -3,6 +3,7 @@
 #include <types/types.h>
 
 #include <concepts>
+#include <optional>
 #include <vector>
 
 template <typename Types>
@@ -54,6 +55,62 @@ concept IsPerfectInfoStateTypes =
     } &&
     IsStateTypes<Types>;
 
+/*
+Optional. A state that can be reset to `state` in place, reusing its own buffers instead of allocating new ones.
+This must work even if this state has been moved from, e.g. by `model.add_to_batch_input(std::move(state), ...)`.
+`restore` must be declared by the state itself, so a derived state does not inherit one that would slice it.
+*/
+template <typename Types>
+concept IsRestorableStateTypes =
+    requires {
+        {
+            &Types::State::restore
+        } -> std::same_as<void (Types::State::*)(const typename Types::State &)>;
+    } &&
+    IsStateTypes<Types>;
+
+/*
+Optional. A state that can identify itself with a 64 bit hash, so that search trees can share the nodes of states
+that are reached by different paths. Equal states must have equal hashes.
+*/
+template <typename Types>
+concept IsHashableStateTypes =
+    requires(
+        const typename Types::State &const_state) {
+        {
+            const_state.get_hash()
+        } -> std::same_as<uint64_t>;
+    } &&
+    IsStateTypes<Types>;
+
+/*
+The state that a search iteration runs on. Restorable states are copied once and then restored to `root` at the start
+of every iteration. All other states are copied from `root` every iteration.
+*/
+template <typename Types>
+class IterationState
+{
+    const Types::State &root;
+    std::optional<typename Types::State> state{};
+
+public:
+    IterationState(const Types::State &root) : root{root} {}
+
+    Types::State &reset()
+    {
+        if constexpr (IsRestorableStateTypes<Types>)
+        {
+            if (state.has_value())
+            {
+                state->restore(root);
+                return *state;
+            }
+        }
+        state.emplace(root);
+        return *state;
+    }
+};
+
 template <IsTypeList Types>
 class PerfectInfoState
 {
@@ -28,6 +28,12 @@ struct MoldState : Types
         {
         }
 
+        void restore(
+            const State &state)
+        {
+            *this = state;
+        }
+
         void get_actions() const
         {
         }
@@ -135,3 +141,90 @@ struct OneSumMatrixGame : SimpleTypes
         }
     };
 };
+
+/*
+ Deterministic game whose state is only the number of turns left and a running score, so it transposes heavily.
+ Every turn adds -1, 0 or 1 to the score, depending on the joint action and the state. The row player wins if the final
+ score is positive, and the game is a draw if it is 0.
+*/
+
+template <typename Types = SimpleTypes>
+struct ScoreGame : Types
+{
+
+    class State : public PerfectInfoState<Types>
+    {
+    public:
+        size_t turns = 1;
+        int score = 0;
+        uint64_t seed = 0;
+
+        State(const size_t n_actions, const size_t turns, const uint64_t seed = 0) : turns{turns}, seed{seed}
+        {
+            this->terminal = (this->turns == 0);
+            this->init_range_actions(n_actions);
+            this->prob = typename Types::Prob{1};
+            this->obs = typename Types::Obs{};
+        }
+
+        uint64_t get_hash() const
+        {
+            return (static_cast<uint64_t>(turns) << 32) ^ static_cast<uint32_t>(score);
+        }
+
+        void randomize_transition(
+            Types::PRNG &device) const
+        {
+        }
+
+        void restore(
+            const State &state)
+        {
+            *this = state;
+        }
+
+        void get_actions() const
+        {
+        }
+
+        void get_actions(
+            Types::VectorAction &row_actions,
+            Types::VectorAction &col_actions) const
+        {
+            row_actions = this->row_actions;
+            col_actions = this->col_actions;
+        }
+
+        void apply_actions(
+            Types::Action row_action,
+            Types::Action col_action)
+        {
+            uint64_t x = get_hash() ^ (seed * 0xD1B54A32D192ED03) ^
+                         (static_cast<uint64_t>(row_action) << 48) ^ (static_cast<uint64_t>(col_action) << 56);
+            score += static_cast<int>(splitmix64(x) % 3) - 1;
+            --this->turns;
+            if (this->turns == 0)
+            {
+                this->terminal = true;
+                const int row_payoff = (score > 0) - (score < 0) + 1;
+                this->payoff = typename Types::Value{typename Types::Q{row_payoff, 2}, typename Types::Q{2 - row_payoff, 2}};
+            }
+        }
+
+        void apply_actions(
+            Types::Action row_action,
+            Types::Action col_action,
+            Types::Obs)
+        {
+            apply_actions(row_action, col_action);
+        }
+
+        void get_chance_actions(
+            Types::Action,
+            Types::Action,
+            std::vector<typename Types::Obs> &chance_actions) const
+        {
+            chance_actions.resize(1);
+        }
+    };
+};
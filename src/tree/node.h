@@ -43,6 +43,47 @@ concept IsNodeTypes =
         } -> std::same_as<const typename Types::MatrixNode *>;
     };
 
+// Nodes whose children can be created concurrently without a mutex
+template <typename Types>
+concept IsLockFreeNodeTypes =
+    requires(
+        typename Types::MatrixNode &matrix_node,
+        typename Types::ChanceNode &chance_node,
+        typename Types::Obs &obs) {
+        {
+            matrix_node.access_atomic(0, 0)
+        } -> std::same_as<typename Types::ChanceNode *>;
+        {
+            chance_node.access_atomic(obs)
+        } -> std::same_as<typename Types::MatrixNode *>;
+    } &&
+    IsNodeTypes<Types>;
+
+// Nodes that identify the matrix node after a transition by the hash and the action counts of the new state
+template <typename Types>
+concept IsTranspositionNodeTypes =
+    requires(
+        typename Types::ChanceNode &chance_node,
+        typename Types::Obs &obs,
+        uint64_t hash,
+        size_t rows) {
+        {
+            chance_node.access(obs, hash, rows, rows)
+        } -> std::same_as<typename Types::MatrixNode *>;
+    } &&
+    IsNodeTypes<Types>;
+
+// Nodes whose root must be told when a search starts a new descent from it
+template <typename Types>
+concept IsDescentNodeTypes =
+    requires(
+        typename Types::MatrixNode &matrix_node) {
+        {
+            matrix_node.begin_descent()
+        } -> std::same_as<void>;
+    } &&
+    IsNodeTypes<Types>;
+
 template <typename Types, typename Actions, typename Value>
 struct MatrixNodeData
 {
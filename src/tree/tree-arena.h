@@ -0,0 +1,207 @@
+#pragma once
+
+#include <libpinyon/math.h>
+#include <state/state.h>
+#include <tree/node.h>
+#include <types/arena.h>
+
+/*
+
+Same layout and linear scan access as DefaultNodes, but nodes are taken from an arena that is owned by the root.
+
+The default constructor makes a root, which allocates the arena. Every other node is constructed by `access`
+and only stores a pointer to the root's arena. Nodes do not delete their children; instead the whole tree is
+released at once when the root is destroyed or `reset()`. This removes malloc/free from the search loop and
+makes tear down of large trees a sweep over a few contiguous slabs.
+
+`bytes_in_use()` reports the memory occupied by the nodes of the tree (not including heap data owned by the stats)
+
+*/
+
+template <IsStateTypes Types, typename MStats, typename CStats, typename NodeActions = void,
+          typename NodeValue = void>
+struct ArenaNodes : Types {
+    friend std::ostream &operator<<(std::ostream &os, const ArenaNodes &) {
+        os << "ArenaNodes";
+        return os;
+    }
+
+    class MatrixNode;
+
+    class ChanceNode;
+
+    struct Arena;
+
+    using MatrixStats = MStats;
+    using ChanceStats = CStats;
+
+    class MatrixNode : public MatrixNodeData<Types, NodeActions, NodeValue> {
+       public:
+        Arena *arena;
+        ChanceNode *child = nullptr;
+        MatrixNode *next = nullptr;
+
+        bool terminal = false;
+        bool expanded = false;
+        bool root = false;
+
+        Types::Obs obs;
+        MatrixStats stats;
+
+        MatrixNode() : arena{new Arena{}}, root{true} {};
+        MatrixNode(Arena *arena, Types::Obs obs) : arena{arena}, obs(obs) {}
+        MatrixNode(const MatrixNode &) = delete;
+        ~MatrixNode() {
+            if (root) {
+                delete arena;
+            }
+        }
+
+        inline void expand(const size_t &, const size_t &) { expanded = true; }
+
+        inline bool is_terminal() const { return terminal; }
+
+        inline bool is_expanded() const { return expanded; }
+
+        inline void set_terminal() { terminal = true; }
+
+        inline void set_expanded() { expanded = true; }
+
+        inline void get_value(Types::Value &value) const {}
+
+        // Only valid on the root. Releases every other node in the tree and returns the root to its unexpanded state
+        void reset() {
+            arena->clear();
+            child = nullptr;
+            terminal = false;
+            expanded = false;
+            static_cast<MatrixNodeData<Types, NodeActions, NodeValue> &>(*this) = {};
+            stats.~MatrixStats();
+            new (&stats) MatrixStats{};
+        }
+
+        size_t bytes_in_use() const { return sizeof(MatrixNode) + arena->bytes_in_use(); }
+
+        ChanceNode *access(int row_idx, int col_idx) {
+            if (this->child == nullptr) {
+                this->child = arena->chance_nodes.allocate(arena, row_idx, col_idx);
+                return this->child;
+            }
+            ChanceNode *current = this->child;
+            ChanceNode *previous = this->child;
+            while (current != nullptr) {
+                previous = current;
+                if (current->row_idx == row_idx && current->col_idx == col_idx) {
+                    return current;
+                }
+                current = current->next;
+            }
+            ChanceNode *child = arena->chance_nodes.allocate(arena, row_idx, col_idx);
+            previous->next = child;
+            return child;
+        };
+
+        const ChanceNode *access(int row_idx, int col_idx) const {
+            const ChanceNode *current = this->child;
+            while (current != nullptr) {
+                if (current->row_idx == row_idx && current->col_idx == col_idx) {
+                    return current;
+                }
+                current = current->next;
+            }
+            return current;
+        };
+
+        ChanceNode *access(int row_idx, int col_idx, Types::Mutex &mutex) {
+            mutex.lock();
+            ChanceNode *child = access(row_idx, col_idx);
+            mutex.unlock();
+            return child;
+        };
+
+        size_t count_matrix_nodes() const {
+            size_t c = 1;
+            ChanceNode *current = this->child;
+            while (current != nullptr) {
+                c += current->count_matrix_nodes();
+                current = current->next;
+            }
+            return c;
+        }
+    };
+
+    class ChanceNode {
+       public:
+        Arena *arena;
+        MatrixNode *child = nullptr;
+        ChanceNode *next = nullptr;
+
+        int row_idx;
+        int col_idx;
+
+        ChanceStats stats;
+
+        ChanceNode(Arena *arena, int row_idx, int col_idx) : arena{arena}, row_idx(row_idx), col_idx(col_idx) {}
+        ChanceNode(const ChanceNode &) = delete;
+
+        MatrixNode *access(const Types::Obs &obs) {
+            if (this->child == nullptr) {
+                MatrixNode *child = arena->matrix_nodes.allocate(arena, obs);
+                this->child = child;
+                return child;
+            }
+            MatrixNode *current = this->child;
+            MatrixNode *previous = this->child;
+            while (current != nullptr) {
+                previous = current;
+                if (current->obs == obs) {
+                    return current;
+                }
+                current = current->next;
+            }
+            MatrixNode *child = arena->matrix_nodes.allocate(arena, obs);
+            previous->next = child;
+            return child;
+        };
+
+        const MatrixNode *access(const Types::Obs &obs) const {
+            const MatrixNode *current = this->child;
+            while (current != nullptr) {
+                if (current->obs == obs) {
+                    return current;
+                }
+                current = current->next;
+            }
+            return current;
+        };
+
+        MatrixNode *access(const Types::Obs &obs, Types::Mutex &mutex) {
+            mutex.lock();
+            MatrixNode *child = access(obs);
+            mutex.unlock();
+            return child;
+        };
+
+        size_t count_matrix_nodes() const {
+            size_t c = 0;
+            MatrixNode *current = this->child;
+            while (current != nullptr) {
+                c += current->count_matrix_nodes();
+                current = current->next;
+            }
+            return c;
+        }
+    };
+
+    struct Arena {
+        ObjectArena<MatrixNode> matrix_nodes;
+        ObjectArena<ChanceNode> chance_nodes;
+
+        void clear() {
+            chance_nodes.clear();
+            matrix_nodes.clear();
+        }
+
+        size_t bytes_in_use() const { return matrix_nodes.bytes_in_use() + chance_nodes.bytes_in_use(); }
+    };
+};
@@ -4,6 +4,7 @@
 #include <state/state.h>
 #include <tree/node.h>
 
+#include <memory>
 #include <unordered_map>
 
 template <IsStateTypes Types, typename MStats, typename CStats,
@@ -35,7 +36,7 @@ struct FlatNodes : Types
 
         MatrixStats stats;
 
-        ChanceNode **edges;
+        ChanceNode **edges = nullptr;
 
         MatrixNode(){};
         MatrixNode(Types::Obs obs) : obs(obs) {}
@@ -76,6 +77,63 @@ struct FlatNodes : Types
         {
         }
 
+        // See DefaultNodes::MatrixNode::promote
+        bool promote(int row_idx, int col_idx, const Types::Obs &obs, std::unique_ptr<MatrixNode> *garbage_out = nullptr)
+        {
+            MatrixNode *garbage = new MatrixNode();
+            std::swap(garbage->edges, edges);
+            garbage->rows = rows;
+            garbage->cols = cols;
+
+            MatrixNode *kept = nullptr;
+            if (garbage->edges != nullptr && row_idx < rows && col_idx < cols)
+            {
+                ChanceNode *chance_node = garbage->edges[row_idx * cols + col_idx];
+                if (chance_node != nullptr)
+                {
+                    auto it = chance_node->edges.find(obs);
+                    if (it != chance_node->edges.end())
+                    {
+                        kept = it->second;
+                        chance_node->edges.erase(it);
+                    }
+                }
+            }
+
+            if (kept != nullptr)
+            {
+                std::swap(edges, kept->edges);
+                rows = kept->rows;
+                cols = kept->cols;
+                terminal = kept->terminal;
+                expanded = kept->expanded;
+                this->obs = kept->obs;
+                std::swap(stats, kept->stats);
+                std::swap(static_cast<MatrixNodeData<Types, NodeActions, NodeValue> &>(*this),
+                          static_cast<MatrixNodeData<Types, NodeActions, NodeValue> &>(*kept));
+                delete kept;
+            }
+            else
+            {
+                rows = 0;
+                cols = 0;
+                terminal = false;
+                expanded = false;
+                stats.~MatrixStats();
+                new (&stats) MatrixStats{};
+            }
+
+            if (garbage_out != nullptr)
+            {
+                garbage_out->reset(garbage);
+            }
+            else
+            {
+                delete garbage;
+            }
+            return kept != nullptr;
+        }
+
         ChanceNode *access(int row_idx, int col_idx)
         {
             const int child_idx = row_idx * cols + col_idx;
@@ -184,6 +242,14 @@ template <IsStateTypes Types, typename MStats, typename CStats,
           typename stores_actions, typename stores_value>
 FlatNodes<Types, MStats, CStats, stores_actions, stores_value>::MatrixNode::~MatrixNode()
 {
+    if (edges != nullptr)
+    {
+        const size_t n_children = rows * cols;
+        for (size_t i = 0; i < n_children; ++i)
+        {
+            delete edges[i];
+        }
+    }
     delete[] edges;
 }
 
@@ -0,0 +1,265 @@
+#pragma once
+
+#include <libpinyon/math.h>
+#include <state/state.h>
+#include <tree/node.h>
+#include <types/block-vector.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+
+/*
+
+Matrix nodes whose expanded data lives in one block, allocated when the node is expanded.
+
+The block is cache line aligned. It starts with the per-action arrays of the bandit stats, laid out by `StatsLayout`,
+followed by all `rows * cols` chance nodes. A chance node is found by its index, so selection reads the stats and the
+chance node without following any other pointer.
+
+`StatsLayout<MatrixStats>` is the accessor layer between the nodes and the bandits. The stats of Exp3 and Exp3Fat are
+packed if their vectors are `BlockVector`s (e.g. `RandomTreePackedTypes`). Any other stats keep their own storage,
+and only the chance nodes are packed.
+
+*/
+
+template <typename MatrixStats>
+struct StatsLayout
+{
+    static size_t bytes(const size_t rows, const size_t cols)
+    {
+        return 0;
+    }
+
+    static void bind(MatrixStats &stats, std::byte *storage, const size_t rows, const size_t cols)
+    {
+    }
+};
+
+template <typename MatrixStats>
+concept IsPackedGainsStats =
+    requires(MatrixStats &stats) {
+        stats.row_gains.bind(stats.row_gains.data(), 0);
+        stats.col_gains.bind(stats.col_gains.data(), 0);
+        stats.row_visits.bind(stats.row_visits.data(), 0);
+        stats.col_visits.bind(stats.col_visits.data(), 0);
+    };
+
+// gains, then visits, for the row and then the column player
+template <typename MatrixStats>
+    requires IsPackedGainsStats<MatrixStats>
+struct StatsLayout<MatrixStats>
+{
+    using Real = std::remove_reference_t<decltype(*std::declval<MatrixStats &>().row_gains.data())>;
+    using Int = std::remove_reference_t<decltype(*std::declval<MatrixStats &>().row_visits.data())>;
+
+    static constexpr size_t align(const size_t n)
+    {
+        constexpr size_t a = std::max(alignof(Real), alignof(Int));
+        return (n + a - 1) / a * a;
+    }
+
+    static size_t bytes(const size_t rows, const size_t cols)
+    {
+        return align((rows + cols) * sizeof(Real)) + align((rows + cols) * sizeof(Int));
+    }
+
+    static void bind(MatrixStats &stats, std::byte *storage, const size_t rows, const size_t cols)
+    {
+        Real *gains = reinterpret_cast<Real *>(storage);
+        Int *visits = reinterpret_cast<Int *>(storage + align((rows + cols) * sizeof(Real)));
+        stats.row_gains.bind(gains, rows);
+        stats.col_gains.bind(gains + rows, cols);
+        stats.row_visits.bind(visits, rows);
+        stats.col_visits.bind(visits + rows, cols);
+    }
+};
+
+template <IsStateTypes Types, typename MStats, typename CStats, typename NodeActions = void,
+          typename NodeValue = void>
+struct PackedNodes : Types
+{
+    friend std::ostream &operator<<(std::ostream &os, const PackedNodes &)
+    {
+        os << "PackedNodes";
+        return os;
+    }
+
+    class MatrixNode;
+
+    class ChanceNode;
+
+    using MatrixStats = MStats;
+    using ChanceStats = CStats;
+
+    static constexpr size_t cache_line = 64;
+
+    // Owns the block and the chance nodes in it. Declared before the stats, so the stats are destroyed first
+    struct Block
+    {
+        std::byte *data = nullptr;
+        ChanceNode *chance_nodes = nullptr;
+        size_t n_chance_nodes = 0;
+
+        Block() {}
+        Block(const Block &) = delete;
+        ~Block()
+        {
+            std::destroy(chance_nodes, chance_nodes + n_chance_nodes);
+            ::operator delete(data, std::align_val_t{cache_line});
+        }
+
+        // returns the storage for the stats, which is at the start of the block
+        std::byte *allocate(const size_t stats_bytes, const size_t n)
+        {
+            const size_t offset = (stats_bytes + alignof(ChanceNode) - 1) / alignof(ChanceNode) * alignof(ChanceNode);
+            data = static_cast<std::byte *>(
+                ::operator new(offset + n * sizeof(ChanceNode), std::align_val_t{cache_line}));
+            chance_nodes = reinterpret_cast<ChanceNode *>(data + offset);
+            std::uninitialized_default_construct_n(chance_nodes, n);
+            n_chance_nodes = n;
+            return data;
+        }
+    };
+
+    class MatrixNode : public MatrixNodeData<Types, NodeActions, NodeValue>
+    {
+    public:
+        Block block;
+        uint32_t rows = 0;
+        uint32_t cols = 0;
+
+        bool terminal = false;
+        bool expanded = false;
+
+        MatrixStats stats;
+        MatrixNode *next = nullptr;
+        Types::Obs obs;
+
+        MatrixNode() {}
+        MatrixNode(Types::Obs obs) : obs(obs) {}
+        MatrixNode(const MatrixNode &) = delete;
+
+        inline void expand(const size_t &rows, const size_t &cols)
+        {
+            this->rows = rows;
+            this->cols = cols;
+            std::byte *storage = block.allocate(StatsLayout<MatrixStats>::bytes(rows, cols), rows * cols);
+            StatsLayout<MatrixStats>::bind(stats, storage, rows, cols);
+            expanded = true;
+        }
+
+        inline bool is_terminal() const
+        {
+            return terminal;
+        }
+
+        inline bool is_expanded() const
+        {
+            return expanded;
+        }
+
+        inline void set_terminal()
+        {
+            terminal = true;
+        }
+
+        inline void set_expanded()
+        {
+            expanded = true;
+        }
+
+        inline void get_value(Types::Value &value) const
+        {
+        }
+
+        ChanceNode *access(int row_idx, int col_idx)
+        {
+            return &block.chance_nodes[row_idx * cols + col_idx];
+        }
+
+        const ChanceNode *access(int row_idx, int col_idx) const
+        {
+            return &block.chance_nodes[row_idx * cols + col_idx];
+        }
+
+        ChanceNode *access(int row_idx, int col_idx, Types::Mutex &mutex)
+        {
+            return access(row_idx, col_idx);
+        }
+
+        size_t count_matrix_nodes() const
+        {
+            size_t c = 1;
+            for (size_t i = 0; i < block.n_chance_nodes; ++i)
+            {
+                c += block.chance_nodes[i].count_matrix_nodes();
+            }
+            return c;
+        }
+    };
+
+    class ChanceNode
+    {
+    public:
+        MatrixNode *child = nullptr;
+        ChanceStats stats{};
+
+        ChanceNode() {}
+        ChanceNode(const ChanceNode &) = delete;
+        ~ChanceNode()
+        {
+            while (child != nullptr)
+            {
+                MatrixNode *victim = child;
+                child = child->next;
+                delete victim;
+            }
+        }
+
+        MatrixNode *access(const Types::Obs &obs)
+        {
+            MatrixNode **link = &child;
+            while (*link != nullptr)
+            {
+                if ((*link)->obs == obs)
+                {
+                    return *link;
+                }
+                link = &(*link)->next;
+            }
+            *link = new MatrixNode(obs);
+            return *link;
+        }
+
+        const MatrixNode *access(const Types::Obs &obs) const
+        {
+            const MatrixNode *current = child;
+            while (current != nullptr && !(current->obs == obs))
+            {
+                current = current->next;
+            }
+            return current;
+        }
+
+        MatrixNode *access(const Types::Obs &obs, Types::Mutex &mutex)
+        {
+            mutex.lock();
+            MatrixNode *matrix_node = access(obs);
+            mutex.unlock();
+            return matrix_node;
+        }
+
+        size_t count_matrix_nodes() const
+        {
+            size_t c = 0;
+            for (const MatrixNode *current = child; current != nullptr; current = current->next)
+            {
+                c += current->count_matrix_nodes();
+            }
+            return c;
+        }
+    };
+};
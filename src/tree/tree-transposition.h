@@ -0,0 +1,291 @@
+#pragma once
+
+#include <libpinyon/math.h>
+#include <state/state.h>
+#include <tree/node.h>
+#include <types/random.h>
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+/*
+
+Matrix nodes are shared by every path that reaches the same state, so the search tree is a DAG.
+
+The matrix nodes live in a hash table owned by the root and keyed by `state.get_hash()` (see `IsHashableStateTypes`).
+A chance node only stores the key of each observation and looks the matrix node up in the table on every visit.
+If the state is not hashable, the key of a child is a hash of its path, and the table stores an ordinary tree.
+
+The table is 4-way set associative and its capacity is fixed when the root is constructed. When a bucket is full, its
+least recently used entry is replaced and the chance nodes of that entry are deleted. Entries that the current descent
+touched are never replaced. If a whole bucket was touched by the current descent, the new node is kept outside the
+table until the next descent.
+
+Each entry also stores a verifier, the action counts of its state, and a lookup only hits if the key and the verifier
+both match. States whose hashes collide but whose action counts differ get separate nodes, so a node's stats are
+always sized for the state that reaches it. Distinct states with equal hashes and equal action counts still share a
+node. Path keys use a verifier of 0.
+
+The search marks the start of each descent with `root.begin_descent()` (see `IsDescentNodeTypes`). Without it nothing
+is ever replaced, so searches that do not call it reject these nodes at compile time. Anything else, such as inspecting
+the tree after a search, leaves the nodes of the last descent alone. These nodes are not thread safe.
+
+*/
+
+template <IsStateTypes Types, typename MStats, typename CStats, typename NodeActions = void,
+          typename NodeValue = void>
+struct TranspositionNodes : Types {
+    friend std::ostream &operator<<(std::ostream &os, const TranspositionNodes &) {
+        os << "TranspositionNodes";
+        return os;
+    }
+
+    class MatrixNode;
+
+    class ChanceNode;
+
+    struct Table;
+
+    using MatrixStats = MStats;
+    using ChanceStats = CStats;
+
+    static constexpr size_t default_capacity = 1 << 16;
+
+    // key of a child that is identified by its path instead of a state hash
+    static uint64_t combine(uint64_t key, const uint64_t x) {
+        key ^= x * 0xBF58476D1CE4E5B9;
+        return splitmix64(key);
+    }
+
+    // checked alongside a state hash, so colliding states with different action counts never share a node
+    static uint64_t verifier(const size_t rows, const size_t cols) {
+        return (static_cast<uint64_t>(rows) << 32 | static_cast<uint64_t>(cols)) + 1;
+    }
+
+    class MatrixNode : public MatrixNodeData<Types, NodeActions, NodeValue> {
+       public:
+        Table *table;
+        ChanceNode *child = nullptr;
+        uint64_t key = 0;
+
+        bool terminal = false;
+        bool expanded = false;
+        bool root = false;
+
+        MatrixStats stats;
+
+        // `capacity` is the maximum number of matrix nodes in the table, not counting the root
+        MatrixNode() : MatrixNode{default_capacity} {}
+        explicit MatrixNode(const size_t capacity) : table{new Table{capacity}}, root{true} {}
+        MatrixNode(Table *table, uint64_t key) : table{table}, key{key} {}
+        MatrixNode(const MatrixNode &) = delete;
+        ~MatrixNode() {
+            while (this->child != nullptr) {
+                ChanceNode *victim = this->child;
+                this->child = this->child->next;
+                delete victim;
+            }
+            if (root) {
+                delete table;
+            }
+        }
+
+        inline void expand(const size_t &, const size_t &) { expanded = true; }
+
+        inline bool is_terminal() const { return terminal; }
+
+        inline bool is_expanded() const { return expanded; }
+
+        inline void set_terminal() { terminal = true; }
+
+        inline void set_expanded() { expanded = true; }
+
+        inline void get_value(Types::Value &value) const {}
+
+        // only valid on the root. Frees the nodes that did not fit in the table during the last descent
+        void begin_descent() { table->begin_descent(); }
+
+        ChanceNode *access(int row_idx, int col_idx) {
+            if (this->child == nullptr) {
+                this->child = new ChanceNode(table, combine(key, row_idx * 0x10000 + col_idx), row_idx, col_idx);
+                return this->child;
+            }
+            ChanceNode *current = this->child;
+            ChanceNode *previous = this->child;
+            while (current != nullptr) {
+                previous = current;
+                if (current->row_idx == row_idx && current->col_idx == col_idx) {
+                    return current;
+                }
+                current = current->next;
+            }
+            ChanceNode *child = new ChanceNode(table, combine(key, row_idx * 0x10000 + col_idx), row_idx, col_idx);
+            previous->next = child;
+            return child;
+        };
+
+        const ChanceNode *access(int row_idx, int col_idx) const {
+            const ChanceNode *current = this->child;
+            while (current != nullptr) {
+                if (current->row_idx == row_idx && current->col_idx == col_idx) {
+                    return current;
+                }
+                current = current->next;
+            }
+            return current;
+        };
+
+        // only valid on the root. The root itself is not in the table
+        size_t count_matrix_nodes() const { return 1 + table->size; }
+    };
+
+    class ChanceNode {
+       public:
+        Table *table;
+        ChanceNode *next = nullptr;
+        uint64_t key;
+
+        int row_idx;
+        int col_idx;
+
+        ChanceStats stats;
+
+        struct Edge {
+            typename Types::Obs obs;
+            uint64_t key;
+            uint64_t verifier;
+        };
+
+        // the key of the matrix node reached by each observation
+        std::vector<Edge> edges;
+
+        ChanceNode(Table *table, uint64_t key, int row_idx, int col_idx)
+            : table{table}, key{key}, row_idx(row_idx), col_idx(col_idx) {}
+        ChanceNode(const ChanceNode &) = delete;
+
+        // `rows` and `cols` are the action counts of the state with this hash
+        MatrixNode *access(const Types::Obs &obs, const uint64_t hash, const size_t rows, const size_t cols) {
+            const uint64_t state_verifier = verifier(rows, cols);
+            if (std::find_if(edges.begin(), edges.end(), [&obs](const Edge &edge) { return edge.obs == obs; }) ==
+                edges.end()) {
+                edges.push_back({obs, hash, state_verifier});
+            }
+            return table->access(hash, state_verifier);
+        }
+
+        MatrixNode *access(const Types::Obs &obs) {
+            for (const Edge &edge : edges) {
+                if (edge.obs == obs) {
+                    return table->access(edge.key, edge.verifier);
+                }
+            }
+            const uint64_t child_key = combine(key, edges.size());
+            edges.push_back({obs, child_key, 0});
+            return table->access(child_key, 0);
+        }
+
+        // nullptr if the observation was never seen or its node has been replaced
+        const MatrixNode *access(const Types::Obs &obs) const {
+            for (const Edge &edge : edges) {
+                if (edge.obs == obs) {
+                    return table->find(edge.key, edge.verifier);
+                }
+            }
+            return nullptr;
+        }
+    };
+
+    struct Table {
+        struct Entry {
+            uint64_t key = 0;
+            uint64_t verifier = 0;
+            uint64_t last_access = 0;
+            MatrixNode *node = nullptr;
+        };
+
+        static constexpr size_t ways = 4;
+
+        std::vector<Entry> entries;
+        std::vector<MatrixNode *> overflow;
+        int shift;
+        uint64_t clock = 0;
+        uint64_t descent = 0;
+        size_t size = 0;
+
+        Table(const size_t capacity) {
+            const size_t buckets = std::bit_ceil(std::max(capacity / ways, size_t{2}));
+            entries.resize(buckets * ways);
+            shift = 64 - std::countr_zero(buckets);
+        }
+
+        Table(const Table &) = delete;
+
+        ~Table() {
+            for (Entry &entry : entries) {
+                delete entry.node;
+            }
+            clear_overflow();
+        }
+
+        void begin_descent() {
+            descent = ++clock;
+            clear_overflow();
+        }
+
+        Entry *bucket(const uint64_t key) { return &entries[((key * 0x9E3779B97F4A7C15) >> shift) * ways]; }
+
+        const MatrixNode *find(const uint64_t key, const uint64_t verifier) const {
+            const Entry *b = &entries[((key * 0x9E3779B97F4A7C15) >> shift) * ways];
+            for (size_t w = 0; w < ways; ++w) {
+                if (b[w].node != nullptr && b[w].key == key && b[w].verifier == verifier) {
+                    return b[w].node;
+                }
+            }
+            return nullptr;
+        }
+
+        // an entry with the same key but another verifier is a different state, so it is a miss
+        MatrixNode *access(const uint64_t key, const uint64_t verifier) {
+            Entry *b = bucket(key);
+            Entry *victim = nullptr;
+            for (size_t w = 0; w < ways; ++w) {
+                if (b[w].node == nullptr) {
+                    victim = victim == nullptr ? &b[w] : victim;
+                } else if (b[w].key == key && b[w].verifier == verifier) {
+                    b[w].last_access = ++clock;
+                    return b[w].node;
+                }
+            }
+            if (victim == nullptr) {
+                for (size_t w = 0; w < ways; ++w) {
+                    if (b[w].last_access < descent && (victim == nullptr || b[w].last_access < victim->last_access)) {
+                        victim = &b[w];
+                    }
+                }
+            }
+            MatrixNode *node = new MatrixNode{this, key};
+            if (victim == nullptr) {
+                overflow.push_back(node);
+                return node;
+            }
+            if (victim->node == nullptr) {
+                ++size;
+            } else {
+                delete victim->node;
+            }
+            *victim = {key, verifier, ++clock, node};
+            return node;
+        }
+
+       private:
+        void clear_overflow() {
+            for (MatrixNode *node : overflow) {
+                delete node;
+            }
+            overflow.clear();
+        }
+    };
+};
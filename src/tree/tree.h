@@ -4,6 +4,9 @@
 #include <state/state.h>
 #include <tree/node.h>
 
+#include <atomic>
+#include <memory>
+
 /*
 
 Identification of a recently transitioned state with the search tree
@@ -48,18 +51,70 @@ struct DefaultNodes : Types {
         MatrixNode(const MatrixNode &) = delete;
         ~MatrixNode();
 
-        inline void expand(const size_t &, const size_t &) { expanded = true; }
+        // release/acquire so that a thread which sees the node expanded also sees the stats written by `expand`
+        inline void expand(const size_t &, const size_t &) { set_expanded(); }
 
         inline bool is_terminal() const { return terminal; }
 
-        inline bool is_expanded() const { return expanded; }
+        inline bool is_expanded() const {
+            return std::atomic_ref<bool>{const_cast<bool &>(expanded)}.load(std::memory_order_acquire);
+        }
 
         inline void set_terminal() { terminal = true; }
 
-        inline void set_expanded() { expanded = true; }
+        inline void set_expanded() { std::atomic_ref<bool>{expanded}.store(true, std::memory_order_release); }
 
         inline void get_value(Types::Value &value) const {}
 
+        // Make the matrix node reached by (row_idx, col_idx, obs) the new root, keeping its stats and subtree.
+        // Every other branch is deleted, unless `garbage_out` is given: then they are moved into it, so the caller can free
+        // them later, e.g. on a thread it joins, and the next search can start immediately.
+        // Returns false if that node was never visited, in which case this node is simply cleared.
+        bool promote(int row_idx, int col_idx, const Types::Obs &obs, std::unique_ptr<MatrixNode> *garbage_out = nullptr) {
+            MatrixNode *garbage = new MatrixNode();
+            garbage->child = this->child;
+            this->child = nullptr;
+
+            MatrixNode *kept = nullptr;
+            for (ChanceNode *chance_node = garbage->child; chance_node != nullptr; chance_node = chance_node->next) {
+                if (chance_node->row_idx == row_idx && chance_node->col_idx == col_idx) {
+                    MatrixNode **link = &chance_node->child;
+                    while (*link != nullptr && !((*link)->obs == obs)) {
+                        link = &(*link)->next;
+                    }
+                    if (*link != nullptr) {
+                        kept = *link;
+                        *link = kept->next;
+                        kept->next = nullptr;
+                    }
+                    break;
+                }
+            }
+
+            if (kept != nullptr) {
+                std::swap(this->child, kept->child);
+                terminal = kept->terminal;
+                expanded = kept->expanded;
+                this->obs = kept->obs;
+                std::swap(stats, kept->stats);
+                std::swap(static_cast<MatrixNodeData<Types, NodeActions, NodeValue> &>(*this),
+                          static_cast<MatrixNodeData<Types, NodeActions, NodeValue> &>(*kept));
+                delete kept;
+            } else {
+                terminal = false;
+                expanded = false;
+                stats.~MatrixStats();
+                new (&stats) MatrixStats{};
+            }
+
+            if (garbage_out != nullptr) {
+                garbage_out->reset(garbage);
+            } else {
+                delete garbage;
+            }
+            return kept != nullptr;
+        }
+
         ChanceNode *access(int row_idx, int col_idx) {
             if (this->child == nullptr) {
                 this->child = new ChanceNode(row_idx, col_idx);
@@ -118,6 +173,32 @@ struct DefaultNodes : Types {
             return child;
         };
 
+        // Lock-free alternative to the mutex overload. New children are prepended with a CAS on the head
+        // of the list, so a node's `next` never changes after it is published and readers need no lock.
+        ChanceNode *access_atomic(int row_idx, int col_idx) {
+            std::atomic_ref<ChanceNode *> head{this->child};
+            ChanceNode *first = head.load(std::memory_order_acquire);
+            ChanceNode *scanned = nullptr;
+            ChanceNode *child = nullptr;
+            while (true) {
+                for (ChanceNode *current = first; current != scanned; current = current->next) {
+                    if (current->row_idx == row_idx && current->col_idx == col_idx) {
+                        delete child;
+                        return current;
+                    }
+                }
+                if (child == nullptr) {
+                    child = new ChanceNode(row_idx, col_idx);
+                }
+                child->next = first;
+                scanned = first;
+                // on failure `first` is the new head, and only the nodes in front of `scanned` need checking
+                if (head.compare_exchange_weak(first, child, std::memory_order_release, std::memory_order_acquire)) {
+                    return child;
+                }
+            }
+        }
+
         size_t count_matrix_nodes() const {
             size_t c = 1;
             ChanceNode *current = this->child;
@@ -205,6 +286,29 @@ struct DefaultNodes : Types {
             return child;
         };
 
+        MatrixNode *access_atomic(const Types::Obs &obs) {
+            std::atomic_ref<MatrixNode *> head{this->child};
+            MatrixNode *first = head.load(std::memory_order_acquire);
+            MatrixNode *scanned = nullptr;
+            MatrixNode *child = nullptr;
+            while (true) {
+                for (MatrixNode *current = first; current != scanned; current = current->next) {
+                    if (current->obs == obs) {
+                        delete child;
+                        return current;
+                    }
+                }
+                if (child == nullptr) {
+                    child = new MatrixNode(obs);
+                }
+                child->next = first;
+                scanned = first;
+                if (head.compare_exchange_weak(first, child, std::memory_order_release, std::memory_order_acquire)) {
+                    return child;
+                }
+            }
+        }
+
         size_t count_matrix_nodes() const {
             size_t c = 0;
             MatrixNode *current = this->child;
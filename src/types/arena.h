@@ -0,0 +1,135 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+/*
+
+Bump allocator for objects of a single type.
+
+Objects are placement-new'd into slabs that are never moved and never returned to the system until the arena
+is destroyed. Slab k holds (base_size << k) objects, so the slab directory is a small fixed array and the
+slab/offset of an object index is computed in O(1) without any search.
+
+allocate() is safe to call from multiple threads; an index is claimed with a single fetch_add and the only
+lock is taken when a new slab is first touched.
+
+clear() forgets every object at once and keeps the slabs for reuse. If T is trivially destructible this is O(1),
+otherwise the slabs are swept front to back to run the destructors (there are still no calls to free).
+clear() is not thread safe.
+
+*/
+
+template <typename T, size_t log_base_size = 6>
+class ObjectArena
+{
+    struct alignas(T) Storage
+    {
+        std::byte data[sizeof(T)];
+    };
+
+    static constexpr size_t max_slabs = 48;
+
+    std::atomic<Storage *> slabs[max_slabs]{};
+    std::atomic<size_t> count{0};
+    std::mutex slab_mutex{};
+
+    static constexpr size_t slab_size(const size_t slab_idx)
+    {
+        return size_t{1} << (log_base_size + slab_idx);
+    }
+
+    static constexpr size_t slab_start(const size_t slab_idx)
+    {
+        return (size_t{1} << log_base_size) * ((size_t{1} << slab_idx) - 1);
+    }
+
+    Storage *get_slab(const size_t slab_idx)
+    {
+        std::lock_guard<std::mutex> lock{slab_mutex};
+        Storage *slab = slabs[slab_idx].load(std::memory_order_acquire);
+        if (slab == nullptr)
+        {
+            slab = new Storage[slab_size(slab_idx)];
+            slabs[slab_idx].store(slab, std::memory_order_release);
+        }
+        return slab;
+    }
+
+public:
+    ObjectArena() {}
+    ObjectArena(const ObjectArena &) = delete;
+    ObjectArena &operator=(const ObjectArena &) = delete;
+
+    ~ObjectArena()
+    {
+        clear();
+        for (auto &slab : slabs)
+        {
+            delete[] slab.load(std::memory_order_relaxed);
+        }
+    }
+
+    template <typename... Args>
+    T *allocate(Args &&...args)
+    {
+        const size_t index = count.fetch_add(1, std::memory_order_relaxed);
+        const size_t slab_idx = std::bit_width((index >> log_base_size) + 1) - 1;
+        Storage *slab = slabs[slab_idx].load(std::memory_order_acquire);
+        if (slab == nullptr) [[unlikely]]
+        {
+            slab = get_slab(slab_idx);
+        }
+        return new (slab + (index - slab_start(slab_idx))) T(std::forward<Args>(args)...);
+    }
+
+    void clear()
+    {
+        const size_t n = count.load(std::memory_order_relaxed);
+        if constexpr (!std::is_trivially_destructible_v<T>)
+        {
+            for (size_t slab_idx = 0; slab_idx < max_slabs && slab_start(slab_idx) < n; ++slab_idx)
+            {
+                Storage *slab = slabs[slab_idx].load(std::memory_order_relaxed);
+                const size_t end = std::min(slab_size(slab_idx), n - slab_start(slab_idx));
+                for (size_t offset = 0; offset < end; ++offset)
+                {
+                    std::launder(reinterpret_cast<T *>(slab + offset))->~T();
+                }
+            }
+        }
+        count.store(0, std::memory_order_relaxed);
+    }
+
+    size_t size() const
+    {
+        return count.load(std::memory_order_relaxed);
+    }
+
+    // bytes occupied by live objects
+    size_t bytes_in_use() const
+    {
+        return size() * sizeof(Storage);
+    }
+
+    // bytes held by the arena, including unused capacity
+    size_t bytes_reserved() const
+    {
+        size_t bytes = 0;
+        for (size_t slab_idx = 0; slab_idx < max_slabs; ++slab_idx)
+        {
+            if (slabs[slab_idx].load(std::memory_order_relaxed) != nullptr)
+            {
+                bytes += slab_size(slab_idx) * sizeof(Storage);
+            }
+        }
+        return bytes;
+    }
+};
@@ -33,18 +33,16 @@ struct A
 
         bool operator==(const Array &other) const
         {
-            for (int i = 0; i < _size; ++i) {
-                if ((*this)[i] != other[i]) {
-                    return false;
-                }
-            }
-            return _size == other._size;
+            return std::equal(this->begin(), this->end(), other.begin(), other.end());
         }
 
+        // only the new elements are set to `value`, like `std::vector`
         void resize(size_t n, T value)
         {
+            if (n > _size) {
+                std::fill(this->begin() + _size, this->begin() + n, value);
+            }
             _size = n;
-            std::fill(this->begin(), this->end(), value);
         }
 
         void resize(size_t n)
@@ -57,6 +55,11 @@ struct A
             return _size;
         }
 
+        bool empty() const
+        {
+            return _size == 0;
+        }
+
         void clear () {
             _size = 0;
         }
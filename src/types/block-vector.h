@@ -0,0 +1,264 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <initializer_list>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+/*
+
+A vector that can be bound to storage it does not own.
+
+By default `BlockVector<T>` owns a heap array and behaves like `std::vector`. After `bind(storage, capacity)` its
+elements live in `storage`, which belongs to someone else (e.g. the block of a `PackedNodes` matrix node), and
+growing within `capacity` never allocates. Growing past it moves the elements back to the heap.
+Copies are always owning, so a copy of a bound vector stays valid after the storage is released.
+
+*/
+
+template <typename T>
+class BlockVector
+{
+    T *_data = nullptr;
+    size_t _size = 0;
+    size_t _capacity = 0;
+    bool _owned = true;
+
+public:
+    using value_type = T;
+    using iterator = T *;
+    using const_iterator = const T *;
+
+    BlockVector() {}
+
+    explicit BlockVector(const size_t n)
+    {
+        resize(n);
+    }
+
+    BlockVector(const size_t n, const T &value)
+    {
+        resize(n, value);
+    }
+
+    BlockVector(std::initializer_list<T> list)
+    {
+        reserve(list.size());
+        std::uninitialized_copy(list.begin(), list.end(), _data);
+        _size = list.size();
+    }
+
+    BlockVector(const BlockVector &other)
+    {
+        reserve(other._size);
+        std::uninitialized_copy(other.begin(), other.end(), _data);
+        _size = other._size;
+    }
+
+    BlockVector(BlockVector &&other) noexcept
+    {
+        if (other._owned)
+        {
+            std::swap(_data, other._data);
+            std::swap(_size, other._size);
+            std::swap(_capacity, other._capacity);
+        }
+        else
+        {
+            reserve(other._size);
+            std::uninitialized_move(other.begin(), other.end(), _data);
+            _size = other._size;
+        }
+    }
+
+    BlockVector &operator=(const BlockVector &other)
+    {
+        if (this != &other)
+        {
+            clear();
+            reserve(other._size);
+            std::uninitialized_copy(other.begin(), other.end(), _data);
+            _size = other._size;
+        }
+        return *this;
+    }
+
+    BlockVector &operator=(BlockVector &&other) noexcept
+    {
+        if (this != &other)
+        {
+            if (_owned && other._owned)
+            {
+                std::swap(_data, other._data);
+                std::swap(_size, other._size);
+                std::swap(_capacity, other._capacity);
+            }
+            else
+            {
+                clear();
+                reserve(other._size);
+                std::uninitialized_move(other.begin(), other.end(), _data);
+                _size = other._size;
+            }
+        }
+        return *this;
+    }
+
+    ~BlockVector()
+    {
+        clear();
+        release();
+    }
+
+    // `storage` must be suitably aligned for `capacity` elements and outlive this vector, or the next `bind`
+    void bind(T *storage, const size_t capacity)
+    {
+        const size_t n = std::min(_size, capacity);
+        std::uninitialized_move(_data, _data + n, storage);
+        std::destroy(_data, _data + _size);
+        release();
+        _data = storage;
+        _size = n;
+        _capacity = capacity;
+        _owned = false;
+    }
+
+    bool is_bound() const
+    {
+        return !_owned;
+    }
+
+    void reserve(const size_t n)
+    {
+        if (n <= _capacity)
+        {
+            return;
+        }
+        T *data = static_cast<T *>(::operator new(n * sizeof(T), std::align_val_t{alignof(T)}));
+        std::uninitialized_move(_data, _data + _size, data);
+        std::destroy(_data, _data + _size);
+        release();
+        _data = data;
+        _capacity = n;
+        _owned = true;
+    }
+
+    void resize(const size_t n)
+    {
+        if (n > _size)
+        {
+            reserve(n);
+            std::uninitialized_value_construct(_data + _size, _data + n);
+        }
+        else
+        {
+            std::destroy(_data + n, _data + _size);
+        }
+        _size = n;
+    }
+
+    void resize(const size_t n, const T &value)
+    {
+        if (n > _size)
+        {
+            reserve(n);
+            std::uninitialized_fill(_data + _size, _data + n, value);
+        }
+        else
+        {
+            std::destroy(_data + n, _data + _size);
+        }
+        _size = n;
+    }
+
+    void push_back(const T &value)
+    {
+        if (_size == _capacity)
+        {
+            reserve(std::max(2 * _capacity, size_t{4}));
+        }
+        new (_data + _size) T{value};
+        ++_size;
+    }
+
+    void clear()
+    {
+        std::destroy(_data, _data + _size);
+        _size = 0;
+    }
+
+    size_t size() const
+    {
+        return _size;
+    }
+
+    size_t capacity() const
+    {
+        return _capacity;
+    }
+
+    bool empty() const
+    {
+        return _size == 0;
+    }
+
+    T *data()
+    {
+        return _data;
+    }
+
+    const T *data() const
+    {
+        return _data;
+    }
+
+    T &operator[](const size_t i)
+    {
+        return _data[i];
+    }
+
+    const T &operator[](const size_t i) const
+    {
+        return _data[i];
+    }
+
+    T *begin()
+    {
+        return _data;
+    }
+
+    T *end()
+    {
+        return _data + _size;
+    }
+
+    const T *begin() const
+    {
+        return _data;
+    }
+
+    const T *end() const
+    {
+        return _data + _size;
+    }
+
+    bool operator==(const BlockVector &other) const
+    {
+        return std::equal(begin(), end(), other.begin(), other.end());
+    }
+
+private:
+    void release()
+    {
+        if (_owned && _data != nullptr)
+        {
+            ::operator delete(_data, std::align_val_t{alignof(T)});
+        }
+        _data = nullptr;
+        _capacity = 0;
+        _owned = true;
+    }
+};
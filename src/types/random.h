@@ -3,8 +3,46 @@
 #include <gmpxx.h>
 
 #include <array>
+#include <bit>
+#include <cstdint>
 #include <random>
 
+/*
+
+`prng` wraps std::mt19937, which has about 5KB of state. `xoshiro` and `pcg64` are under 50 bytes, so they are cheap
+to copy into threads, models and states, and cheap to construct from a seed. Both have `split()` for handing
+independent streams to threads.
+
+*/
+
+// Expands a single seed into generator state
+inline uint64_t splitmix64(uint64_t &x) {
+    uint64_t z = (x += 0x9E3779B97F4A7C15);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EB;
+    return z ^ (z >> 31);
+}
+
+// Uniform double in [0, 1) from the top 52 bits, by setting them as the mantissa of a double in [1, 2)
+inline double uniform_from_bits(uint64_t x) {
+    return std::bit_cast<double>((x >> 12) | 0x3FF0000000000000) - 1.0;
+}
+
+// Lemire's multiply-shift: unbiased integer in [0, n), usually without a division
+template <typename PRNG>
+inline int lemire_int(PRNG &device, const uint64_t n) {
+    __uint128_t m = static_cast<__uint128_t>(device.uniform_64()) * n;
+    uint64_t low = static_cast<uint64_t>(m);
+    if (low < n) {
+        const uint64_t threshold = -n % n;
+        while (low < threshold) {
+            m = static_cast<__uint128_t>(device.uniform_64()) * n;
+            low = static_cast<uint64_t>(m);
+        }
+    }
+    return static_cast<int>(m >> 64);
+}
+
 class prng {
     std::mt19937::result_type seed;
     std::mt19937 engine;
@@ -23,33 +61,36 @@ class prng {
     double uniform() { return uniform_(engine); }
 
     // Random integer in [0, n)
-    int random_int(int n) { return uniform_64_(engine) % n; }
+    int random_int(int n) { return lemire_int(*this, n); }
 
     uint64_t uniform_64() { return uniform_64_(engine); }
 
+    // The first index where the running difference reaches 0. The difference never increases, so that index is the
+    // count of positive differences and the scan needs no data dependent branch. See `Strategy` and `AliasTable` in
+    // strategy.h for distributions that are sampled more than once
     template <template <typename...> typename Vector, typename T>
         requires(!std::is_same_v<T, mpq_class>)
     int sample_pdf(const Vector<T> &input) {
         double p = uniform();
-        for (int i = 0; i < input.size(); ++i) {
+        const int size = input.size();
+        int index = 0;
+        for (int i = 0; i < size; ++i) {
             p -= static_cast<double>(input[i]);
-            if (p <= 0) {
-                return i;
-            }
+            index += p > 0;
         }
-        return 0;
+        return index < size ? index : 0;
     }
 
     template <template <typename...> typename Vector>
     int sample_pdf(const Vector<mpq_class> &input) {
         double p = uniform();
-        for (int i = 0; i < input.size(); ++i) {
+        const int size = input.size();
+        int index = 0;
+        for (int i = 0; i < size; ++i) {
             p -= input[i].get_d();
-            if (p <= 0) {
-                return i;
-            }
+            index += p > 0;
         }
-        return 0;
+        return index < size ? index : 0;
     }
 
     template <template <typename> typename Vector>
@@ -77,32 +118,32 @@ class xor_shift {
     double uniform() { return static_cast<double>(xorshift()) / static_cast<double>(UINT64_MAX); }
 
     // Random integer in [0, n)
-    int random_int(int n) { return xorshift() % n; }
+    int random_int(int n) { return lemire_int(*this, n); }
 
     uint64_t uniform_64() { return xorshift(); }
 
+    // same as `prng::sample_pdf`
     template <template <typename...> typename Vector, typename T>
     int sample_pdf(const Vector<T> &input, int k) {
         double p = uniform();
+        int index = 0;
         for (int i = 0; i < k; ++i) {
             p -= static_cast<double>(input[i]);
-            if (p <= 0) {
-                return i;
-            }
+            index += p > 0;
         }
-        return 0;
+        return index < k ? index : 0;
     }
 
     template <typename Vector>
     int sample_pdf(const Vector &input) {
         double p = uniform();
-        for (int i = 0; i < input.size(); ++i) {
+        const int size = input.size();
+        int index = 0;
+        for (int i = 0; i < size; ++i) {
             p -= static_cast<double>(input[i]);
-            if (p <= 0) {
-                return i;
-            }
+            index += p > 0;
         }
-        return 0;
+        return index < size ? index : 0;
     }
 
     void discard(size_t n) {
@@ -119,3 +160,188 @@ class xor_shift {
         return state;
     }
 };
+
+// xoshiro256++ (https://prng.di.unimi.it/)
+class xoshiro {
+    uint64_t seed;
+    std::array<uint64_t, 4> s;
+
+   public:
+    xoshiro() : xoshiro(std::random_device{}()) {}
+    xoshiro(uint64_t seed) : seed(seed) {
+        uint64_t x = seed;
+        for (uint64_t &word : s) {
+            word = splitmix64(x);
+        }
+    }
+
+    uint64_t get_seed() const { return seed; }
+
+    uint64_t random_seed() { return next(); }
+
+    // Uniform random in [0, 1)
+    double uniform() { return uniform_from_bits(next()); }
+
+    // Random integer in [0, n)
+    int random_int(int n) { return lemire_int(*this, n); }
+
+    uint64_t uniform_64() { return next(); }
+
+    // same as `prng::sample_pdf`
+    template <typename Vector>
+    int sample_pdf(const Vector &input, int k) {
+        double p = uniform();
+        int index = 0;
+        for (int i = 0; i < k; ++i) {
+            p -= static_cast<double>(input[i]);
+            index += p > 0;
+        }
+        return index < k ? index : 0;
+    }
+
+    template <typename Vector>
+    int sample_pdf(const Vector &input) {
+        return sample_pdf(input, input.size());
+    }
+
+    void discard(size_t n) {
+        for (size_t i{}; i < n; ++i) {
+            next();
+        }
+    }
+
+    // Advances the state by 2^128 draws
+    void jump() {
+        constexpr std::array<uint64_t, 4> polynomial{0x180ec6d33cfd0aba, 0xd5a61266f0c9392c, 0xa9582618e03fc9aa,
+                                                     0x39abdc4529b1661c};
+        std::array<uint64_t, 4> t{};
+        for (const uint64_t word : polynomial) {
+            for (int b = 0; b < 64; ++b) {
+                if (word & (uint64_t{1} << b)) {
+                    for (int i = 0; i < 4; ++i) {
+                        t[i] ^= s[i];
+                    }
+                }
+                next();
+            }
+        }
+        s = t;
+    }
+
+    // Returns a generator with the current stream and jumps this one past it,
+    // so repeated calls hand out non-overlapping streams of 2^128 draws, e.g. one per thread
+    xoshiro split() {
+        xoshiro child{*this};
+        jump();
+        return child;
+    }
+
+   private:
+    inline uint64_t next() {
+        const uint64_t result = std::rotl(s[0] + s[3], 23) + s[0];
+        const uint64_t t = s[1] << 17;
+        s[2] ^= s[0];
+        s[3] ^= s[1];
+        s[1] ^= s[2];
+        s[0] ^= s[3];
+        s[2] ^= t;
+        s[3] = std::rotl(s[3], 45);
+        return result;
+    }
+};
+
+// PCG XSL RR 128/64 (https://www.pcg-random.org/), the generator numpy calls PCG64
+class pcg64 {
+    static constexpr __uint128_t multiplier = (__uint128_t{0x2360ED051FC65DA4} << 64) | 0x4385DF649FCCF645;
+
+    uint64_t seed;
+    __uint128_t state;
+    __uint128_t increment;
+
+   public:
+    pcg64() : pcg64(std::random_device{}()) {}
+    pcg64(uint64_t seed) : seed(seed) {
+        uint64_t x = seed;
+        std::array<uint64_t, 4> words;
+        for (uint64_t &word : words) {
+            word = splitmix64(x);
+        }
+        set_stream(join(words[0], words[1]), join(words[2], words[3]));
+    }
+
+    uint64_t get_seed() const { return seed; }
+
+    uint64_t random_seed() { return next(); }
+
+    // Uniform random in [0, 1)
+    double uniform() { return uniform_from_bits(next()); }
+
+    // Random integer in [0, n)
+    int random_int(int n) { return lemire_int(*this, n); }
+
+    uint64_t uniform_64() { return next(); }
+
+    // same as `prng::sample_pdf`
+    template <typename Vector>
+    int sample_pdf(const Vector &input, int k) {
+        double p = uniform();
+        int index = 0;
+        for (int i = 0; i < k; ++i) {
+            p -= static_cast<double>(input[i]);
+            index += p > 0;
+        }
+        return index < k ? index : 0;
+    }
+
+    template <typename Vector>
+    int sample_pdf(const Vector &input) {
+        return sample_pdf(input, input.size());
+    }
+
+    // The LCG can be advanced in O(log n)
+    void discard(size_t n) {
+        __uint128_t acc_mult = 1, acc_plus = 0;
+        __uint128_t cur_mult = multiplier, cur_plus = increment;
+        for (uint64_t delta = n; delta > 0; delta >>= 1) {
+            if (delta & 1) {
+                acc_mult *= cur_mult;
+                acc_plus = acc_plus * cur_mult + cur_plus;
+            }
+            cur_plus = (cur_mult + 1) * cur_plus;
+            cur_mult *= cur_mult;
+        }
+        state = acc_mult * state + acc_plus;
+    }
+
+    // Returns a generator on a new stream (increment) drawn from this one
+    pcg64 split() {
+        pcg64 child{*this};
+        std::array<uint64_t, 4> words;
+        for (uint64_t &word : words) {
+            word = next();
+        }
+        child.set_stream(join(words[0], words[1]), join(words[2], words[3]));
+        return child;
+    }
+
+   private:
+    static __uint128_t join(const uint64_t high, const uint64_t low) {
+        return (static_cast<__uint128_t>(high) << 64) | low;
+    }
+
+    void set_stream(const __uint128_t initial_state, const __uint128_t stream) {
+        state = 0;
+        increment = (stream << 1) | 1;
+        step();
+        state += initial_state;
+        step();
+    }
+
+    inline void step() { state = state * multiplier + increment; }
+
+    inline uint64_t next() {
+        step();
+        const uint64_t x = static_cast<uint64_t>(state >> 64) ^ static_cast<uint64_t>(state);
+        return std::rotr(x, static_cast<int>(state >> 122));
+    }
+};
@@ -0,0 +1,304 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <initializer_list>
+#include <memory>
+#include <new>
+#include <utility>
+
+/*
+
+A vector with inline capacity for `InlineSize` elements and a heap fallback.
+
+`Small<InlineSize>::Vector<T>` behaves like `std::vector<T>`, but as long as its size stays within `InlineSize` the
+elements are stored in the object itself and nothing is allocated. This suits the per-node and per-select vectors of
+the bandits, whose sizes are the number of actions. Growing past the inline capacity moves the elements to the heap,
+where they stay until the vector is destroyed or moved from.
+
+`Small<InlineSize>::Vector` is a template with one parameter, so it can be passed as the `_Vector` of `DefaultTypes`.
+
+*/
+
+template <size_t InlineSize>
+struct Small
+{
+    static_assert(InlineSize > 0);
+
+    template <typename T>
+    class Vector
+    {
+        T *_data = inline_data();
+        size_t _size = 0;
+        size_t _capacity = InlineSize;
+        alignas(T) std::byte _buffer[InlineSize * sizeof(T)];
+
+    public:
+        using value_type = T;
+        using iterator = T *;
+        using const_iterator = const T *;
+
+        Vector() {}
+
+        explicit Vector(const size_t n)
+        {
+            resize(n);
+        }
+
+        Vector(const size_t n, const T &value)
+        {
+            resize(n, value);
+        }
+
+        Vector(std::initializer_list<T> list)
+        {
+            reserve(list.size());
+            std::uninitialized_copy(list.begin(), list.end(), _data);
+            _size = list.size();
+        }
+
+        Vector(const Vector &other)
+        {
+            reserve(other._size);
+            std::uninitialized_copy(other.begin(), other.end(), _data);
+            _size = other._size;
+        }
+
+        Vector(Vector &&other) noexcept
+        {
+            steal(other);
+        }
+
+        Vector &operator=(const Vector &other)
+        {
+            if (this != &other)
+            {
+                clear();
+                reserve(other._size);
+                std::uninitialized_copy(other.begin(), other.end(), _data);
+                _size = other._size;
+            }
+            return *this;
+        }
+
+        Vector &operator=(Vector &&other) noexcept
+        {
+            if (this != &other)
+            {
+                clear();
+                release();
+                steal(other);
+            }
+            return *this;
+        }
+
+        ~Vector()
+        {
+            clear();
+            release();
+        }
+
+        bool is_inline() const
+        {
+            return _data == inline_data();
+        }
+
+        void reserve(const size_t n)
+        {
+            if (n <= _capacity)
+            {
+                return;
+            }
+            T *data = static_cast<T *>(::operator new(n * sizeof(T), std::align_val_t{alignof(T)}));
+            std::uninitialized_move(_data, _data + _size, data);
+            std::destroy(_data, _data + _size);
+            release();
+            _data = data;
+            _capacity = n;
+        }
+
+        void resize(const size_t n)
+        {
+            if (n > _size)
+            {
+                reserve(n);
+                std::uninitialized_value_construct(_data + _size, _data + n);
+            }
+            else
+            {
+                std::destroy(_data + n, _data + _size);
+            }
+            _size = n;
+        }
+
+        void resize(const size_t n, const T &value)
+        {
+            if (n > _size)
+            {
+                reserve(n);
+                std::uninitialized_fill(_data + _size, _data + n, value);
+            }
+            else
+            {
+                std::destroy(_data + n, _data + _size);
+            }
+            _size = n;
+        }
+
+        void push_back(const T &value)
+        {
+            emplace_back(value);
+        }
+
+        void push_back(T &&value)
+        {
+            emplace_back(std::move(value));
+        }
+
+        template <typename... Args>
+        T &emplace_back(Args &&...args)
+        {
+            if (_size == _capacity)
+            {
+                // `args` may refer to an element, so it is constructed before the elements are moved
+                T value{std::forward<Args>(args)...};
+                reserve(2 * _capacity);
+                return *new (_data + _size++) T{std::move(value)};
+            }
+            return *new (_data + _size++) T{std::forward<Args>(args)...};
+        }
+
+        void pop_back()
+        {
+            std::destroy_at(_data + --_size);
+        }
+
+        void clear()
+        {
+            std::destroy(_data, _data + _size);
+            _size = 0;
+        }
+
+        size_t size() const
+        {
+            return _size;
+        }
+
+        size_t capacity() const
+        {
+            return _capacity;
+        }
+
+        bool empty() const
+        {
+            return _size == 0;
+        }
+
+        T *data()
+        {
+            return _data;
+        }
+
+        const T *data() const
+        {
+            return _data;
+        }
+
+        T &operator[](const size_t i)
+        {
+            return _data[i];
+        }
+
+        const T &operator[](const size_t i) const
+        {
+            return _data[i];
+        }
+
+        T &front()
+        {
+            return _data[0];
+        }
+
+        const T &front() const
+        {
+            return _data[0];
+        }
+
+        T &back()
+        {
+            return _data[_size - 1];
+        }
+
+        const T &back() const
+        {
+            return _data[_size - 1];
+        }
+
+        T *begin()
+        {
+            return _data;
+        }
+
+        T *end()
+        {
+            return _data + _size;
+        }
+
+        const T *begin() const
+        {
+            return _data;
+        }
+
+        const T *end() const
+        {
+            return _data + _size;
+        }
+
+        bool operator==(const Vector &other) const
+        {
+            return std::equal(begin(), end(), other.begin(), other.end());
+        }
+
+    private:
+        T *inline_data()
+        {
+            return reinterpret_cast<T *>(_buffer);
+        }
+
+        const T *inline_data() const
+        {
+            return reinterpret_cast<const T *>(_buffer);
+        }
+
+        // frees the heap array, if any. The elements must already be destroyed
+        void release()
+        {
+            if (!is_inline())
+            {
+                ::operator delete(_data, std::align_val_t{alignof(T)});
+            }
+            _data = inline_data();
+            _capacity = InlineSize;
+        }
+
+        // `this` must be empty and inline
+        void steal(Vector &other)
+        {
+            if (other.is_inline())
+            {
+                std::uninitialized_move(other.begin(), other.end(), _data);
+                _size = other._size;
+                other.clear();
+            }
+            else
+            {
+                _data = other._data;
+                _size = other._size;
+                _capacity = other._capacity;
+                other._data = other.inline_data();
+                other._size = 0;
+                other._capacity = InlineSize;
+            }
+        }
+    };
+};
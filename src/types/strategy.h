@@ -2,71 +2,222 @@
 
 /*
 
-Store m, n actions as 8 bit each.
+Quantized strategies and alias tables.
 
-Simplest is just encode as 1/256 fractions, and omit the last action, since its prob is determined
+`Strategy<Int>` stores m actions as `Int` fractions of `Strategy::total`, the max value of `Int`. The fractions always
+sum to exactly `total`, so a sample is a single uniform integer compared against the prefix sums.
+This is the cheap representation for a distribution that is sampled once or a few times.
+
+`AliasTable<Int>` is Vose's alias method (https://en.wikipedia.org/wiki/Alias_method). Construction is O(m) and
+every sample after that is O(1): one 64 bit random number picks a column with its high bits and decides between the
+column and its alias with its low `Int` bits. It costs a pass and twice the storage, so it only pays off for
+distributions that are sampled many times.
+
+Both only need `device.uniform_64()` from the PRNG.
 
 */
 
-#include <vector>
-#include <stdint.h>
+#include <gmpxx.h>
+
+#include <algorithm>
+#include <cstdint>
 #include <limits>
+#include <numeric>
+#include <type_traits>
+#include <vector>
+
+namespace math::detail
+{
+    template <typename T>
+    double exact_double(const T &x)
+    {
+        if constexpr (std::is_same_v<T, mpq_class>)
+        {
+            return x.get_d();
+        }
+        else
+        {
+            return static_cast<double>(x);
+        }
+    }
+
+    // rounds `pdf` to integer weights that sum to exactly `total`, largest remainder first.
+    // negative entries are treated as 0, and `pdf` does not have to be normalized
+    template <typename Vector>
+    std::vector<uint64_t> quantize(const Vector &pdf, const size_t size, const uint64_t total)
+    {
+        std::vector<uint64_t> weights(size);
+        double sum = 0;
+        for (size_t i = 0; i < size; ++i)
+        {
+            sum += std::max(exact_double(pdf[i]), 0.0);
+        }
+        if (size == 0)
+        {
+            return weights;
+        }
+        if (!(sum > 0))
+        {
+            weights[0] = total;
+            return weights;
+        }
+        std::vector<double> remainders(size);
+        uint64_t assigned = 0;
+        for (size_t i = 0; i < size; ++i)
+        {
+            const double x = std::max(exact_double(pdf[i]), 0.0) / sum * static_cast<double>(total);
+            weights[i] = std::min(static_cast<uint64_t>(x), total);
+            remainders[i] = x - static_cast<double>(weights[i]);
+            assigned += weights[i];
+        }
+        std::vector<size_t> order(size);
+        std::iota(order.begin(), order.end(), 0);
+        std::stable_sort(order.begin(), order.end(), [&remainders](size_t a, size_t b)
+                         { return remainders[a] > remainders[b]; });
+        for (size_t i = 0; assigned < total; i = (i + 1) % size)
+        {
+            ++weights[order[i]];
+            ++assigned;
+        }
+        while (assigned > total)
+        {
+            // only reachable through rounding in `sum`
+            --*std::max_element(weights.begin(), weights.end());
+            --assigned;
+        }
+        return weights;
+    }
+}; // namespace math::detail
 
 template <typename Int = uint8_t>
+    requires std::is_unsigned_v<Int>
 struct Strategy : public std::vector<Int>
 {
+    static constexpr uint64_t total = std::numeric_limits<Int>::max();
 
-    static constexpr size_ = std::numeric_limits<Int>::max();
-    // some kind of unsigned int. static assert?
-    // this basically determines how precise this representation is
+    Strategy() {}
 
-    template <typename T>
-    T operator[](size_t index) const
+    template <typename Vector>
+    explicit Strategy(const Vector &pdf)
     {
-        return static_cast<T>((*this)[index]) / static_cast<T>(size_);
+        quantize(pdf, pdf.size());
     }
 
-    void sort()
+    template <typename Vector>
+    void quantize(const Vector &pdf, const size_t size)
     {
-        // calculate redidual prob, if larger than least replace value
-        // [a, c] -> b > c -> [a, b]
+        const std::vector<uint64_t> weights = math::detail::quantize(pdf, size, total);
+        this->resize(size);
+        for (size_t i = 0; i < size; ++i)
+        {
+            (*this)[i] = static_cast<Int>(weights[i]);
+        }
     }
 
-    template <typename T>
-    void sort_with(std::vector<T> &companion)
+    template <typename T = double>
+    T prob(const size_t index) const
     {
-        // also sorted
+        return static_cast<T>((*this)[index]) / static_cast<T>(total);
     }
 
-    // faster when sorted
-    template <class PRNG>
-    int sample(PRNG &device)
+    // x is uniform in [0, total). The answer is the number of prefix sums <= x, counted without branching
+    template <typename PRNG>
+    int sample(PRNG &device) const
     {
-        Int choice = device. template get<Int>();
-
-        while (choice > 0)
+        const uint64_t x = ((device.uniform_64() >> 32) * total) >> 32;
+        const size_t size = this->size();
+        uint64_t prefix = 0;
+        int index = 0;
+        for (size_t i = 0; i + 1 < size; ++i)
         {
-            break;
-            // subtract stored Int sequentially
+            prefix += (*this)[i];
+            index += prefix <= x;
         }
-        return 0;
+        return index;
     }
 };
 
-template <typename Int>
+template <typename Int = uint16_t>
+    requires std::is_unsigned_v<Int>
 struct AliasTable
 {
+    // the keep probability of a column is `threshold / total`
+    static constexpr uint64_t total = uint64_t{1} << std::numeric_limits<Int>::digits;
+
+    struct Column
+    {
+        uint32_t alias;
+        Int threshold;
+    };
 
-    // https://en.wikipedia.org/wiki/Alias_method
+    std::vector<Column> columns;
 
-    /*
-    Has to be computed from distro, and vice versa.
-    Otherwise samples in one shot using only (0, 1) or Int / MAXINT
+    AliasTable() {}
+
+    template <typename T>
+    explicit AliasTable(const Strategy<T> &strategy)
+    {
+        std::vector<uint64_t> weights(strategy.begin(), strategy.end());
+        build(weights, Strategy<T>::total);
+    }
+
+    template <typename Vector>
+    explicit AliasTable(const Vector &pdf)
+    {
+        // 2^32 keeps the quantization error far below the resolution of the threshold
+        const uint64_t weight_total = uint64_t{1} << 32;
+        std::vector<uint64_t> weights = math::detail::quantize(pdf, pdf.size(), weight_total);
+        build(weights, weight_total);
+    }
 
-    but it does require two times the storage, so idk
+    size_t size() const
+    {
+        return columns.size();
+    }
 
-    We dont really frequently sample from static distros though.
-    */
+    template <typename PRNG>
+    int sample(PRNG &device) const
+    {
+        const uint64_t x = device.uniform_64();
+        const size_t column = ((x >> 32) * columns.size()) >> 32;
+        const Column &c = columns[column];
+        return static_cast<Int>(x) < c.threshold ? static_cast<int>(column) : static_cast<int>(c.alias);
+    }
 
-    explicit AliasTable(const Strategy<Int> &s);
+private:
+    // Vose's method on integers. Each column holds `weight_total` after scaling the weights by the size,
+    // so the only rounding is the final conversion of the kept weight to a threshold
+    void build(std::vector<uint64_t> &weights, const uint64_t weight_total)
+    {
+        const size_t size = weights.size();
+        columns.resize(size);
+        std::vector<uint32_t> small, large;
+        for (size_t i = 0; i < size; ++i)
+        {
+            weights[i] *= size;
+            (weights[i] < weight_total ? small : large).push_back(i);
+        }
+        while (!small.empty() && !large.empty())
+        {
+            const uint32_t s = small.back();
+            const uint32_t l = large.back();
+            small.pop_back();
+            columns[s] = {l, static_cast<Int>(weights[s] * total / weight_total)};
+            weights[l] -= weight_total - weights[s];
+            if (weights[l] < weight_total)
+            {
+                large.pop_back();
+                small.push_back(l);
+            }
+        }
+        // the scaled weights sum to exactly size * weight_total, so what is left is full
+        for (const uint32_t i : large)
+        {
+            columns[i] = {i, std::numeric_limits<Int>::max()};
+        }
+        for (const uint32_t i : small)
+        {
+            columns[i] = {i, std::numeric_limits<Int>::max()};
+        }
+    }
 };
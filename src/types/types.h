@@ -3,10 +3,13 @@
 #include <libpinyon/math.h>
 #include <types/random.h>
 #include <types/array.h>
+#include <types/block-vector.h>
+#include <types/small-vector.h>
 #include <types/matrix.h>
 #include <types/random.h>
 #include <types/value.h>
 #include <types/mutex.h>
+#include <types/strategy.h>
 #include <any>
 
 /*
@@ -232,6 +235,15 @@ using SimpleTypes = DefaultTypes<
     int,
     double>;
 
+// SimpleTypes whose vectors do not allocate for up to 9 actions, see small-vector.h
+using SimpleSmallTypes = DefaultTypes<
+    double,
+    int,
+    int,
+    double,
+    PairReal,
+    Small<9>::Vector>;
+
 using RandomTreeFloatTypes = DefaultTypes<
     double,
     int,
@@ -239,6 +251,45 @@ using RandomTreeFloatTypes = DefaultTypes<
     double,
     ConstantSum<1, 1>::Value>;
 
+// RandomTreeFloatTypes with a 32 byte PRNG, see random.h
+using RandomTreeFastTypes = DefaultTypes<
+    double,
+    int,
+    int,
+    double,
+    ConstantSum<1, 1>::Value,
+    std::vector,
+    Matrix,
+    std::mutex,
+    uint64_t,
+    xoshiro>;
+
+// RandomTreeFastTypes whose vectors can live in the blocks of PackedNodes, see tree/tree-packed.h
+using RandomTreePackedTypes = DefaultTypes<
+    double,
+    int,
+    int,
+    double,
+    ConstantSum<1, 1>::Value,
+    BlockVector,
+    Matrix,
+    std::mutex,
+    uint64_t,
+    xoshiro>;
+
+// RandomTreeFastTypes with the vectors of SimpleSmallTypes
+using RandomTreeSmallTypes = DefaultTypes<
+    double,
+    int,
+    int,
+    double,
+    ConstantSum<1, 1>::Value,
+    Small<9>::Vector,
+    Matrix,
+    std::mutex,
+    uint64_t,
+    xoshiro>;
+
 using RandomTreeRationalTypes = DefaultTypes<
     mpq_class,
     int,
@@ -0,0 +1,50 @@
+#include <pinyon.h>
+
+/*
+
+Exp3Atomic performs the same arithmetic as Exp3, so a single threaded search must give identical strategies.
+A multithreaded search must not lose any updates at the root.
+
+*/
+
+template <typename Types>
+void search_strategies(
+    const size_t iterations,
+    const typename Types::State &state,
+    typename Types::VectorReal &row_strategy,
+    typename Types::VectorReal &col_strategy)
+{
+    typename Types::PRNG device{0};
+    typename Types::Model model{0};
+    typename Types::MatrixNode root{};
+    typename Types::Search search{};
+    search.run_for_iterations(iterations, device, state, model, root);
+    search.get_empirical_strategies(root.stats, row_strategy, col_strategy);
+}
+
+int main()
+{
+    using BaseTypes = MonteCarloModel<MoldState<>>;
+
+    const size_t iterations = 1 << 16;
+    BaseTypes::State state{3, 10};
+
+    BaseTypes::VectorReal row_strategy, col_strategy, atomic_row_strategy, atomic_col_strategy;
+    search_strategies<TreeBandit<Exp3<BaseTypes>>>(iterations, state, row_strategy, col_strategy);
+    search_strategies<TreeBandit<Exp3Atomic<BaseTypes>>>(iterations, state, atomic_row_strategy, atomic_col_strategy);
+    assert(row_strategy == atomic_row_strategy);
+    assert(col_strategy == atomic_col_strategy);
+
+    using ThreadedTypes = TreeBanditThreaded<Exp3Atomic<BaseTypes>>;
+    const size_t threads = 4;
+    ThreadedTypes::PRNG device{0};
+    ThreadedTypes::Model model{0};
+    ThreadedTypes::MatrixNode root{};
+    ThreadedTypes::Search search{ThreadedTypes::BanditAlgorithm{}, threads};
+    search.run_for_iterations(iterations, device, state, model, root);
+    // the first iteration of every thread may only expand the root
+    const int visits = root.stats.visits.load();
+    assert(visits <= iterations && visits >= iterations - threads);
+
+    return 0;
+}
@@ -0,0 +1,88 @@
+#include <pinyon.h>
+
+/*
+
+The vectorized Exp3 kernels must agree with the scalar softmax and mixing they replace.
+The forecast uses a polynomial for exp instead of std::exp, so agreement is up to float precision.
+Sizes cover the scalar path below 8 actions, whole 8 lane blocks and their remainders, and the gains range far enough to underflow exp.
+
+*/
+
+template <typename Real>
+void scalar_forecast(const std::vector<Real> &gains, std::vector<Real> &forecast, const Real eta,
+                     const Real one_minus_gamma)
+{
+    const size_t k = gains.size();
+    Real sum = 0;
+    for (size_t i = 0; i < k; ++i)
+    {
+        forecast[i] = std::exp(static_cast<float>(gains[i] * eta));
+        sum += forecast[i];
+    }
+    for (size_t i = 0; i < k; ++i)
+    {
+        forecast[i] = one_minus_gamma * (forecast[i] / sum) + eta;
+    }
+}
+
+template <typename Real>
+void test_forecast(prng &device, const size_t k, const Real gamma, const Real scale)
+{
+    std::vector<Real> gains(k), forecast(k), kernel_forecast(k);
+    for (Real &gain : gains)
+    {
+        gain = -device.uniform() * scale;
+    }
+    // Exp3 keeps the largest gain at 0
+    gains[device.random_int(k)] = 0;
+    const Real eta = gamma / k;
+    scalar_forecast(gains, forecast, eta, Real{1} - gamma);
+    math::exp3_forecast(gains.data(), kernel_forecast.data(), k, eta, Real{1} - gamma);
+    // Exp3Atomic and the multithreaded select compute the forecast in place
+    std::vector<Real> in_place{gains};
+    math::exp3_forecast(in_place.data(), in_place.data(), k, eta, Real{1} - gamma);
+    assert(in_place == kernel_forecast);
+    Real total = 0;
+    for (size_t i = 0; i < k; ++i)
+    {
+        assert(std::abs(forecast[i] - kernel_forecast[i]) <= 1e-6 * forecast[i]);
+        total += kernel_forecast[i];
+    }
+    assert(std::abs(total - 1) < 1e-6);
+}
+
+template <typename Real>
+void test_shift(prng &device, const size_t k)
+{
+    std::vector<Real> x(k), y(k);
+    for (size_t i = 0; i < k; ++i)
+    {
+        x[i] = y[i] = device.uniform();
+    }
+    const Real c = device.uniform();
+    math::shift(x.data(), k, c);
+    for (size_t i = 0; i < k; ++i)
+    {
+        assert(x[i] == y[i] - c);
+    }
+}
+
+int main()
+{
+    prng device{0};
+    for (size_t k = 1; k <= 33; ++k)
+    {
+        for (const double scale : {1.0, 100.0, 10000.0, 1e7})
+        {
+            for (size_t trial = 0; trial < 16; ++trial)
+            {
+                test_forecast<double>(device, k, .01, scale);
+                test_forecast<double>(device, k, .2, scale);
+                test_forecast<float>(device, k, .1f, static_cast<float>(scale));
+            }
+        }
+        test_shift<double>(device, k);
+        test_shift<float>(device, k);
+    }
+    return 0;
+}
@@ -0,0 +1,189 @@
+#include <pinyon.h>
+
+#include <cmath>
+
+/*
+
+Virtual loss is applied right after select and reverted right before the real update, so applying and then reverting
+it must leave the stats of every bandit as they were. Exp3 lowers and raises its gains by the same floating point
+amount, so they are only compared up to rounding; the counts of UCB and MatrixUCB must match exactly.
+
+A threaded search with virtual_loss = 0 must not call the hooks at all, so with one thread it reproduces a single
+threaded TreeBandit search that was given the same seed and model.
+
+*/
+
+using BaseTypes = MonteCarloModel<MoldState<>>;
+
+template <typename Types>
+using Snapshot = std::vector<double> (*)(const typename Types::MatrixStats &);
+
+template <typename Types>
+void test_apply_revert(Snapshot<Types> snapshot, const bool exact)
+{
+    typename Types::PRNG device{0};
+    typename Types::Model model{0};
+    typename Types::State state{3, 10};
+    typename Types::MatrixNode root{};
+    typename Types::Search search{};
+    search.run_for_iterations(1 << 10, device, state, model, root);
+
+    const std::vector<double> before = snapshot(root.stats);
+    typename Types::Mutex mutex{};
+    for (int virtual_loss = 1; virtual_loss <= 4; ++virtual_loss)
+    {
+        typename Types::Outcome outcome;
+        search.select(device, root.stats, outcome);
+        search.apply_virtual_loss(root.stats, outcome, virtual_loss, mutex);
+        assert(snapshot(root.stats) != before);
+        search.revert_virtual_loss(root.stats, outcome, virtual_loss, mutex);
+        const std::vector<double> after = snapshot(root.stats);
+        assert(after.size() == before.size());
+        for (size_t i = 0; i < before.size(); ++i)
+        {
+            if (exact)
+            {
+                assert(after[i] == before[i]);
+            }
+            else
+            {
+                assert(std::abs(after[i] - before[i]) <= 1e-9 * std::max(1.0, std::abs(before[i])));
+            }
+        }
+    }
+}
+
+template <typename Types>
+typename Types::MatrixStats threaded_stats(const int virtual_loss, const uint64_t seed)
+{
+    using Threaded = TreeBanditThreaded<Types>;
+    typename Threaded::PRNG device{seed};
+    typename Threaded::Model model{0};
+    typename Threaded::State state{3, 10};
+    typename Threaded::MatrixNode root{};
+    typename Threaded::Search search{typename Threaded::BanditAlgorithm{}, 1, virtual_loss};
+    search.run_for_iterations(1 << 10, device, state, model, root);
+    return std::move(static_cast<typename Types::MatrixStats &>(root.stats));
+}
+
+template <typename Types>
+typename Types::MatrixStats single_threaded_stats(const uint64_t seed)
+{
+    using Single = TreeBandit<Types>;
+    // the threaded search seeds each thread with one draw from the caller's device
+    typename Single::PRNG device{typename Single::PRNG{seed}.uniform_64()};
+    typename Single::Model model{0};
+    typename Single::State state{3, 10};
+    typename Single::MatrixNode root{};
+    typename Single::Search search{};
+    search.run_for_iterations(1 << 10, device, state, model, root);
+    return std::move(root.stats);
+}
+
+int main()
+{
+    test_apply_revert<TreeBandit<Exp3<BaseTypes>>>(
+        [](const Exp3<BaseTypes>::MatrixStats &stats)
+        {
+            std::vector<double> data{static_cast<double>(stats.visits)};
+            data.insert(data.end(), stats.row_gains.begin(), stats.row_gains.end());
+            data.insert(data.end(), stats.col_gains.begin(), stats.col_gains.end());
+            return data;
+        },
+        false);
+
+    test_apply_revert<TreeBandit<Exp3Fat<BaseTypes>>>(
+        [](const Exp3Fat<BaseTypes>::MatrixStats &stats)
+        {
+            std::vector<double> data{static_cast<double>(stats.visits)};
+            data.insert(data.end(), stats.row_gains.begin(), stats.row_gains.end());
+            data.insert(data.end(), stats.col_gains.begin(), stats.col_gains.end());
+            data.insert(data.end(), stats.row_visits.begin(), stats.row_visits.end());
+            data.insert(data.end(), stats.col_visits.begin(), stats.col_visits.end());
+            return data;
+        },
+        false);
+
+    test_apply_revert<TreeBandit<Exp3Atomic<BaseTypes>>>(
+        [](const Exp3Atomic<BaseTypes>::MatrixStats &stats)
+        {
+            std::vector<double> data{static_cast<double>(stats.visits.load())};
+            for (size_t i = 0; i < stats.rows; ++i)
+            {
+                data.push_back(stats.row_gains[i].load());
+                data.push_back(stats.row_visits[i].load());
+            }
+            for (size_t j = 0; j < stats.cols; ++j)
+            {
+                data.push_back(stats.col_gains[j].load());
+                data.push_back(stats.col_visits[j].load());
+            }
+            return data;
+        },
+        false);
+
+    test_apply_revert<TreeBandit<UCB<BaseTypes>>>(
+        [](const UCB<BaseTypes>::MatrixStats &stats)
+        {
+            std::vector<double> data{static_cast<double>(stats.visits)};
+            for (const auto *ucb_vector : {&stats.row_ucb_vector, &stats.col_ucb_vector})
+            {
+                for (const auto &ucb_data : *ucb_vector)
+                {
+                    data.insert(data.end(), {static_cast<double>(ucb_data.n), static_cast<double>(ucb_data.v),
+                                             static_cast<double>(ucb_data.log_n), static_cast<double>(ucb_data.q),
+                                             static_cast<double>(ucb_data.pending)});
+                }
+            }
+            return data;
+        },
+        true);
+
+    test_apply_revert<TreeBandit<MatrixUCB<BaseTypes>>>(
+        [](const MatrixUCB<BaseTypes>::MatrixStats &stats)
+        {
+            std::vector<double> data{static_cast<double>(stats.total_visits)};
+            for (size_t row_idx = 0; row_idx < stats.data_matrix.rows; ++row_idx)
+            {
+                for (size_t col_idx = 0; col_idx < stats.data_matrix.cols; ++col_idx)
+                {
+                    const auto &entry = stats.data_matrix.get(row_idx, col_idx);
+                    data.insert(data.end(), {static_cast<double>(entry.visits), static_cast<double>(entry.row_mean),
+                                             static_cast<double>(entry.col_mean),
+                                             static_cast<double>(entry.inv_sqrt_visits)});
+                }
+            }
+            return data;
+        },
+        true);
+
+    // Rand is not a complete bandit for TreeBandit, so its hooks are called directly
+    {
+        Rand<BaseTypes>::BanditAlgorithm bandit{};
+        Rand<BaseTypes>::MatrixStats stats{3, 3};
+        Rand<BaseTypes>::Outcome outcome{};
+        BaseTypes::Mutex mutex{};
+        bandit.apply_virtual_loss(stats, outcome, 1, mutex);
+        bandit.revert_virtual_loss(stats, outcome, 1, mutex);
+        assert(stats.rows == 3 && stats.cols == 3);
+    }
+
+    for (uint64_t seed = 0; seed < 4; ++seed)
+    {
+        const auto expected = single_threaded_stats<Exp3<BaseTypes>>(seed);
+        assert(threaded_stats<Exp3<BaseTypes>>(0, seed) == expected);
+
+        // with one thread nothing else selects while the loss is pending, and UCB reverts it exactly
+        const auto ucb_expected = threaded_stats<UCB<BaseTypes>>(0, seed);
+        const auto ucb_virtual_loss = threaded_stats<UCB<BaseTypes>>(2, seed);
+        assert(ucb_virtual_loss.visits == ucb_expected.visits);
+        assert(ucb_virtual_loss.value_total.get_row_value() == ucb_expected.value_total.get_row_value());
+        for (size_t i = 0; i < ucb_expected.row_ucb_vector.size(); ++i)
+        {
+            assert(ucb_virtual_loss.row_ucb_vector[i].n == ucb_expected.row_ucb_vector[i].n);
+            assert(ucb_virtual_loss.row_ucb_vector[i].pending == 0);
+        }
+    }
+
+    return 0;
+}
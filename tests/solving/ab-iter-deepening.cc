@@ -0,0 +1,110 @@
+#include <pinyon.h>
+
+/*
+
+AlphaBetaIter solves one depth after another on the same tree. After each depth its bounds must be the same as
+AlphaBeta's when solving that depth from scratch, with a model that does not depend on the depth it is called at.
+
+Once the tree is solved to its terminal states the root is exact and `run` stops early, and a search that is stopped
+before it starts leaves the tree as it was. A depth that runs out of time does not change the results of the next one.
+
+*/
+
+using T = RandomTree<RandomTreeFloatTypes>;
+
+// the sign of the payoff bias, like the terminal payoffs
+struct BiasModel : T
+{
+    struct ModelOutput
+    {
+        T::Value value;
+    };
+
+    class Model
+    {
+    public:
+        Model() {}
+
+        Model(uint64_t) {}
+
+        void inference(T::State &&state, ModelOutput &output) const
+        {
+            output.value = T::Value{T::Real{((state.payoff_bias > 0) - (state.payoff_bias < 0) + 1) / 2.0}};
+        }
+    };
+};
+
+const double eps = 1.0 / (1 << 10);
+
+std::pair<double, double> solve(const BiasModel::State &state, const size_t depth)
+{
+    prng device{0};
+    BiasModel::Model model{};
+    AlphaBeta<BiasModel>::MatrixNode root{};
+    AlphaBeta<BiasModel>::Search search{0, 1};
+    return search.run(depth, device, state, model, root);
+}
+
+int main()
+{
+    size_t trees = 0;
+    for (const size_t depth_bound : {2, 3, 4})
+    {
+        for (const size_t actions : {2, 3})
+        {
+            for (const size_t transitions : {1, 2})
+            {
+                for (uint64_t seed = 0; seed < 4; ++seed)
+                {
+                    const BiasModel::State state{prng{seed}, depth_bound, actions, actions, transitions};
+                    prng device{0};
+                    BiasModel::Model model{};
+
+                    AlphaBetaIter<BiasModel>::Search search{0, 1};
+                    AlphaBetaIter<BiasModel>::MatrixNode root{};
+                    for (size_t depth = 1; depth <= depth_bound; ++depth)
+                    {
+                        const auto iter = search.run_for_depth(depth, device, state, model, root);
+                        const auto fresh = solve(state, depth);
+                        assert(root.stats.depth_solved_to == depth);
+                        assert(std::abs(iter.first - fresh.first) < eps);
+                        assert(std::abs(iter.second - fresh.second) < eps);
+                    }
+                    assert(root.stats.is_exact);
+                    assert(search.run(1000, device, state, model, root) == depth_bound);
+
+                    AlphaBetaIter<BiasModel>::MatrixNode timed_root{};
+                    assert(search.run(1000, device, state, model, timed_root) == depth_bound);
+                    assert(timed_root.stats.alpha == root.stats.alpha);
+
+                    std::atomic<bool> stop{true};
+                    AlphaBetaIter<BiasModel>::Search stopped_search{0, 1};
+                    stopped_search.stop_flag = &stop;
+                    AlphaBetaIter<BiasModel>::MatrixNode stopped_root{};
+                    assert(stopped_search.run(1000, device, state, model, stopped_root) == 0);
+                    assert(stopped_root.stats.I.empty());
+                    ++trees;
+                }
+            }
+        }
+    }
+
+    // deep enough that a few milliseconds interrupt some depth
+    for (uint64_t seed = 0; seed < 4; ++seed)
+    {
+        const BiasModel::State state{prng{seed}, 10, 3, 3, 2};
+        prng device{0};
+        BiasModel::Model model{};
+        AlphaBetaIter<BiasModel>::Search search{0, 1};
+        AlphaBetaIter<BiasModel>::MatrixNode root{};
+        const size_t depth = search.run(5, device, state, model, root);
+        assert(depth < 10);
+        assert(root.stats.depth_solved_to == depth);
+        const auto iter = search.run_for_depth(depth + 1, device, state, model, root);
+        const auto fresh = solve(state, depth + 1);
+        assert(std::abs(iter.first - fresh.first) < eps);
+        assert(std::abs(iter.second - fresh.second) < eps);
+    }
+    std::cout << trees << " trees solved" << std::endl;
+    return 0;
+}
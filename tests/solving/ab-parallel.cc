@@ -0,0 +1,63 @@
+#include <pinyon.h>
+
+/*
+
+AlphaBetaParallel must give the same alpha/beta as AlphaBeta when solving random trees to their terminal states.
+With one thread the two searches are the same, so the values are equal. With more threads the explored branches
+can differ, but the values only differ by the precision of the solver.
+
+*/
+
+using Types = MonteCarloModel<RandomTree<RandomTreeFloatTypes>>;
+
+const double eps = 1.0 / (1 << 10);
+
+std::pair<double, double> solve_serial(const Types::State &state)
+{
+    prng device{0};
+    Types::Model model{0};
+    AlphaBeta<Types>::MatrixNode root{};
+    AlphaBeta<Types>::Search search{0, 1};
+    return search.run(state.depth_bound, device, state, model, root);
+}
+
+std::pair<double, double> solve_parallel(const Types::State &state, const size_t threads, const size_t max_task_depth)
+{
+    prng device{0};
+    Types::Model model{0};
+    AlphaBetaParallel<Types>::MatrixNode root{};
+    AlphaBetaParallel<Types>::Search search{0, 1, threads, max_task_depth};
+    return search.run(state.depth_bound, device, state, model, root);
+}
+
+int main()
+{
+    size_t trees = 0;
+    for (const size_t depth : {1, 2, 3})
+    {
+        for (const size_t actions : {2, 3, 5})
+        {
+            for (const size_t transitions : {1, 2})
+            {
+                for (uint64_t seed = 0; seed < 4; ++seed)
+                {
+                    const Types::State state{prng{seed}, depth, actions, actions, transitions};
+                    const auto serial = solve_serial(state);
+
+                    const auto single_thread = solve_parallel(state, 1, 2);
+                    assert(single_thread == serial);
+
+                    for (const size_t max_task_depth : {1, 3})
+                    {
+                        const auto parallel = solve_parallel(state, 4, max_task_depth);
+                        assert(std::abs(parallel.first - serial.first) < eps);
+                        assert(std::abs(parallel.second - serial.second) < eps);
+                    }
+                    ++trees;
+                }
+            }
+        }
+    }
+    std::cout << trees << " trees solved" << std::endl;
+    return 0;
+}
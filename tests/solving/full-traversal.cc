@@ -0,0 +1,55 @@
+#include <pinyon.h>
+
+/*
+
+FullTraversal with a task pool must produce the same tree as the serial traversal: every matrix node is expanded
+once, and the solved payoffs are the same since the children are added in the same order.
+
+*/
+
+using Types = MonteCarloModel<RandomTree<RandomTreeFloatTypes>>;
+
+void compare(const FullTraversal<Types>::MatrixNode *a, const FullTraversal<Types>::MatrixNode *b)
+{
+    assert(a->stats.payoff.get_row_value() == b->stats.payoff.get_row_value());
+    assert(a->stats.matrix_node_count == b->stats.matrix_node_count);
+    assert(a->is_terminal() == b->is_terminal());
+    for (auto chance_a = a->child, chance_b = b->child; chance_a != nullptr; chance_a = chance_a->next, chance_b = chance_b->next)
+    {
+        assert(chance_b != nullptr);
+        assert(chance_a->stats.chance_strategy == chance_b->stats.chance_strategy);
+        for (auto next_a = chance_a->child, next_b = chance_b->child; next_a != nullptr; next_a = next_a->next, next_b = next_b->next)
+        {
+            assert(next_b != nullptr);
+            compare(next_a, next_b);
+        }
+    }
+}
+
+int main()
+{
+    for (uint64_t seed = 0; seed < 8; ++seed)
+    {
+        const Types::State state{prng{seed}, 3, 3, 3, 2};
+        prng device{0};
+        Types::Model model{0};
+        FullTraversal<Types>::Search search{};
+
+        FullTraversal<Types>::MatrixNode serial_root{};
+        const auto serial_value = search.run(-1, device, state, model, serial_root);
+        assert(serial_root.count_matrix_nodes() == serial_root.stats.matrix_node_count);
+
+        for (const size_t threads : {2, 4})
+        {
+            FullTraversal<Types>::MatrixNode root{};
+            const auto value = search.run(-1, device, state, model, root, threads);
+            assert(value == serial_value);
+            compare(&serial_root, &root);
+
+            // the root is claimed, so running again does not expand it twice
+            search.run(-1, device, state, model, root, threads);
+            assert(root.count_matrix_nodes() == serial_root.count_matrix_nodes());
+        }
+    }
+    return 0;
+}
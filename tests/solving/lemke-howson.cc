@@ -0,0 +1,94 @@
+#include <pinyon.h>
+
+/*
+
+LRSNash::solve on double payoffs uses Lemke-Howson instead of lrs.
+On random games it must return an exact equilibrium (exploitability ~ 0), and for constant-sum games the same value as
+the exact rational lrs solve. Entries are drawn from a few values so that many of the games are degenerate.
+
+LemkeHowson::WarmStart must also return exact equilibria when the matrix drifts a little between solves, as the UCB
+matrix in MatrixUCB does, and it should rarely need a full solve.
+
+*/
+
+const double tolerance = 1e-9;
+
+template <template <typename> typename Value>
+void random_games(prng &device, const size_t rows, const size_t cols, const int den)
+{
+    Matrix<Value<double>> matrix{rows, cols};
+    Matrix<Value<mpq_class>> exact_matrix{rows, cols};
+    for (size_t i = 0; i < rows * cols; ++i)
+    {
+        const int u = device.random_int(den + 1);
+        const int v = device.random_int(den + 1);
+        if constexpr (Value<double>::IS_CONSTANT_SUM)
+        {
+            matrix[i] = Value<double>{static_cast<double>(u) / den};
+            exact_matrix[i] = Value<mpq_class>{mpq_class{u, den}};
+        }
+        else
+        {
+            matrix[i] = Value<double>{static_cast<double>(u) / den, static_cast<double>(v) / den};
+            exact_matrix[i] = Value<mpq_class>{mpq_class{u, den}, mpq_class{v, den}};
+        }
+    }
+
+    std::vector<double> row_strategy, col_strategy;
+    const Value<double> value = LRSNash::solve(matrix, row_strategy, col_strategy);
+    assert(row_strategy.size() == rows && col_strategy.size() == cols);
+    assert(math::exploitability(matrix, row_strategy, col_strategy) < tolerance);
+
+    if constexpr (Value<double>::IS_CONSTANT_SUM)
+    {
+        std::vector<mpq_class> exact_row_strategy, exact_col_strategy;
+        const Value<mpq_class> exact_value = LRSNash::solve(exact_matrix, exact_row_strategy, exact_col_strategy);
+        assert(std::abs(value.get_row_value() - exact_value.get_row_value().get_d()) < tolerance);
+    }
+}
+
+void drifting_games(prng &device, const size_t rows, const size_t cols)
+{
+    Matrix<PairReal<double>> matrix{rows, cols};
+    for (auto &value : matrix)
+    {
+        value = PairReal<double>{device.uniform(), device.uniform()};
+    }
+
+    LemkeHowson::WarmStart solver{};
+    std::vector<double> row_strategy, col_strategy;
+    const size_t solves = 1 << 10;
+    for (size_t solve = 0; solve < solves; ++solve)
+    {
+        auto &value = matrix[device.random_int(rows * cols)];
+        value.row_value += (device.uniform() - .5) / 10;
+        value.col_value += (device.uniform() - .5) / 10;
+        solver.solve(matrix, row_strategy, col_strategy);
+        assert(math::exploitability(matrix, row_strategy, col_strategy) < tolerance);
+    }
+    assert(solver.cold_solves < solves / 4);
+}
+
+int main()
+{
+    prng device{0};
+    for (const int den : {2, 3, 100})
+    {
+        for (size_t rows = 1; rows <= 9; ++rows)
+        {
+            for (size_t cols = 1; cols <= 9; ++cols)
+            {
+                for (int trial = 0; trial < 4; ++trial)
+                {
+                    random_games<PairReal>(device, rows, cols, den);
+                    random_games<ConstantSum<1, 1>::Value>(device, rows, cols, den);
+                }
+            }
+        }
+    }
+    for (size_t size = 2; size <= 9; ++size)
+    {
+        drifting_games(device, size, size);
+    }
+    return 0;
+}
@@ -0,0 +1,98 @@
+#include <pinyon.h>
+
+/*
+
+A SolutionCache must return the same value and strategies as `LRSNash::solve`, treat equal fractions as the same
+entry, and never hold more than its capacity. AlphaBeta must solve to the same values with and without a cache.
+
+*/
+
+using FloatTypes = RandomTreeFloatTypes;
+using RationalTypes = RandomTreeRationalTypes;
+
+FloatTypes::MatrixValue random_matrix(prng &device, const size_t rows, const size_t cols)
+{
+    FloatTypes::MatrixValue matrix{rows, cols};
+    for (auto &value : matrix)
+    {
+        value = FloatTypes::Value{device.random_int(8) / 8.0};
+    }
+    return matrix;
+}
+
+void test_float()
+{
+    prng device{0};
+    SolutionCache<FloatTypes> cache{8};
+    const auto matrix = random_matrix(device, 3, 4);
+
+    FloatTypes::VectorReal row_strategy, col_strategy, cached_row_strategy, cached_col_strategy;
+    const auto value = LRSNash::solve(matrix, row_strategy, col_strategy);
+    const auto miss = cache.solve(matrix, cached_row_strategy, cached_col_strategy);
+    assert(miss.get_row_value() == value.get_row_value());
+    cached_row_strategy.clear();
+    cached_col_strategy.clear();
+    const auto hit = cache.solve(matrix, cached_row_strategy, cached_col_strategy);
+    assert(hit.get_row_value() == value.get_row_value());
+    assert(cached_row_strategy == row_strategy && cached_col_strategy == col_strategy);
+    assert(cache.hits() == 1 && cache.misses() == 1);
+
+    // the least recently used games are replaced
+    for (size_t i = 0; i < 64; ++i)
+    {
+        cache.solve(random_matrix(device, 2, 2), cached_row_strategy, cached_col_strategy);
+    }
+    assert(cache.capacity() == 8);
+    cache.solve(matrix, cached_row_strategy, cached_col_strategy);
+    assert(cache.misses() == 66);
+
+    cache.clear();
+    assert(cache.hits() == 0 && cache.misses() == 0);
+}
+
+void test_rational()
+{
+    SolutionCache<RationalTypes> cache{};
+    RationalTypes::MatrixValue matrix{2, 2}, unreduced_matrix{2, 2};
+    for (int i = 0; i < 4; ++i)
+    {
+        matrix[i] = RationalTypes::Value{mpq_class{i, 4}};
+        mpq_class unreduced{2 * i, 8};
+        unreduced_matrix[i] = RationalTypes::Value{unreduced};
+    }
+    RationalTypes::VectorReal row_strategy, col_strategy;
+    cache.solve(matrix, row_strategy, col_strategy);
+    cache.solve(unreduced_matrix, row_strategy, col_strategy);
+    assert(cache.hits() == 1 && cache.misses() == 1);
+}
+
+void test_alpha_beta()
+{
+    using Types = MonteCarloModel<RandomTree<FloatTypes>>;
+    const auto cache = std::make_shared<SolutionCache<Types>>();
+    for (uint64_t seed = 0; seed < 16; ++seed)
+    {
+        const Types::State state{prng{seed}, 3, 3, 3, 2};
+        prng device{0};
+        Types::Model model{0};
+
+        AlphaBeta<Types>::Search search{0, 1};
+        AlphaBeta<Types>::MatrixNode root{};
+        const auto value = search.run(state.depth_bound, device, state, model, root);
+
+        AlphaBeta<Types>::Search cached_search{0, 1};
+        cached_search.solution_cache = cache;
+        AlphaBeta<Types>::MatrixNode cached_root{};
+        const auto cached_value = cached_search.run(state.depth_bound, device, state, model, cached_root);
+        assert(value == cached_value);
+    }
+    assert(cache->hits() > 0);
+}
+
+int main()
+{
+    test_float();
+    test_rational();
+    test_alpha_beta();
+    return 0;
+}
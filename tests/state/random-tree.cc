@@ -0,0 +1,94 @@
+#include <pinyon.h>
+
+/*
+
+RandomTree with hashed transitions. The chance distribution of every joint action must be exact and sum to 1,
+sampled transitions must be in its support, and the tree must be a function of the seed alone.
+
+*/
+
+template <typename State>
+void test_chance(const State &state)
+{
+    std::vector<int> chance_actions{};
+    for (int row_idx = 0; row_idx < state.rows; ++row_idx)
+    {
+        for (int col_idx = 0; col_idx < state.cols; ++col_idx)
+        {
+            state.get_chance_actions(row_idx, col_idx, chance_actions);
+            assert(!chance_actions.empty());
+            mpq_class total{0};
+            for (const int chance_action : chance_actions)
+            {
+                State child{state};
+                child.apply_actions(row_idx, col_idx, chance_action);
+                assert(child.get_prob() > 0);
+                total += child.get_prob();
+            }
+            assert(total == 1);
+
+            State child{state};
+            child.randomize_transition(uint64_t{(uint64_t)row_idx * 31 + col_idx});
+            child.apply_actions(row_idx, col_idx);
+            assert(std::find(chance_actions.begin(), chance_actions.end(), child.get_obs()) != chance_actions.end());
+        }
+    }
+}
+
+template <typename State>
+std::vector<int> rollout(State state, const uint64_t seed)
+{
+    prng device{seed};
+    std::vector<int> history{};
+    while (!state.is_terminal())
+    {
+        state.get_actions();
+        const int row_idx = device.random_int(state.rows);
+        const int col_idx = device.random_int(state.cols);
+        state.randomize_transition(device);
+        state.apply_actions(row_idx, col_idx);
+        history.push_back(state.get_obs());
+        history.push_back(state.rows);
+    }
+    history.push_back(static_cast<int>(math::to_double(state.get_payoff().get_row_value()) * 2));
+    return history;
+}
+
+int main()
+{
+    using Types = RandomTree<RandomTreeRationalTypes, true>;
+    for (uint64_t seed = 0; seed < 16; ++seed)
+    {
+        const Types::State state{Types::PRNG{seed}, 4, 3, 3, 4, Rational<>{1, 3}};
+        test_chance(state);
+        Types::State child{state};
+        child.apply_actions(1, 2, 0);
+        if (!child.is_terminal())
+        {
+            test_chance(child);
+        }
+        for (uint64_t rollout_seed = 0; rollout_seed < 4; ++rollout_seed)
+        {
+            const Types::State copy{Types::PRNG{seed}, 4, 3, 3, 4, Rational<>{1, 3}};
+            assert(rollout(state, rollout_seed) == rollout(copy, rollout_seed));
+        }
+    }
+
+    // distinct joint actions lead to distinct subtrees
+    const Types::State state{Types::PRNG{0}, 4, 3, 3, 4};
+    Types::State a{state}, b{state};
+    a.apply_actions(0, 1, 0);
+    b.apply_actions(1, 0, 0);
+    assert(a.node_seed != b.node_seed);
+
+    // hashed trees can be searched like any other
+    using SearchTypes = TreeBandit<Exp3<MonteCarloModel<RandomTree<RandomTreeFastTypes, true>>>>;
+    SearchTypes::PRNG device{0};
+    const SearchTypes::State search_state{device, 5, 8, 8, 8};
+    SearchTypes::Model model{0};
+    SearchTypes::MatrixNode root{};
+    SearchTypes::Search search{};
+    search.run_for_iterations(1 << 10, device, search_state, model, root);
+    assert(root.stats.visits == (1 << 10) - 1);
+    return 0;
+}
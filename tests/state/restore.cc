@@ -0,0 +1,82 @@
+#include <pinyon.h>
+
+/*
+
+A restorable state is copied once per search and restored at the start of every iteration; any other state is copied
+every iteration. Both must give the same iterations, so for the same seed TreeBandit, TreeBanditThreaded (one thread),
+TreeBanditRootMatrix and TreeBanditFlat must produce identical stats either way.
+
+`CopiedState` derives from a restorable state without redeclaring `restore`, which hides it from the concept.
+
+*/
+
+template <typename Types>
+struct CopiedState : Types
+{
+    class State : public Types::State
+    {
+    public:
+        State(const typename Types::State &state) : Types::State{state} {}
+    };
+};
+
+const size_t iterations = 1 << 12;
+
+// `Stats` is the bandit's own stats, which the threaded search derives from
+template <typename Stats, typename Types>
+Stats tree_bandit_stats(typename Types::Search search, const typename Types::State &state)
+{
+    typename Types::PRNG device{0};
+    typename Types::Model model{0};
+    typename Types::MatrixNode root{};
+    search.run_for_iterations(iterations, device, state, model, root);
+    assert(root.count_matrix_nodes() > 1);
+    return static_cast<const Stats &>(root.stats);
+}
+
+template <typename Types>
+typename Types::MatrixStats flat_stats(const typename Types::State &state)
+{
+    typename Types::Search search{};
+    typename Types::PRNG device{0};
+    typename Types::Model model{0};
+    search.run_for_iterations(iterations, device, state, model);
+    return search.matrix_data[0].stats;
+}
+
+template <typename Types>
+void test_restore(const typename Types::State &state)
+{
+    using Copied = CopiedState<Types>;
+    using Stats = typename Types::MatrixStats;
+    static_assert(IsRestorableStateTypes<Types>);
+    static_assert(!IsRestorableStateTypes<Copied>);
+    const typename Copied::State copied_state{state};
+
+    const Stats stats = tree_bandit_stats<Stats, TreeBandit<Types>>({}, state);
+    const Stats copied_stats = tree_bandit_stats<Stats, TreeBandit<Copied>>({}, copied_state);
+    assert(stats == copied_stats);
+
+    const typename Types::BanditAlgorithm bandit{};
+    const Stats threaded_stats = tree_bandit_stats<Stats, TreeBanditThreaded<Types>>({bandit, 1}, state);
+    const Stats copied_threaded_stats = tree_bandit_stats<Stats, TreeBanditThreaded<Copied>>({bandit, 1}, copied_state);
+    assert(threaded_stats == copied_threaded_stats);
+
+    const Stats root_matrix_stats = tree_bandit_stats<Stats, TreeBanditRootMatrix<Types>>({}, state);
+    const Stats copied_root_matrix_stats = tree_bandit_stats<Stats, TreeBanditRootMatrix<Copied>>({}, copied_state);
+    assert(root_matrix_stats == copied_root_matrix_stats);
+
+    assert(flat_stats<TreeBanditFlat<Types>>(state) == flat_stats<TreeBanditFlat<Copied>>(copied_state));
+}
+
+int main()
+{
+    using MoldTypes = Exp3<MonteCarloModel<MoldState<>>>;
+    test_restore<MoldTypes>(MoldTypes::State{3, 10});
+
+    // chance nodes, and a state whose vectors are reused by restore
+    using RandomTreeTypes = Exp3<MonteCarloModel<RandomTree<>>>;
+    test_restore<RandomTreeTypes>(RandomTreeTypes::State{RandomTreeTypes::PRNG{0}, 6, 3, 3, 3});
+
+    return 0;
+}
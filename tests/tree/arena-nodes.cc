@@ -0,0 +1,63 @@
+#include <pinyon.h>
+
+/*
+
+ArenaNodes only changes where nodes are allocated, so a single threaded search must produce
+exactly the same tree as DefaultNodes for a fixed seed. This must also hold after the root has been reset and reused.
+Reset also clears the actions and value stored in the root.
+
+*/
+
+template <typename Types>
+typename Types::MatrixStats search_stats(
+    const size_t iterations,
+    const typename Types::State &state,
+    typename Types::MatrixNode &root)
+{
+    typename Types::PRNG device{0};
+    typename Types::Model model{0};
+    typename Types::Search search{};
+    search.run_for_iterations(iterations, device, state, model, root);
+    return root.stats;
+}
+
+int main()
+{
+    using BaseTypes = Exp3<MonteCarloModel<MoldState<>>>;
+    using DefaultTypes = TreeBandit<BaseTypes, DefaultNodes>;
+    using ArenaTypes = TreeBandit<BaseTypes, ArenaNodes>;
+
+    const size_t iterations = 1 << 16;
+    BaseTypes::State state{3, 10};
+
+    DefaultTypes::MatrixNode default_root{};
+    ArenaTypes::MatrixNode arena_root{};
+
+    const auto default_stats = search_stats<DefaultTypes>(iterations, state, default_root);
+    const auto arena_stats = search_stats<ArenaTypes>(iterations, state, arena_root);
+    assert(default_stats == arena_stats);
+    assert(default_root.count_matrix_nodes() == arena_root.count_matrix_nodes());
+
+    const size_t bytes = arena_root.bytes_in_use();
+    assert(bytes >= arena_root.count_matrix_nodes() * sizeof(ArenaTypes::MatrixNode));
+    std::cout << "matrix nodes: " << arena_root.count_matrix_nodes() << ", bytes in use: " << bytes << std::endl;
+
+    arena_root.reset();
+    assert(arena_root.count_matrix_nodes() == 1);
+    assert(!arena_root.is_expanded());
+
+    const auto reset_stats = search_stats<ArenaTypes>(iterations, state, arena_root);
+    assert(default_stats == reset_stats);
+    assert(arena_root.bytes_in_use() == bytes);
+
+    using DataNodes = ArenaNodes<BaseTypes, DefaultTypes::MatrixStats, DefaultTypes::ChanceStats, std::vector<int>, double>;
+    DataNodes::MatrixNode data_root{};
+    data_root.row_actions = {0, 1};
+    data_root.col_actions = {2};
+    data_root.value = 1;
+    data_root.reset();
+    assert(data_root.row_actions.empty() && data_root.col_actions.empty());
+    assert(data_root.value == 0);
+
+    return 0;
+}
@@ -0,0 +1,181 @@
+#include <pinyon.h>
+
+#include <thread>
+
+/*
+
+Deadline reads the clock only every `interval` calls and re-estimates `interval` from the measured rate, so the clock
+is read about once per `resolution` whatever an iteration costs, and a loop does not run past its deadline by more
+than it plans to. A clock that only moves when the test says so makes this exact.
+
+A timed `run` returns close to its budget, and setting `stop_flag` from another thread ends a `run` whose budget would
+otherwise last for an hour, in TreeBandit, TreeBanditThreaded, TreeBanditThreadPool and OffPolicy.
+
+*/
+
+struct ManualClock
+{
+    using duration = std::chrono::nanoseconds;
+    using rep = duration::rep;
+    using period = duration::period;
+    using time_point = std::chrono::time_point<ManualClock>;
+    static constexpr bool is_steady = true;
+
+    static inline time_point current{};
+    static inline size_t reads = 0;
+
+    static time_point now()
+    {
+        ++reads;
+        return current;
+    }
+};
+
+// Runs a loop whose iterations take `cost` of ManualClock time until the deadline expires
+size_t manual_loop(Deadline<ManualClock> &deadline, const std::chrono::nanoseconds cost)
+{
+    size_t iterations = 0;
+    while (!deadline.expired())
+    {
+        ManualClock::current += cost;
+        ++iterations;
+    }
+    return iterations;
+}
+
+void test_interval()
+{
+    const auto resolution = Deadline<ManualClock>::resolution;
+    for (const auto cost : {std::chrono::nanoseconds{100}, std::chrono::nanoseconds{1000}, std::chrono::nanoseconds{250000}})
+    {
+        ManualClock::reads = 0;
+        const auto budget = std::chrono::milliseconds{10};
+        Deadline<ManualClock> deadline{budget};
+        const size_t iterations = manual_loop(deadline, cost);
+        const size_t expected = budget / cost;
+        // never planned past the deadline, so at most one iteration over it
+        assert(iterations >= expected && iterations <= expected + 1);
+        // about one read per resolution once the rate is known, plus the reads spent measuring it
+        const size_t resolutions = budget / resolution;
+        assert(ManualClock::reads <= resolutions + 32);
+        if (cost < resolution)
+        {
+            assert(ManualClock::reads >= resolutions / 2);
+        }
+        else
+        {
+            // an iteration longer than the resolution is checked every time
+            assert(ManualClock::reads >= expected);
+        }
+    }
+
+    // the iterations slow down tenfold halfway through, and the interval follows
+    {
+        ManualClock::reads = 0;
+        Deadline<ManualClock> deadline{std::chrono::milliseconds{20}};
+        size_t iterations = 0;
+        for (; iterations < 10000 && !deadline.expired(); ++iterations)
+        {
+            ManualClock::current += std::chrono::microseconds{1};
+        }
+        const size_t fast_reads = ManualClock::reads;
+        const size_t slow_iterations = manual_loop(deadline, std::chrono::microseconds{10});
+        assert(slow_iterations >= 1000 && slow_iterations <= 1001);
+        // still about one read per resolution at the slower rate
+        assert(ManualClock::reads - fast_reads <= 100 + 32);
+    }
+
+    // the flag is checked on every call, and an expired deadline stays expired
+    {
+        std::atomic<bool> stop{false};
+        Deadline<ManualClock> deadline{std::chrono::hours{1}, &stop};
+        assert(!deadline.expired());
+        stop = true;
+        assert(deadline.expired());
+        stop = false;
+        assert(deadline.expired());
+    }
+
+    // durations the clock cannot represent never expire, and a zero duration expires on the first call
+    {
+        Deadline<ManualClock> forever{static_cast<size_t>(-1)};
+        Deadline<ManualClock> forever_us{std::chrono::microseconds::max()};
+        Deadline<ManualClock> now{size_t{0}};
+        ManualClock::current += std::chrono::hours{24 * 365};
+        for (int i = 0; i < 1000; ++i)
+        {
+            assert(!forever.expired());
+            assert(!forever_us.expired());
+        }
+        assert(now.expired());
+    }
+}
+
+template <typename Search, typename Run>
+void test_timed_run(Search &search, Run run)
+{
+    const size_t budget_ms = 50;
+    const auto start = std::chrono::steady_clock::now();
+    const size_t iterations = run(search, budget_ms);
+    const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+    assert(iterations > 0);
+    assert(elapsed.count() >= budget_ms);
+    assert(elapsed.count() < budget_ms + 50);
+
+    std::atomic<bool> stop{false};
+    search.stop_flag = &stop;
+    std::thread stopper{[&stop]()
+                        {
+                            std::this_thread::sleep_for(std::chrono::milliseconds{20});
+                            stop = true;
+                        }};
+    const auto stop_start = std::chrono::steady_clock::now();
+    run(search, 60 * 60 * 1000);
+    const auto stop_elapsed = std::chrono::steady_clock::now() - stop_start;
+    stopper.join();
+    assert(stop_elapsed < std::chrono::seconds{5});
+    search.stop_flag = nullptr;
+}
+
+template <typename Types>
+size_t run_tree_bandit(typename Types::Search &search, const size_t duration_ms)
+{
+    typename Types::PRNG device{0};
+    typename Types::Model model{0};
+    typename Types::State state{3, 10};
+    typename Types::MatrixNode root{};
+    return search.run(duration_ms, device, state, model, root);
+}
+
+int main()
+{
+    test_interval();
+
+    using BaseTypes = Exp3<MonteCarloModel<MoldState<>>>;
+
+    using Single = TreeBandit<BaseTypes>;
+    Single::Search single{};
+    test_timed_run(single, run_tree_bandit<Single>);
+
+    using Threaded = TreeBanditThreaded<BaseTypes>;
+    Threaded::Search threaded{Threaded::BanditAlgorithm{}, 2};
+    test_timed_run(threaded, run_tree_bandit<Threaded>);
+
+    using ThreadPool = TreeBanditThreadPool<BaseTypes>;
+    ThreadPool::Search thread_pool{ThreadPool::BanditAlgorithm{}, 2, 64};
+    test_timed_run(thread_pool, run_tree_bandit<ThreadPool>);
+
+    using OffPolicyTypes = OffPolicy<BaseTypes>;
+    OffPolicyTypes::Search off_policy{};
+    test_timed_run(off_policy,
+                   [](OffPolicyTypes::Search &search, const size_t duration_ms)
+                   {
+                       OffPolicyTypes::PRNG device{0};
+                       OffPolicyTypes::Model model{0};
+                       const std::vector<OffPolicyTypes::State> states(4, OffPolicyTypes::State{3, 10});
+                       std::vector<OffPolicyTypes::MatrixNode> roots(4);
+                       return search.run(duration_ms, 8, device, states, model, roots);
+                   });
+
+    return 0;
+}
@@ -0,0 +1,110 @@
+#include <pinyon.h>
+
+/*
+
+PackedNodes only changes where the node data is stored, so a single threaded search must produce exactly the same tree
+as DefaultNodes for a fixed seed. With `BlockVector` stats, the stats of every expanded node must live in its block.
+
+*/
+
+template <typename Types>
+typename Types::MatrixStats search_stats(
+    const size_t iterations,
+    const typename Types::State &state,
+    typename Types::MatrixNode &root)
+{
+    typename Types::PRNG device{0};
+    typename Types::Model model{0};
+    typename Types::Search search{};
+    search.run_for_iterations(iterations, device, state, model, root);
+    return root.stats;
+}
+
+template <typename BaseTypes>
+void test_equivalence(const typename BaseTypes::State &state)
+{
+    using DefaultTypes = TreeBandit<BaseTypes, DefaultNodes>;
+    using PackedTypes = TreeBandit<BaseTypes, PackedNodes>;
+
+    const size_t iterations = 1 << 14;
+
+    typename DefaultTypes::MatrixNode default_root{};
+    typename PackedTypes::MatrixNode packed_root{};
+
+    const auto default_stats = search_stats<DefaultTypes>(iterations, state, default_root);
+    const auto packed_stats = search_stats<PackedTypes>(iterations, state, packed_root);
+    assert(default_stats.row_gains == packed_stats.row_gains && default_stats.col_gains == packed_stats.col_gains);
+    assert(default_stats.row_visits == packed_stats.row_visits && default_stats.col_visits == packed_stats.col_visits);
+    assert(default_root.count_matrix_nodes() == packed_root.count_matrix_nodes());
+}
+
+template <typename MatrixNode>
+void check_bound(const MatrixNode *matrix_node)
+{
+    if (!matrix_node->is_expanded())
+    {
+        return;
+    }
+    const std::byte *begin = matrix_node->block.data;
+    const std::byte *end = reinterpret_cast<const std::byte *>(matrix_node->block.chance_nodes);
+    assert(reinterpret_cast<uintptr_t>(begin) % 64 == 0);
+    for (const auto *vector : {&matrix_node->stats.row_gains, &matrix_node->stats.col_gains})
+    {
+        assert(vector->is_bound());
+        assert(reinterpret_cast<const std::byte *>(vector->data()) >= begin);
+        assert(reinterpret_cast<const std::byte *>(vector->data() + vector->size()) <= end);
+    }
+    for (const auto *vector : {&matrix_node->stats.row_visits, &matrix_node->stats.col_visits})
+    {
+        assert(vector->is_bound());
+        assert(reinterpret_cast<const std::byte *>(vector->data()) >= begin);
+        assert(reinterpret_cast<const std::byte *>(vector->data() + vector->size()) <= end);
+    }
+    for (size_t i = 0; i < matrix_node->block.n_chance_nodes; ++i)
+    {
+        for (const MatrixNode *child = matrix_node->block.chance_nodes[i].child; child != nullptr; child = child->next)
+        {
+            check_bound(child);
+        }
+    }
+}
+
+void test_bound()
+{
+    using BaseTypes = Exp3<MonteCarloModel<RandomTree<RandomTreePackedTypes, true>>>;
+    using PackedTypes = TreeBandit<BaseTypes, PackedNodes>;
+    const BaseTypes::State state{BaseTypes::PRNG{0}, 4, 3, 3, 2};
+    PackedTypes::MatrixNode root{};
+    search_stats<PackedTypes>(1 << 12, state, root);
+    check_bound(&root);
+
+    // a copy of bound stats owns its vectors
+    const PackedTypes::MatrixStats stats{root.stats};
+    assert(!stats.row_gains.is_bound());
+    assert(stats == root.stats);
+}
+
+void test_block_vector()
+{
+    std::array<int, 4> storage{};
+    BlockVector<int> vector{1, 2};
+    vector.bind(storage.data(), storage.size());
+    assert(vector.is_bound() && vector.size() == 2 && storage[1] == 2);
+    vector.resize(4, 3);
+    assert(vector.data() == storage.data() && storage[3] == 3);
+    vector.push_back(4);
+    assert(!vector.is_bound());
+    assert(vector == (BlockVector<int>{1, 2, 3, 3, 4}));
+}
+
+int main()
+{
+    test_equivalence<Exp3<MonteCarloModel<MoldState<>>>>({3, 10});
+    test_equivalence<Exp3<MonteCarloModel<RandomTree<RandomTreePackedTypes, true>>>>(
+        {RandomTreePackedTypes::PRNG{0}, 4, 3, 3, 2});
+    test_equivalence<Exp3Fat<MonteCarloModel<RandomTree<RandomTreePackedTypes, true>>>>(
+        {RandomTreePackedTypes::PRNG{0}, 4, 3, 3, 2});
+    test_bound();
+    test_block_vector();
+    return 0;
+}
@@ -0,0 +1,87 @@
+#include <pinyon.h>
+
+#include <thread>
+
+/*
+
+`promote` must keep exactly the stats and subtree of the chosen grandchild, and a following `run` must continue on it.
+If the grandchild was never visited, the root is cleared. The other branches are either deleted or handed to the
+caller through `garbage_out`, here freed on a thread that is joined.
+
+Checked for DefaultNodes and FlatNodes, and for the threaded stats, whose mutexes are re-created on move.
+
+*/
+
+using BaseTypes = Exp3<MonteCarloModel<RandomTree<>>>;
+
+const size_t transitions = 2;
+
+template <typename Types>
+void test_promote(typename Types::Search search, const bool free_on_thread)
+{
+    const typename Types::State state{prng{0}, 4, 3, 3, transitions};
+    typename Types::PRNG device{0};
+    typename Types::Model model{0};
+    typename Types::MatrixNode root{};
+    search.run_for_iterations(1 << 12, device, state, model, root);
+
+    typename Types::State next_state{state};
+    next_state.get_actions();
+    const typename Types::Action row_action{next_state.row_actions[1]};
+    const typename Types::Action col_action{next_state.col_actions[2]};
+    std::vector<typename Types::Obs> chance_actions{};
+    next_state.get_chance_actions(row_action, col_action, chance_actions);
+    next_state.apply_actions(row_action, col_action, chance_actions[0]);
+    const typename Types::Obs obs = next_state.get_obs();
+
+    const auto *kept = root.access(1, 2)->access(obs);
+    const typename BaseTypes::MatrixStats kept_stats = kept->stats;
+    const size_t kept_count = kept->count_matrix_nodes();
+    assert(kept_stats.visits > 0);
+    assert(kept_count > 1);
+
+    std::unique_ptr<typename Types::MatrixNode> garbage{};
+    const bool found = root.promote(1, 2, obs, free_on_thread ? &garbage : nullptr);
+    assert(found);
+    assert(static_cast<const typename BaseTypes::MatrixStats &>(root.stats) == kept_stats);
+    assert(root.count_matrix_nodes() == kept_count);
+    if (free_on_thread)
+    {
+        assert(garbage != nullptr);
+        std::thread deleter{[&garbage]()
+                            { garbage.reset(); }};
+        deleter.join();
+    }
+
+    const int visits = root.stats.visits;
+    search.run_for_iterations(1 << 10, device, next_state, model, root);
+    assert(root.stats.visits == visits + (1 << 10));
+    assert(root.count_matrix_nodes() > kept_count);
+
+    // no transition ever produces this obs
+    assert(!root.promote(0, 0, typename Types::Obs{transitions}));
+    assert(!root.is_expanded());
+    assert(root.count_matrix_nodes() == 1);
+    assert(root.stats.visits == 0);
+
+    search.run_for_iterations(1 << 10, device, next_state, model, root);
+    // the first iteration only expands the cleared root
+    assert(root.stats.visits == (1 << 10) - 1);
+}
+
+int main()
+{
+    using Default = TreeBandit<BaseTypes, DefaultNodes>;
+    using Flat = TreeBandit<BaseTypes, FlatNodes>;
+    using Threaded = TreeBanditThreaded<BaseTypes, DefaultNodes>;
+    using ThreadPool = TreeBanditThreadPool<BaseTypes, DefaultNodes>;
+
+    for (const bool free_on_thread : {false, true})
+    {
+        test_promote<Default>(Default::Search{}, free_on_thread);
+        test_promote<Flat>(Flat::Search{}, free_on_thread);
+        test_promote<Threaded>(Threaded::Search{BaseTypes::BanditAlgorithm{}, 1}, free_on_thread);
+        test_promote<ThreadPool>(ThreadPool::Search{BaseTypes::BanditAlgorithm{}, 1, 64}, free_on_thread);
+    }
+    return 0;
+}
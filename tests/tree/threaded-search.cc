@@ -0,0 +1,82 @@
+#include <pinyon.h>
+
+#include <thread>
+
+/*
+
+The threaded searches draw one seed per thread from the device passed to each call and copy the model on each call.
+With one thread a search is then reproduced exactly by its seed, however many calls the Search object has made
+before, and a model that is changed in place between calls is seen by the next call.
+
+Copies of a search get their own WorkerPool, unless the pool was passed in explicitly, and can run at the same time.
+
+*/
+
+using BaseTypes = Exp3<MonteCarloModel<MoldState<>>>;
+
+const size_t iterations = 1 << 10;
+
+template <typename Types>
+typename BaseTypes::MatrixStats search_stats(typename Types::Search &search, const uint64_t device_seed, const uint64_t model_seed)
+{
+    typename Types::PRNG device{device_seed};
+    typename Types::Model model{model_seed};
+    typename Types::State state{3, 10};
+    typename Types::MatrixNode root{};
+    search.run_for_iterations(iterations, device, state, model, root);
+    return root.stats;
+}
+
+template <typename Types>
+void test_search(typename Types::Search search)
+{
+    typename Types::Search fresh_search{search};
+    const auto expected = search_stats<Types>(fresh_search, 1, 0);
+
+    // repeated calls on one search
+    search_stats<Types>(search, 0, 0);
+    assert(search_stats<Types>(search, 1, 0) == expected);
+
+    // a model changed in place, at the same address
+    {
+        typename Types::PRNG device{1};
+        typename Types::Model model{1};
+        typename Types::State state{3, 10};
+        typename Types::MatrixNode root{};
+        search.run_for_iterations(iterations, device, state, model, root);
+        model = typename Types::Model{0};
+        typename Types::MatrixNode second_root{};
+        device = typename Types::PRNG{1};
+        search.run_for_iterations(iterations, device, state, model, second_root);
+        assert(static_cast<const BaseTypes::MatrixStats &>(second_root.stats) == expected);
+    }
+
+    // copies do not share a pool and can run at the same time
+    typename Types::Search copy{search};
+    assert(copy.pool.get() != search.pool.get());
+    BaseTypes::MatrixStats copy_stats, search_stats_;
+    std::thread copy_thread{[&copy, &copy_stats]()
+                            { copy_stats = search_stats<Types>(copy, 1, 0); }};
+    search_stats_ = search_stats<Types>(search, 1, 0);
+    copy_thread.join();
+    assert(copy_stats == expected);
+    assert(search_stats_ == expected);
+}
+
+int main()
+{
+    using Threaded = TreeBanditThreaded<BaseTypes>;
+    using ThreadPool = TreeBanditThreadPool<BaseTypes>;
+
+    test_search<Threaded>(Threaded::Search{BaseTypes::BanditAlgorithm{}, 1});
+    test_search<ThreadPool>(ThreadPool::Search{BaseTypes::BanditAlgorithm{}, 1, 64});
+
+    // an explicitly shared pool stays shared by copies
+    auto pool = std::make_shared<WorkerPool>(2);
+    Threaded::Search search{BaseTypes::BanditAlgorithm{}, pool};
+    Threaded::Search copy{search};
+    assert(search.pool.get() == pool.get());
+    assert(copy.pool.get() == pool.get());
+
+    return 0;
+}
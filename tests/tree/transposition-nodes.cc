@@ -0,0 +1,181 @@
+#include <pinyon.h>
+
+/*
+
+Without a state hash TranspositionNodes stores a tree keyed by path, so it must produce the same stats as DefaultNodes.
+With a hashable state, different paths to the same state must share a matrix node. The table must never hold more
+matrix nodes than its capacity, even when the search needs far more, and only the search may start a descent.
+
+States whose hashes collide must only share a node if they also have the same action counts. `CollidingGame` hashes
+only the turns left and gives a state three row actions when its score is odd and two when it is even, so a shared
+node would be sized for the wrong state.
+
+*/
+
+template <typename Types>
+struct CollidingGame : Types
+{
+    class State : public Types::State
+    {
+    public:
+        State(const size_t n_actions, const size_t turns) : Types::State{n_actions, turns}
+        {
+        }
+
+        uint64_t get_hash() const
+        {
+            return this->turns;
+        }
+
+        void apply_actions(
+            Types::Action row_action,
+            Types::Action col_action)
+        {
+            Types::State::apply_actions(row_action, col_action);
+            this->init_range_actions(this->score % 2 == 0 ? 2 : 3, 2);
+        }
+    };
+};
+
+template <typename Types>
+typename Types::MatrixStats search_stats(
+    const size_t iterations,
+    const typename Types::State &state,
+    typename Types::MatrixNode &root)
+{
+    typename Types::PRNG device{0};
+    typename Types::Model model{0};
+    typename Types::Search search{};
+    search.run_for_iterations(iterations, device, state, model, root);
+    return root.stats;
+}
+
+void test_tree()
+{
+    using BaseTypes = Exp3<MonteCarloModel<MoldState<>>>;
+    using DefaultTypes = TreeBandit<BaseTypes, DefaultNodes>;
+    using TranspositionTypes = TreeBandit<BaseTypes, TranspositionNodes>;
+    static_assert(!IsHashableStateTypes<BaseTypes>);
+    static_assert(IsTranspositionNodeTypes<TranspositionNodes<BaseTypes, BaseTypes::MatrixStats, BaseTypes::ChanceStats>>);
+
+    const size_t iterations = 1 << 14;
+    BaseTypes::State state{3, 10};
+    DefaultTypes::MatrixNode default_root{};
+    // large enough that no bucket is ever full
+    TranspositionTypes::MatrixNode transposition_root{1 << 20};
+    assert(search_stats<DefaultTypes>(iterations, state, default_root) ==
+           search_stats<TranspositionTypes>(iterations, state, transposition_root));
+    assert(default_root.count_matrix_nodes() == transposition_root.count_matrix_nodes());
+}
+
+template <typename Types>
+void test_transpositions()
+{
+    static_assert(IsHashableStateTypes<Types>);
+    const typename Types::State state{3, 6};
+    typename Types::MatrixNode root{};
+    search_stats<Types>(1 << 12, state, root);
+    assert(root.stats.visits == (1 << 12) - 1);
+
+    // every pair of two-turn paths that reach the same state has the same matrix node
+    size_t shared = 0;
+    for (int a = 0; a < 9; ++a)
+    {
+        for (int b = 0; b < 9; ++b)
+        {
+            typename Types::State x{state}, y{state};
+            x.apply_actions(a / 3, a % 3);
+            y.apply_actions(b / 3, b % 3);
+            if (a == b || x.get_hash() != y.get_hash())
+            {
+                continue;
+            }
+            const auto *x_node = root.access(a / 3, a % 3)->access(
+                x.get_obs(), x.get_hash(), x.row_actions.size(), x.col_actions.size());
+            const auto *y_node = root.access(b / 3, b % 3)->access(
+                y.get_obs(), y.get_hash(), y.row_actions.size(), y.col_actions.size());
+            assert(x_node == y_node);
+            ++shared;
+        }
+    }
+    assert(shared > 0);
+
+    // a tree this size would have hundreds of thousands of matrix nodes, but the game only has a few hundred states
+    assert(root.count_matrix_nodes() < 7 * 13 + 1);
+}
+
+template <typename Types>
+void test_collisions()
+{
+    static_assert(IsHashableStateTypes<Types>);
+    const typename Types::State state{2, 6};
+    typename Types::MatrixNode root{};
+    search_stats<Types>(1 << 12, state, root);
+    assert(root.stats.visits == (1 << 12) - 1);
+
+    // the same hash with other action counts is another node, and with the same counts it is the same node
+    auto *chance_node = root.access(0, 0);
+    const typename Types::Obs obs{};
+    auto *node = chance_node->access(obs, 1 << 20, 2, 2);
+    assert(chance_node->access(obs, 1 << 20, 2, 2) == node);
+    assert(chance_node->access(obs, 1 << 20, 3, 2) != node);
+    assert(chance_node->access(obs, 1 << 20, 2, 3) != node);
+
+    // both kinds of state are reached after one turn, and each has a node sized for it
+    bool seen[2]{};
+    for (int a = 0; a < 4; ++a)
+    {
+        typename Types::State x{state};
+        x.apply_actions(a / 2, a % 2);
+        const auto *x_node =
+            root.access(a / 2, a % 2)->access(x.get_obs(), x.get_hash(), x.row_actions.size(), x.col_actions.size());
+        assert(x_node != nullptr && x_node->stats.row_gains.size() == x.row_actions.size());
+        seen[x.row_actions.size() - 2] = true;
+    }
+    assert(seen[0] && seen[1]);
+}
+
+void test_capacity()
+{
+    using Types = TreeBandit<Exp3<MonteCarloModel<RandomTree<RandomTreeFastTypes, true>>>, TranspositionNodes>;
+    const Types::State state{Types::PRNG{0}, 8, 4, 4, 3};
+    Types::MatrixNode root{64};
+    search_stats<Types>(1 << 12, state, root);
+    assert(root.stats.visits == (1 << 12) - 1);
+    assert(root.count_matrix_nodes() <= 64 + 1);
+
+    // only the search starts a descent, so inspecting the tree afterwards frees nothing
+    const uint64_t descent = root.table->descent;
+    for (int row_idx = 0; row_idx < 4; ++row_idx)
+    {
+        for (int col_idx = 0; col_idx < 4; ++col_idx)
+        {
+            root.access(row_idx, col_idx);
+        }
+    }
+    assert(root.table->descent == descent);
+
+    // a batch is one descent, so nodes that did not fit stay alive until every path of the batch is backpropagated
+    using BatchedTypes = TreeBanditBatched<Exp3<MonteCarloModel<RandomTree<RandomTreeFastTypes, true>>>, TranspositionNodes>;
+    BatchedTypes::MatrixNode batched_root{64};
+    BatchedTypes::PRNG device{0};
+    BatchedTypes::Model model{0};
+    BatchedTypes::Search search{BatchedTypes::BanditAlgorithm{}, 16, static_cast<size_t>(-1)};
+    search.run_for_iterations(1 << 12, device, state, model, batched_root);
+    assert(batched_root.stats.visits == (1 << 12) - 1);
+    assert(batched_root.count_matrix_nodes() <= 64 + 1);
+}
+
+int main()
+{
+    using BaseTypes = Exp3<MonteCarloModel<ScoreGame<>>>;
+    test_tree();
+    test_transpositions<TreeBandit<BaseTypes, TranspositionNodes>>();
+    test_transpositions<TreeBandit<BaseTypes, TranspositionNodes, SearchOptions<void, bool>>>();
+    using CollidingTypes = Exp3<MonteCarloModel<CollidingGame<ScoreGame<>>>>;
+    test_collisions<TreeBandit<CollidingTypes, TranspositionNodes>>();
+    test_collisions<TreeBandit<CollidingTypes, TranspositionNodes, SearchOptions<void, bool>>>();
+    test_collisions<TreeBanditBatched<CollidingTypes, TranspositionNodes>>();
+    test_capacity();
+    return 0;
+}
@@ -0,0 +1,58 @@
+#include <pinyon.h>
+
+/*
+
+With a batch size of 1 and no virtual loss, TreeBanditBatched performs the same iterations as TreeBandit.
+With larger batches every path is still backpropagated exactly once. The unexpanded root is expanded by a batch
+of its own, so as with TreeBandit only the first iteration ends at the root.
+
+*/
+
+int main()
+{
+    using BaseTypes = Exp3<MonteCarloModel<MoldState<>>>;
+    using Types = TreeBandit<BaseTypes>;
+    using BatchedTypes = TreeBanditBatched<BaseTypes>;
+
+    const size_t iterations = 1 << 14;
+    const size_t max_wait_us = static_cast<size_t>(-1);
+    BaseTypes::State state{3, 10};
+
+    Types::PRNG device{0};
+    Types::Model model{0};
+    Types::MatrixNode root{};
+    Types::Search search{};
+    search.run_for_iterations(iterations, device, state, model, root);
+
+    BatchedTypes::PRNG batched_device{0};
+    BatchedTypes::Model batched_model{0};
+    BatchedTypes::MatrixNode batched_root{};
+    BatchedTypes::Search batched_search{BatchedTypes::BanditAlgorithm{}, 1, max_wait_us, 0};
+    batched_search.run_for_iterations(iterations, batched_device, state, batched_model, batched_root);
+
+    Types::VectorReal row_strategy, col_strategy, batched_row_strategy, batched_col_strategy;
+    search.get_empirical_strategies(root.stats, row_strategy, col_strategy);
+    batched_search.get_empirical_strategies(batched_root.stats, batched_row_strategy, batched_col_strategy);
+    assert(root.stats.visits == batched_root.stats.visits);
+    assert(row_strategy == batched_row_strategy);
+    assert(col_strategy == batched_col_strategy);
+    assert(root.count_matrix_nodes() == batched_root.count_matrix_nodes());
+
+    for (const size_t batch_size : {8, 64})
+    {
+        BatchedTypes::MatrixNode root{};
+        BatchedTypes::Search search{BatchedTypes::BanditAlgorithm{}, batch_size, max_wait_us};
+        search.run_for_iterations(iterations, batched_device, state, batched_model, root);
+        assert(root.stats.visits == iterations - 1);
+    }
+
+    // a batch that has waited too long is sent after the current descent, so no wait still makes progress
+    {
+        BatchedTypes::MatrixNode root{};
+        BatchedTypes::Search search{BatchedTypes::BanditAlgorithm{}, 64, 0};
+        search.run_for_iterations(1 << 10, batched_device, state, batched_model, root);
+        assert(root.stats.visits == (1 << 10) - 1);
+    }
+
+    return 0;
+}
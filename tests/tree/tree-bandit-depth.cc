@@ -0,0 +1,42 @@
+#include <pinyon.h>
+
+/*
+
+MoldState with one action per player is a chain, so every iteration of TreeBandit descends one level deeper than
+the last until it reaches the terminal node. The descent uses an explicit stack, so thousands of levels are fine,
+and it must agree with TreeBanditBatched (batch size 1), which also descends iteratively.
+
+*/
+
+int main()
+{
+    using BaseTypes = Exp3<MonteCarloModel<MoldState<>>>;
+    using Types = TreeBandit<BaseTypes>;
+    using BatchedTypes = TreeBanditBatched<BaseTypes>;
+
+    const size_t depth = 1 << 12;
+    const size_t iterations = depth + 16;
+    BaseTypes::State state{1, depth};
+
+    Types::PRNG device{0};
+    Types::Model model{0};
+    Types::MatrixNode root{};
+    Types::Search search{};
+    search.run_for_iterations(iterations, device, state, model, root);
+    assert(root.stats.visits == iterations - 1);
+    assert(root.count_matrix_nodes() == depth + 1);
+
+    BatchedTypes::PRNG batched_device{0};
+    BatchedTypes::Model batched_model{0};
+    BatchedTypes::MatrixNode batched_root{};
+    BatchedTypes::Search batched_search{BatchedTypes::BanditAlgorithm{}, 1, static_cast<size_t>(-1), 0};
+    batched_search.run_for_iterations(iterations, batched_device, state, batched_model, batched_root);
+
+    Types::Value value, batched_value;
+    search.get_empirical_value(root.stats, value);
+    batched_search.get_empirical_value(batched_root.stats, batched_value);
+    assert(value.get_row_value() == batched_value.get_row_value());
+    assert(device.uniform() == batched_device.uniform());
+
+    return 0;
+}
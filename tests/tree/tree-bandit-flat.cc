@@ -0,0 +1,89 @@
+#include <pinyon.h>
+
+/*
+
+TreeBanditFlat has no cap on the number of iterations, and a search object that is reused must give the same result
+as a new one, with or without `update_using_average`. Transitions with equal hashes must still get distinct children.
+A descent stops at `max_depth` and evaluates the node it reached there.
+
+*/
+
+using BaseTypes = Exp3<MonteCarloModel<MoldState<>>>;
+using FlatTypes = TreeBanditFlat<BaseTypes>;
+
+template <typename Options>
+void test_equivalence()
+{
+    const size_t iterations = 1 << 14;
+    const BaseTypes::State state{3, 10};
+
+    typename TreeBandit<BaseTypes, DefaultNodes, Options>::MatrixNode root{};
+    typename TreeBandit<BaseTypes, DefaultNodes, Options>::Search search{};
+    BaseTypes::PRNG device{0};
+    BaseTypes::Model model{0};
+    search.run_for_iterations(iterations, device, state, model, root);
+
+    typename TreeBanditFlat<BaseTypes, Options>::Search flat_search{};
+    for (int run = 0; run < 2; ++run)
+    {
+        BaseTypes::PRNG flat_device{0};
+        BaseTypes::Model flat_model{0};
+        flat_search.run_for_iterations(iterations, flat_device, state, flat_model);
+        assert(flat_search.matrix_data[0].stats == root.stats);
+        assert(flat_search.n_nodes == root.count_matrix_nodes());
+    }
+}
+
+void test_iterations()
+{
+    const size_t iterations = 1 << 20;
+    const BaseTypes::State state{2, 30};
+    FlatTypes::Search search{};
+    BaseTypes::PRNG device{0};
+    BaseTypes::Model model{0};
+    search.run_for_iterations(iterations, device, state, model);
+    assert(search.matrix_data[0].stats.visits == iterations - 1);
+    assert(search.n_nodes == iterations);
+}
+
+void test_max_depth()
+{
+    // a chain, so every iteration until the cap goes one level deeper
+    const size_t max_depth = SearchOptions<>::max_depth;
+    const BaseTypes::State state{1, 4 * max_depth};
+    FlatTypes::Search search{};
+    BaseTypes::PRNG device{0};
+    BaseTypes::Model model{0};
+    search.run_for_iterations(4 * max_depth, device, state, model);
+    assert(search.n_nodes == max_depth + 1);
+    assert(search.matrix_data[0].stats.visits == 4 * max_depth - 1);
+    assert(search.matrix_indices[max_depth] == max_depth);
+}
+
+void test_collisions()
+{
+    FlatTypes::TransitionTable table{};
+    const uint64_t hash = 12345;
+    for (int i = 0; i < 4096; ++i)
+    {
+        assert(table.get(0, i, 0, 0, hash, i + 1) == i + 1);
+    }
+    for (int i = 0; i < 4096; ++i)
+    {
+        assert(table.get(0, i, 0, 0, hash, -1) == i + 1);
+    }
+    assert(table.get(0, 0, 0, 1, hash, -1) == -1);
+    table.clear();
+    assert(table.size == 0);
+    assert(table.get(0, 0, 0, 0, hash, 7) == 7);
+}
+
+int main()
+{
+    test_equivalence<SearchOptions<>>();
+    test_equivalence<SearchOptions<void, bool>>();
+    test_iterations();
+    test_max_depth();
+    test_collisions();
+    return 0;
+}
@@ -0,0 +1,116 @@
+#include <pinyon.h>
+
+/*
+
+The small generators must satisfy IsPRNG, be reproducible from a seed, and give uniform `random_int` and `uniform`.
+`pcg64::discard` jumps the LCG directly, so it must agree with drawing n times.
+Split streams must not repeat the parent's stream.
+
+*/
+
+static_assert(IsPRNG<xoshiro, uint64_t>);
+static_assert(IsPRNG<pcg64, uint64_t>);
+static_assert(IsTypeList<RandomTreeFastTypes>);
+
+template <typename PRNG>
+void test_reproducible()
+{
+    PRNG a{7}, b{7}, c{8};
+    bool differs = false;
+    for (size_t i = 0; i < 64; ++i)
+    {
+        const uint64_t x = a.uniform_64();
+        assert(x == b.uniform_64());
+        differs |= x != c.uniform_64();
+    }
+    assert(differs);
+    PRNG copy{a};
+    assert(copy.uniform_64() == a.uniform_64());
+    assert(PRNG{a.get_seed()}.uniform_64() == PRNG{7}.uniform_64());
+}
+
+template <typename PRNG>
+void test_uniform()
+{
+    PRNG device{0};
+    const size_t samples = 1 << 18;
+    for (const int n : {1, 2, 3, 7, 100})
+    {
+        std::vector<size_t> counts(n);
+        for (size_t i = 0; i < samples; ++i)
+        {
+            const int x = device.random_int(n);
+            assert(x >= 0 && x < n);
+            ++counts[x];
+        }
+        const double p = 1.0 / n;
+        const double deviation = std::sqrt(p * (1 - p) / samples);
+        for (const size_t count : counts)
+        {
+            assert(std::abs(static_cast<double>(count) / samples - p) <= 5 * deviation);
+        }
+    }
+    double sum = 0;
+    for (size_t i = 0; i < samples; ++i)
+    {
+        const double x = device.uniform();
+        assert(x >= 0 && x < 1);
+        sum += x;
+    }
+    assert(std::abs(sum / samples - .5) <= 5 * std::sqrt(1.0 / 12 / samples));
+}
+
+template <typename PRNG>
+void test_split()
+{
+    PRNG parent{0};
+    std::vector<uint64_t> parent_stream;
+    PRNG child = parent.split();
+    for (size_t i = 0; i < 256; ++i)
+    {
+        parent_stream.push_back(parent.uniform_64());
+    }
+    for (size_t i = 0; i < 256; ++i)
+    {
+        const uint64_t x = child.uniform_64();
+        assert(std::find(parent_stream.begin(), parent_stream.end(), x) == parent_stream.end());
+    }
+}
+
+int main()
+{
+    test_reproducible<xoshiro>();
+    test_reproducible<pcg64>();
+    test_uniform<xoshiro>();
+    test_uniform<pcg64>();
+    test_uniform<prng>();
+    test_split<xoshiro>();
+    test_split<pcg64>();
+
+    for (const size_t n : {0, 1, 2, 3, 1000, 12345})
+    {
+        pcg64 a{3}, b{3};
+        a.discard(n);
+        for (size_t i = 0; i < n; ++i)
+        {
+            b.uniform_64();
+        }
+        assert(a.uniform_64() == b.uniform_64());
+    }
+
+    // a jumped generator is 2^128 draws ahead
+    xoshiro a{0}, b{0};
+    b.jump();
+    assert(a.uniform_64() != b.uniform_64());
+
+    // the generators work as the PRNG of a search
+    using Types = TreeBandit<Exp3<MonteCarloModel<RandomTree<RandomTreeFastTypes>>>>;
+    Types::PRNG device{0};
+    const Types::State state{device, 3, 3, 3, 1};
+    Types::Model model{0};
+    Types::MatrixNode root{};
+    Types::Search search{};
+    search.run_for_iterations(1 << 10, device, state, model, root);
+    assert(root.stats.visits == (1 << 10) - 1);
+    return 0;
+}
@@ -0,0 +1,112 @@
+#include <pinyon.h>
+
+/*
+
+`sample_pdf` must return the same index as the subtract-scan it replaced, for the same PRNG state.
+Quantized strategies must sum to exactly `total` and be within one unit of the input,
+and `Strategy` and `AliasTable` samples must match their distribution.
+
+*/
+
+int scan_pdf(prng &device, const std::vector<double> &input)
+{
+    double p = device.uniform();
+    for (int i = 0; i < input.size(); ++i)
+    {
+        p -= input[i];
+        if (p <= 0)
+        {
+            return i;
+        }
+    }
+    return 0;
+}
+
+std::vector<double> random_pdf(prng &device, const size_t k)
+{
+    std::vector<double> pdf(k);
+    double sum = 0;
+    for (double &p : pdf)
+    {
+        // some actions get probability 0
+        p = device.uniform() < .2 ? 0 : device.uniform();
+        sum += p;
+    }
+    if (sum == 0)
+    {
+        pdf[0] = sum = 1;
+    }
+    for (double &p : pdf)
+    {
+        p /= sum;
+    }
+    return pdf;
+}
+
+template <typename Int>
+void test_strategy(const std::vector<double> &pdf)
+{
+    const Strategy<Int> strategy{pdf};
+    uint64_t sum = 0;
+    for (size_t i = 0; i < pdf.size(); ++i)
+    {
+        sum += strategy[i];
+        assert(std::abs(strategy.prob(i) - pdf[i]) <= 1.0 / Strategy<Int>::total);
+    }
+    assert(sum == Strategy<Int>::total);
+}
+
+// frequencies over `samples` draws against `pdf`, within 5 standard deviations plus the quantization error
+template <typename Sampler>
+void test_frequencies(prng &device, const Sampler &sampler, const std::vector<double> &pdf, const double resolution)
+{
+    const size_t samples = 1 << 18;
+    std::vector<size_t> counts(pdf.size());
+    for (size_t i = 0; i < samples; ++i)
+    {
+        const int index = sampler.sample(device);
+        assert(index >= 0 && index < pdf.size());
+        ++counts[index];
+    }
+    for (size_t i = 0; i < pdf.size(); ++i)
+    {
+        const double frequency = static_cast<double>(counts[i]) / samples;
+        const double deviation = std::sqrt(pdf[i] * (1 - pdf[i]) / samples);
+        assert(std::abs(frequency - pdf[i]) <= 5 * deviation + resolution);
+        if (pdf[i] == 0)
+        {
+            assert(counts[i] == 0);
+        }
+    }
+}
+
+int main()
+{
+    prng device{0};
+    for (const size_t k : {1, 2, 3, 5, 9, 16, 64, 200})
+    {
+        for (size_t trial = 0; trial < 8; ++trial)
+        {
+            const std::vector<double> pdf = random_pdf(device, k);
+
+            prng a{device.random_seed()};
+            prng b{a};
+            for (size_t i = 0; i < 1024; ++i)
+            {
+                assert(a.sample_pdf(pdf) == scan_pdf(b, pdf));
+            }
+
+            test_strategy<uint8_t>(pdf);
+            test_strategy<uint16_t>(pdf);
+
+            if (trial == 0)
+            {
+                test_frequencies(device, Strategy<uint16_t>{pdf}, pdf, 1.0 / Strategy<uint16_t>::total);
+                test_frequencies(device, AliasTable<uint16_t>{pdf}, pdf, k * 1.0 / AliasTable<uint16_t>::total);
+                test_frequencies(device, AliasTable<uint8_t>{Strategy<uint8_t>{pdf}}, pdf,
+                                 1.0 / Strategy<uint8_t>::total + k * 1.0 / AliasTable<uint8_t>::total);
+            }
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,105 @@
+#include <pinyon.h>
+
+/*
+
+`Small<N>::Vector` must behave like `std::vector` whether its elements are inline or on the heap, and must not
+allocate while its size is within the inline capacity. A search with a small vector type list must give the same
+stats as with `std::vector`. `A<N>::Array::resize(n, value)` only fills the new elements.
+
+*/
+
+using Vector = Small<4>::Vector<int>;
+
+static_assert(IsVector<Vector, int>);
+static_assert(IsVector<A<4>::Array<int>, int>);
+static_assert(IsTypeList<SimpleSmallTypes>);
+
+void test_vector()
+{
+    Vector vector{};
+    for (int i = 0; i < 4; ++i)
+    {
+        vector.push_back(i);
+    }
+    assert(vector.is_inline() && vector.capacity() == 4);
+    vector.push_back(vector[0]);
+    assert(!vector.is_inline());
+    assert(vector == (Vector{0, 1, 2, 3, 0}));
+
+    Vector copy{vector};
+    Vector moved{std::move(vector)};
+    assert(vector.empty() && vector.is_inline());
+    assert(copy == moved && !moved.is_inline());
+
+    moved.resize(2);
+    moved.resize(4, 7);
+    assert(moved == (Vector{0, 1, 7, 7}));
+    assert(!(moved == (Vector{0, 1, 7})));
+
+    Vector inline_vector{1, 2};
+    vector = std::move(inline_vector);
+    assert(vector == (Vector{1, 2}) && vector.is_inline() && inline_vector.empty());
+    vector = copy;
+    assert(vector == copy);
+
+    Small<2>::Vector<std::shared_ptr<int>> pointers{};
+    const auto pointer = std::make_shared<int>(0);
+    for (int i = 0; i < 3; ++i)
+    {
+        pointers.push_back(pointer);
+    }
+    assert(pointer.use_count() == 4);
+    Small<2>::Vector<std::shared_ptr<int>> moved_pointers{std::move(pointers)};
+    pointers = moved_pointers;
+    assert(pointer.use_count() == 7);
+    pointers.clear();
+    moved_pointers.pop_back();
+    assert(pointer.use_count() == 3);
+}
+
+void test_array()
+{
+    A<4>::Array<int> array{};
+    array.resize(2, 1);
+    array.resize(4, 2);
+    assert(array[0] == 1 && array[1] == 1 && array[2] == 2 && array[3] == 2);
+
+    A<4>::Array<int> shorter{};
+    shorter.resize(3, 1);
+    assert(!(array == shorter) && !(shorter == array));
+    shorter.resize(4, 2);
+    assert(!(array == shorter));
+    shorter[2] = 1;
+    shorter.resize(2);
+    array.resize(2);
+    assert(array == shorter);
+}
+
+template <typename Types>
+typename Types::MatrixStats search_stats(const typename Types::State &state)
+{
+    typename Types::PRNG device{0};
+    typename Types::Model model{0};
+    typename Types::MatrixNode root{};
+    typename Types::Search search{};
+    search.run_for_iterations(1 << 12, device, state, model, root);
+    return root.stats;
+}
+
+void test_search()
+{
+    const auto stats = search_stats<TreeBandit<Exp3<MonteCarloModel<MoldState<SimpleTypes>>>>>({3, 10});
+    const auto small_stats = search_stats<TreeBandit<Exp3<MonteCarloModel<MoldState<SimpleSmallTypes>>>>>({3, 10});
+    assert(std::ranges::equal(stats.row_gains, small_stats.row_gains));
+    assert(std::ranges::equal(stats.col_gains, small_stats.col_gains));
+    assert(std::ranges::equal(stats.row_visits, small_stats.row_visits));
+    assert(std::ranges::equal(stats.col_visits, small_stats.col_visits));
+}
+
+int main()
+{
+    test_vector();
+    test_array();
+    test_search();
+    return 0;
+}